@@ -7,6 +7,8 @@
  */
 #include "bvh.h"
 #include "../core/bounds3f.h"
+#include "../core/cost_heatmap.h"
+#include "../core/profiler.h"
 #include "../primitive/primitive.h"
 /*
 // ---------------------------------------------------------------------------
@@ -28,6 +30,7 @@ Bvh::Bvh
   memory_ (1024 * 1024),
   total_nodes_ (0)
 {
+  ProfileScope scope ("bvh");
   Build (primitives_);
 #ifdef DEBUG
   Dump (2);
@@ -195,7 +198,20 @@ auto Bvh::RecursiveBuild
 auto Bvh::IsIntersect (const Ray& ray, Intersection* intersection)
   const noexcept -> bool
 {
-  return (RecursiveIsIntersect (root_, ray, intersection));
+  // Count locally, so that the counters of the thread are touched once per
+  // ray.
+  RayCount count;
+  const auto hit = RecursiveIsIntersect (root_, ray, intersection, &count);
+
+  auto& counters = ThreadRayCounters ();
+  Increase (counters.nodes,      count.nodes);
+  Increase (counters.primitives, count.primitives);
+  if (kCostHeatmap)
+  {
+    ThreadPixelCost ().nodes      += count.nodes;
+    ThreadPixelCost ().primitives += count.primitives;
+  }
+  return hit;
 }
 /*
 // ---------------------------------------------------------------------------
@@ -204,10 +220,13 @@ auto Bvh::RecursiveIsIntersect
 (
  BvhNode* node,
  const Ray& ray,
- Intersection* intersection
+ Intersection* intersection,
+ RayCount* count
 )
   const noexcept -> bool
 {
+  ++count->nodes;
+
   // Ray intersection test with node's bounds.
   if (node->bounds.IsIntersect (ray))
   {
@@ -219,8 +238,8 @@ auto Bvh::RecursiveIsIntersect
       // Current node is interior node.
       // Continue to traverse.
       Intersection tmp1, tmp2;
-      auto t1 = RecursiveIsIntersect (node->childlen[0], ray, &tmp1);
-      auto t2 = RecursiveIsIntersect (node->childlen[1], ray, &tmp2);
+      auto t1 = RecursiveIsIntersect (node->childlen[0], ray, &tmp1, count);
+      auto t2 = RecursiveIsIntersect (node->childlen[1], ray, &tmp2, count);
 
       if (!t1 && !t2)
       {
@@ -246,6 +265,7 @@ auto Bvh::RecursiveIsIntersect
     // -------------------------------------------------------------------------
     bool hit = false;
     Intersection tmp;
+    count->primitives += node->num_primitives;
     // Find the intersection point by binary search.
     for (int i = 0; i < node->num_primitives; ++i)
     {
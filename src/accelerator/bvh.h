@@ -13,6 +13,7 @@
 #include "../core/niepce.h"
 #include "../core/bounds3f.h"
 #include "../core/memory.h"
+#include "../core/ray_counters.h"
 #include "bvh_primitive_info.h"
 #include "bvh_node.h"
 /*
@@ -108,6 +109,8 @@ private:
    * @brief 
    * @param[in] 
    * @param[out] 
+   * @param[out] count
+   *    The nodes and the primitives tested by the ray.
    * @return 
    * @exception none
    * @details 
@@ -116,7 +119,8 @@ private:
   (
    BvhNode* node,
    const Ray& ray,
-   Intersection* intersection
+   Intersection* intersection,
+   RayCount* count
   )
   const noexcept -> bool;
 
@@ -21,7 +21,7 @@ MicrofacetReflection::MicrofacetReflection
  const TrowbridgeReitz* distribution,
  const Fresnel*         fresnel
 ) :
-  Bxdf (Type (Type::kSpecular | Type::kReflection)),
+  Bxdf (Type (Type::kGlossy | Type::kReflection)),
   reflectance_  (reflectance),
   distribution_ (distribution),
   fresnel_      (fresnel)
@@ -114,19 +114,13 @@ auto MicrofacetReflection::Sample
   const Float pdf = Pdf (*record);
   record->SetPdf (pdf);
 
-  /*
-  const auto weight = std::fabs (Dot (incident, half))
-                    * distribution_->GeometricAttenuation (incident, outgoing)
-                    / std::fabs (incident.Z ()) * std::fabs (half.Z ());
-  */
-  const auto weight = distribution_->GeometricAttenuation (incident, outgoing);
-
-  // Evaluate the BSDF
+  // Evaluate the BSDF. It already includes the geometric attenuation, so
+  // that it agrees with Evaluate () of the light sampling.
   const Spectrum bsdf = Evaluate (*record);
-  record->SetBsdf (bsdf * weight);
+  record->SetBsdf (bsdf);
   record->SetSampledBsdfType (type_);
 
-  return bsdf * weight;
+  return bsdf;
 }
 /*
 // ---------------------------------------------------------------------------
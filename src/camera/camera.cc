@@ -10,7 +10,14 @@
 #include "realistic_camera.h"
 #include "../core/attributes.h"
 #include "../core/bounds2f.h"
+#include "../core/denoiser.h"
 #include "../core/point2f.h"
+#include "../core/png_stream_writer.h"
+#include "../core/profiler.h"
+#include "../core/tiled_film_file.h"
+#include "../core/vector3f.h"
+#include <cstdio>
+#include <unistd.h>
 /*
 // ---------------------------------------------------------------------------
 */
@@ -51,18 +58,71 @@ auto Camera::FilmResolution () const noexcept -> Bounds2f
 /*
 // ---------------------------------------------------------------------------
 */
-auto Camera::UpdateFilmTile (const FilmTile &tile, int round) -> void
+auto Camera::PrepareFilm
+(
+ FilmAccumulation accumulation,
+ int              tile_width,
+ int              tile_height,
+ bool             keep_film_file
+)
+  -> void
 {
-  film_.ReplaceFilmTile (tile);
-  return;
-  /*
-  if (round == 1)
+  if (accumulation == FilmAccumulation::kStream)
   {
-    film_.ReplaceFilmTile (tile);
+    film_filename_  = "output." + std::to_string (getpid ()) + ".film";
+    keep_film_file_ = keep_film_file;
+    film_file_ = std::make_shared <TiledFilmFile>
+      (film_filename_.c_str (), film_.Width (), film_.Height (),
+       tile_width, tile_height);
     return;
   }
-  film_.UpdateFilmTile (tile);
-  */
+  film_.Allocate (accumulation == FilmAccumulation::kAtomic);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Camera::FlushFilmTile (const FilmTile& tile, int spp) -> void
+{
+  film_file_->WriteTile (tile, 1.0 / spp);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Camera::UpdateFilmTile (const FilmTile &tile, int spp) -> void
+{
+  film_.ReplaceFilmTile (tile, 1.0 / spp);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Camera::AddSample (int x, int y, const Spectrum& radiance)
+  noexcept -> void
+{
+  film_.AddSample (x, y, radiance);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Camera::AddSplat (const Point2f& pfilm, const Spectrum& radiance)
+  noexcept -> void
+{
+  film_.AddSplat (pfilm, radiance);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Camera::ResolveFilm (int spp, bool parallel) -> void
+{
+  const Float splat_scale = 1.0 / spp;
+  if (parallel) { film_.Resolve (splat_scale); }
+  else          { film_.ResolveRows (0, film_.Height (), splat_scale); }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Camera::DenoiseFilm (const AovBuffer& features) -> void
+{
+  Denoise (features, &film_);
 }
 /*
 // ---------------------------------------------------------------------------
@@ -77,42 +137,81 @@ auto Camera::Save () const noexcept -> void
 /*
 // ---------------------------------------------------------------------------
 */
-auto Camera::SaveSequence (int round, int spp) const noexcept -> void
+auto Camera::SaveSequence (int round) const noexcept -> void
 {
+  if (film_file_) { return; }
+
   static int num = 0;
   Film f = film_;
+  ToneMapping (&f);
 
-  for (int y = 0; y < f.Height (); ++y)
+  std::ostringstream sout;
+  sout << std::setfill ('0') << std::setw (3) << num++;
+  f.SaveAs (("sequences/" + sout.str () + ".png").c_str ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Camera::FinalProcess (int round) -> void
+{
+  if (film_file_)
   {
-    for (int x = 0; x < f.Width (); ++x)
+    // Rows are tone mapped as they are encoded.
     {
-      f.data_[y * f.Width() + x] = f.data_[y * f.Width() + x] / spp;
+      ProfileScope scope ("png");
+      SaveFilmFile ("output.png");
     }
-  }
 
-  ToneMapping (&f);
+    // The file is as large as the film, so that it is not left behind.
+    film_file_.reset ();
+    if (keep_film_file_)
+    {
+      std::cout << "The film is kept in " << film_filename_ << std::endl;
+    }
+    else
+    {
+      std::remove (film_filename_.c_str ());
+    }
+    return;
+  }
 
-  std::ostringstream sout;
-  sout << std::setfill ('0') << std::setw (3) << num++;
-  f.SaveAs (("sequences/" + sout.str () + ".png").c_str ());
+  // The film is not used after this, so that it is tone mapped in place.
+  {
+    ProfileScope scope ("tonemap");
+    ToneMapping (&film_);
+  }
+  ProfileScope scope ("png");
+  film_.SaveAs ("output.png");
 }
 /*
 // ---------------------------------------------------------------------------
 */
-auto Camera::FinalProcess (int round, int spp) -> void
+auto Camera::SaveFilmFile (const char* filename) -> void
 {
-  Film f = film_;
+  const int width = film_file_->Width ();
+  PngStreamWriter png (filename, width, film_file_->Height ());
 
-  for (int y = 0; y < f.Height (); ++y)
+  std::vector <float>   pixels;
+  std::vector <uint8_t> row (width * 3);
+  for (int tile_y = 0; tile_y < film_file_->NumTileRows (); ++tile_y)
   {
-    for (int x = 0; x < f.Width (); ++x)
+    if (!film_file_->ReadTileRow (tile_y, &pixels)) { return; }
+
+    const int height = static_cast <int> (pixels.size () / (width * 3));
+    for (int y = 0; y < height; ++y)
     {
-      f.data_[y * f.Width() + x] = f.data_[y * f.Width() + x] / spp;
+      for (int x = 0; x < width; ++x)
+      {
+        const float* p = &pixels[(y * width + x) * 3];
+        const auto value = ToneMapping (Spectrum (p[0], p[1], p[2]));
+        row[x * 3 + 0] = FloatToInt (GammaCorrection (value.X ()));
+        row[x * 3 + 1] = FloatToInt (GammaCorrection (value.Y ()));
+        row[x * 3 + 2] = FloatToInt (GammaCorrection (value.Z ()));
+      }
+      png.WriteRow (row.data ());
     }
   }
-
-  ToneMapping (&f);
-  f.SaveAs ("output.png");
+  png.Close ();
 }
 /*
 // ---------------------------------------------------------------------------
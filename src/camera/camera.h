@@ -13,6 +13,7 @@
 #include "../core/niepce.h"
 #include "../core/film.h"
 #include "../core/film_tile.h"
+#include "../core/render_settings.h"
 #include "../core/transform.h"
 #include "camera_sample.h"
 /*
@@ -92,14 +93,105 @@ public:
   auto FilmResolution () const noexcept -> Bounds2f;
 
   /*!
-   * @fn void UpdateFilmTile (FilmTile&)
-   * @brief 
+   * @fn void PrepareFilm (FilmAccumulation, int, int, bool)
+   * @brief Allocate the film for the accumulation.
+   * @param[in] accumulation
+   * @param[in] tile_width
+   * @param[in] tile_height
+   * @param[in] keep_film_file
+   *    Whether the tiled film file is left after the image is saved.
+   * @return
+   * @exception none
+   * @details FilmAccumulation::kStream allocates no pixels, but creates the
+   *          tiled film file instead. It is named by the process next to the
+   *          output, so that renders in the same directory do not share it.
+   *          It must be called before rendering.
+   */
+  auto PrepareFilm
+  (
+   FilmAccumulation accumulation,
+   int              tile_width,
+   int              tile_height,
+   bool             keep_film_file = false
+  )
+  -> void;
+
+  /*!
+   * @fn void FlushFilmTile (const FilmTile&, int)
+   * @brief Write the average of the finished tile to the tiled film file.
+   * @param[in] tile
+   *    The sum of the samples of each pixel.
+   * @param[in] spp
+   *    The number of samples accumulated in the tile.
+   * @return
+   * @exception none
+   * @details It is used by FilmAccumulation::kStream, instead of
+   *          UpdateFilmTile (). It can be called from any thread.
+   */
+  auto FlushFilmTile (const FilmTile& tile, int spp) -> void;
+
+  /*!
+   * @fn void UpdateFilmTile (const FilmTile&, int)
+   * @brief Replace the pixels of the tile by its average.
    * @param[in] tile
+   *    The sum of the samples of each pixel.
+   * @param[in] spp
+   *    The number of samples accumulated in the tile.
    * @return 
    * @exception none
-   * @details 
+   * @details Tiles may be in different rounds, so that the film keeps the
+   *          average instead of the sum.
+   */
+  auto UpdateFilmTile (const FilmTile &tile, int spp) -> void;
+
+  /*!
+   * @fn void AddSample (int, int, const Spectrum&)
+   * @brief Add the sample to the pixel of the film.
+   * @param[in] x
+   * @param[in] y
+   * @param[in] radiance
+   * @return
+   * @exception none
+   * @details It is used by FilmAccumulation::kAtomic, instead of
+   *          UpdateFilmTile (). It can be called from any thread.
+   */
+  auto AddSample (int x, int y, const Spectrum& radiance) noexcept -> void;
+
+  /*!
+   * @fn void AddSplat (const Point2f&, const Spectrum&)
+   * @brief Add the contribution to the film at the point.
+   * @param[in] pfilm
+   *    The point in raster coordinates.
+   * @param[in] radiance
+   * @return
+   * @exception none
+   * @details It can be called from any thread.
+   */
+  auto AddSplat (const Point2f& pfilm, const Spectrum& radiance)
+    noexcept -> void;
+
+  /*!
+   * @fn void ResolveFilm (int, bool)
+   * @brief Write the samples added so far to the film.
+   * @param[in] spp
+   *    The number of samples per pixel to scale splats.
+   * @param[in] parallel
+   *    Whether the rows are resolved on the thread pool.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto ResolveFilm (int spp, bool parallel) -> void;
+
+  /*!
+   * @fn void DenoiseFilm (const AovBuffer&)
+   * @brief Filter the film guided by the features.
+   * @param[in] features
+   * @return
+   * @exception none
+   * @details
    */
-  auto UpdateFilmTile (const FilmTile &tile, int round) -> void;
+  auto DenoiseFilm (const AovBuffer& features) -> void;
 
   /*!
    * @fn void Save ()
@@ -112,24 +204,28 @@ public:
 
   /*!
    * @fn void SaveSequence (int)
-   * @brief 
-   * @param[in] 
+   * @brief Save the film of the round.
+   * @param[in] round
    * @return 
    * @exception none
-   * @details
+   * @details Nothing is saved if the film is streamed to the disk.
    */
-  auto SaveSequence (int round, int spp) const noexcept -> void;
+  auto SaveSequence (int round) const noexcept -> void;
 
   /*!
    * @fn void FinalProcess (int)
-   * @brief 
-   * @param[in] 
-   * @param[out] 
+   * @brief Tone map and save the film.
+   * @param[in] round
    * @return 
    * @exception none
-   * @details
+   * @details The film streamed to the disk is tone mapped and encoded a row
+   *          of tiles at a time, and the tiled film file is removed unless
+   *          it is kept.
    */
-  auto FinalProcess (int round, int spp) -> void;
+  auto FinalProcess (int round) -> void;
+
+private:
+  auto SaveFilmFile (const char* filename) -> void;
 
 protected:
   /*!
@@ -138,6 +234,9 @@ protected:
   Transform camera_to_world_;
   ImageIO <Spectrum> background_;
   Film film_;
+  std::shared_ptr <TiledFilmFile> film_file_;
+  std::string                     film_filename_;
+  bool                            keep_film_file_ = false;
 }; // class Camera
 /*
 // ---------------------------------------------------------------------------
@@ -17,7 +17,7 @@
 #include "../core/imageio.h"
 #include "../core/thread_pool.h"
 #include "../core/singleton.h"
-#include "../core/stop_watch.h"
+#include "../core/profiler.h"
 /*
 // ---------------------------------------------------------------------------
 */
@@ -51,34 +51,21 @@ RealisticCamera::RealisticCamera
 
   // RenderExitPupilFrom (Point2f (0, 0), "aperture.ppm"); // debug
 
-  auto& stop_watch = Singleton<StopWatch>::Instance ();
-  stop_watch.Lap ();
-
   // Precomputing exit pupil bounds
-  ThreadPool& pool = Singleton <ThreadPool>::Instance ();
+  ProfileScope scope ("exit_pupil");
   constexpr static int kSamples = 64;
   exit_pupils_.resize (kSamples);
-  std::vector <std::future<Bounds2f>> futures (kSamples);
-  for (int i = 0; i < kSamples; ++i)
-  {
-    const Float diagonal = film_.Diagonal ();
-    const Float begin = static_cast <Float> (i) / kSamples * diagonal / 2.0;
-    const Float end   = static_cast <Float> (i + 1) / kSamples * diagonal / 2.0;
-    auto func = std::bind (&RealisticCamera::PrecomputeExitPupilBounds,
-                           this,
-                           std::placeholders::_1,
-                           std::placeholders::_2);
-    futures[i] = pool.Enqueue (func, begin, end);
-  }
-
-  // Copy bounds
-  for (int i = 0; i < kSamples; ++i)
+  const Float film_diagonal = film_.Diagonal ();
+  ParallelFor (kSamples, [this, film_diagonal] (int begin, int end)
   {
-    exit_pupils_[i] = futures[i].get ();
-  }
-
-  auto time = stop_watch.Lap ();
-  std::cout << "Exit pupil computation : " << time.ToString() << std::endl;
+    for (int i = begin; i < end; ++i)
+    {
+      const Float b = static_cast <Float> (i) / kSamples * film_diagonal / 2.0;
+      const Float e
+        = static_cast <Float> (i + 1) / kSamples * film_diagonal / 2.0;
+      exit_pupils_[i] = PrecomputeExitPupilBounds (b, e);
+    }
+  });
 }
 /*
 // ---------------------------------------------------------------------------
@@ -0,0 +1,212 @@
+/*!
+ * @file aov_buffer.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "aov_buffer.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+// The first channel and the number of channels of each AOV.
+struct AovChannels
+{
+  AovBuffer::Channel first;
+  int                size;
+  bool               average;  // Divided by the number of samples.
+};
+constexpr std::array <AovChannels, static_cast <int> (Aov::kNumAovs)>
+kAovChannels =
+{{
+  {AovBuffer::kAlbedoR,     3, true},
+  {AovBuffer::kNormalX,     3, true},
+  {AovBuffer::kDepth,       1, true},
+  {AovBuffer::kPrimitiveId, 1, false},
+  {AovBuffer::kMaterialId,  1, false},
+  {AovBuffer::kDirectR,     3, true},
+  {AovBuffer::kIndirectR,   3, true},
+  {AovBuffer::kSampleCount, 1, false},
+  {AovBuffer::kTime,        1, false}
+}};
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+AovBuffer::AovBuffer (int width, int height, unsigned int aovs) :
+  width_  (width),
+  height_ (height),
+  // The sample count is needed to average the others.
+  aovs_   (aovs | AovBit (Aov::kSampleCount))
+{
+  const auto size = static_cast <std::size_t> (width) * height;
+  for (int i = 0; i < static_cast <int> (Aov::kNumAovs); ++i)
+  {
+    if (!Has (static_cast <Aov> (i))) { continue; }
+    const auto& aov = kAovChannels[i];
+    // IDs of pixels which have not hit anything are -1.
+    const float initial = aov.first == kPrimitiveId
+                       || aov.first == kMaterialId ? -1.0f : 0.0f;
+    for (int c = 0; c < aov.size; ++c)
+    {
+      planes_[aov.first + c].assign (size, initial);
+    }
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto AovBuffer::AddSample (int x, int y, const AovSample& sample)
+  noexcept -> void
+{
+  const auto index = static_cast <std::size_t> (y) * width_ + x;
+  auto add = [&] (Channel channel, Float value)
+  {
+    planes_[channel][index] += value;
+  };
+
+  float& count = planes_[kSampleCount][index];
+  if (Has (Aov::kAlbedo))
+  {
+    add (kAlbedoR, sample.albedo.X ());
+    add (kAlbedoG, sample.albedo.Y ());
+    add (kAlbedoB, sample.albedo.Z ());
+  }
+  if (Has (Aov::kNormal))
+  {
+    add (kNormalX, sample.normal.X ());
+    add (kNormalY, sample.normal.Y ());
+    add (kNormalZ, sample.normal.Z ());
+  }
+  if (Has (Aov::kDepth)) { add (kDepth, sample.depth); }
+  if (count == 0 && Has (Aov::kPrimitiveId))
+  {
+    planes_[kPrimitiveId][index] = sample.primitive_id;
+  }
+  if (count == 0 && Has (Aov::kMaterialId))
+  {
+    planes_[kMaterialId][index] = sample.material_id;
+  }
+  if (Has (Aov::kDirect))
+  {
+    add (kDirectR, sample.direct.X ());
+    add (kDirectG, sample.direct.Y ());
+    add (kDirectB, sample.direct.Z ());
+  }
+  if (Has (Aov::kIndirect))
+  {
+    add (kIndirectR, sample.indirect.X ());
+    add (kIndirectG, sample.indirect.Y ());
+    add (kIndirectB, sample.indirect.Z ());
+  }
+  if (Has (Aov::kTime)) { add (kTime, sample.time); }
+  count += 1;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto AovBuffer::Resolve () noexcept -> void
+{
+  const auto& count = planes_[kSampleCount];
+  for (int i = 0; i < static_cast <int> (Aov::kNumAovs); ++i)
+  {
+    const auto& aov = kAovChannels[i];
+    if (!aov.average || !Has (static_cast <Aov> (i))) { continue; }
+    for (int c = 0; c < aov.size; ++c)
+    {
+      auto& plane = planes_[aov.first + c];
+      for (std::size_t p = 0; p < plane.size (); ++p)
+      {
+        if (count[p] > 0) { plane[p] /= count[p]; }
+      }
+    }
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto AovBuffer::Plane (Channel channel) const noexcept -> const float*
+{
+  if (planes_[channel].empty ()) { return nullptr; }
+  return planes_[channel].data ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto AovBuffer::SaveAs (const std::string& prefix, unsigned int aovs) const
+  -> void
+{
+  for (int i = 0; i < static_cast <int> (Aov::kNumAovs); ++i)
+  {
+    const auto aov = static_cast <Aov> (i);
+    if ((aovs & AovBit (aov)) == 0 || !Has (aov)) { continue; }
+
+    const auto filename = prefix + "_" + AovName (aov) + ".pfm";
+    std::ofstream file (filename, std::ios::binary);
+    if (!file)
+    {
+      std::cerr << "Failed to open " << filename << std::endl;
+      continue;
+    }
+
+    // The negative scale means little endian. Rows are from the bottom.
+    const auto& channels = kAovChannels[i];
+    file << (channels.size == 3 ? "PF" : "Pf") << "\n"
+         << width_ << " " << height_ << "\n-1.0\n";
+    std::vector <float> row (static_cast <std::size_t> (width_)
+                             * channels.size);
+    for (int y = height_ - 1; y >= 0; --y)
+    {
+      for (int x = 0; x < width_; ++x)
+      {
+        for (int c = 0; c < channels.size; ++c)
+        {
+          row[x * channels.size + c]
+            = planes_[channels.first + c][static_cast <std::size_t> (y)
+                                          * width_ + x];
+        }
+      }
+      file.write (reinterpret_cast <const char*> (row.data ()),
+                  row.size () * sizeof (float));
+    }
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto AovName (Aov aov) noexcept -> const char*
+{
+  switch (aov)
+  {
+    case Aov::kAlbedo      : return "albedo";
+    case Aov::kNormal      : return "normal";
+    case Aov::kDepth       : return "depth";
+    case Aov::kPrimitiveId : return "primitive_id";
+    case Aov::kMaterialId  : return "material_id";
+    case Aov::kDirect      : return "direct";
+    case Aov::kIndirect    : return "indirect";
+    case Aov::kSampleCount : return "sample_count";
+    case Aov::kTime        : return "time";
+    default                : return "";
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
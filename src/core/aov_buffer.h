@@ -0,0 +1,176 @@
+/*!
+ * @file aov_buffer.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _AOV_BUFFER_H_
+#define _AOV_BUFFER_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "niepce.h"
+#include "render_settings.h"
+#include "vector3f.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @struct AovSample
+ * @brief The output variables of a camera ray.
+ * @details A ray which hits nothing keeps the initial values.
+ */
+struct AovSample
+{
+  Spectrum albedo       = Spectrum (0); //!< The weight of the BSDF sample.
+  Vector3f normal       = Vector3f (0); //!< The shading normal.
+  Float    depth        = 0;            //!< The distance from the camera.
+  int      primitive_id = -1;
+  int      material_id  = -1;
+  Spectrum direct       = Spectrum (0);
+  Spectrum indirect     = Spectrum (0);
+  Float    time         = 0;            //!< In seconds.
+};
+//! ----------------------------------------------------------------------------
+//! @class AovBuffer
+//! @brief The arbitrary output variables of each pixel.
+//! @details Each channel is a separate plane, so that filters read a row of
+//!          a channel contiguously. Only the planes of the enabled AOVs are
+//!          allocated. The tile scheduler gives a pixel to one task at a
+//!          time, so that samples are added without locks.
+//! ----------------------------------------------------------------------------
+class AovBuffer
+{
+public:
+  //! The channels of the buffer.
+  enum Channel
+  {
+    kAlbedoR = 0,
+    kAlbedoG,
+    kAlbedoB,
+    kNormalX,
+    kNormalY,
+    kNormalZ,
+    kDepth,
+    kPrimitiveId,
+    kMaterialId,
+    kDirectR,
+    kDirectG,
+    kDirectB,
+    kIndirectR,
+    kIndirectG,
+    kIndirectB,
+    kSampleCount,
+    kTime,
+    kNumChannels
+  };
+
+public:
+  //! The default class constructor.
+  AovBuffer () = delete;
+
+  //! The constructor takes the resolution and the bits of the AOVs.
+  AovBuffer (int width, int height, unsigned int aovs);
+
+  //! The copy constructor of the class.
+  AovBuffer (const AovBuffer& buffer) = default;
+
+  //! The move constructor of the class.
+  AovBuffer (AovBuffer&& buffer) = default;
+
+  //! The default class destructor.
+  virtual ~AovBuffer () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const AovBuffer& buffer) -> AovBuffer& = default;
+
+  //! The move assignment operator of the class.
+  auto operator = (AovBuffer&& buffer) -> AovBuffer& = default;
+
+public:
+  auto Width  () const noexcept -> int { return width_; }
+  auto Height () const noexcept -> int { return height_; }
+
+  //! Return true if the planes of the AOV are allocated.
+  auto Has (Aov aov) const noexcept -> bool
+  {
+    return (aovs_ & AovBit (aov)) != 0;
+  }
+
+  /*!
+   * @fn void AddSample (int, int, const AovSample&)
+   * @brief Add the variables of a sample of the pixel.
+   * @param[in] x
+   * @param[in] y
+   * @param[in] sample
+   * @return
+   * @exception none
+   * @details The IDs are taken from the first sample of the pixel, and the
+   *          time is summed. Others are averaged by Resolve ().
+   */
+  auto AddSample (int x, int y, const AovSample& sample) noexcept -> void;
+
+  /*!
+   * @fn void Resolve ()
+   * @brief Divide the sums by the number of samples of each pixel.
+   * @return
+   * @exception none
+   * @details It must be called once, after every sample has been added.
+   */
+  auto Resolve () noexcept -> void;
+
+  /*!
+   * @fn const float* Plane (Channel)
+   * @brief Return the row major pixels of the channel.
+   * @param[in] channel
+   * @return nullptr if the AOV of the channel is disabled.
+   * @exception none
+   * @details
+   */
+  auto Plane (Channel channel) const noexcept -> const float*;
+
+  /*!
+   * @fn void SaveAs (const std::string&, unsigned int)
+   * @brief Write each AOV to "<prefix>_<name>.pfm".
+   * @param[in] prefix
+   * @param[in] aovs
+   *    The bits of the AOVs to write. Disabled ones are skipped.
+   * @return
+   * @exception none
+   * @details The portable float map keeps negative normals and IDs as they
+   *          are. Three channels are written as RGB, and one as grey.
+   */
+  auto SaveAs (const std::string& prefix, unsigned int aovs) const -> void;
+
+private:
+  int          width_;
+  int          height_;
+  unsigned int aovs_;
+  std::array <std::vector <float>, kNumChannels> planes_;
+}; // class AovBuffer
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn const char* AovName (Aov)
+ * @brief Return the name of the AOV used in the scene file.
+ * @param[in] aov
+ * @return
+ * @exception none
+ * @details
+ */
+auto AovName (Aov aov) noexcept -> const char*;
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _AOV_BUFFER_H_
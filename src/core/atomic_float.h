@@ -0,0 +1,115 @@
+/*!
+ * @file atomic_float.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _ATOMIC_FLOAT_H_
+#define _ATOMIC_FLOAT_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "niepce.h"
+#include <atomic>
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+//! ----------------------------------------------------------------------------
+//! @class AtomicFloat
+//! @brief Float which can be added from threads without locks.
+//! @details std::atomic <float> has no fetch_add before C++20, so that the
+//!          bits are updated by compare and swap.
+//! ----------------------------------------------------------------------------
+class AtomicFloat
+{
+public:
+  //! The default class constructor.
+  AtomicFloat () : bits_ (0) {}
+
+  //! The copy constructor of the class.
+  AtomicFloat (const AtomicFloat& value) = delete;
+
+  //! The move constructor of the class.
+  AtomicFloat (AtomicFloat&& value) = delete;
+
+  //! The default class destructor.
+  ~AtomicFloat () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const AtomicFloat& value) -> AtomicFloat& = delete;
+
+  //! The move assignment operator of the class.
+  auto operator = (AtomicFloat&& value) -> AtomicFloat& = delete;
+
+public:
+  /*!
+   * @fn void Add (float)
+   * @brief Add the value atomically.
+   * @param[in] value
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Add (float value) noexcept -> void
+  {
+    uint32_t expected = bits_.load (std::memory_order_relaxed);
+    while (!bits_.compare_exchange_weak (expected,
+                                         ToBits (FromBits (expected) + value),
+                                         std::memory_order_relaxed))
+    {}
+  }
+
+  /*!
+   * @fn float Load ()
+   * @brief
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Load () const noexcept -> float
+  {
+    return FromBits (bits_.load (std::memory_order_relaxed));
+  }
+
+  /*!
+   * @fn void Store (float)
+   * @brief
+   * @param[in] value
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Store (float value) noexcept -> void
+  {
+    bits_.store (ToBits (value), std::memory_order_relaxed);
+  }
+
+private:
+  static auto ToBits (float value) noexcept -> uint32_t
+  {
+    uint32_t bits;
+    std::memcpy (&bits, &value, sizeof (bits));
+    return bits;
+  }
+
+  static auto FromBits (uint32_t bits) noexcept -> float
+  {
+    float value;
+    std::memcpy (&value, &bits, sizeof (value));
+    return value;
+  }
+
+private:
+  std::atomic <uint32_t> bits_;
+}; // class AtomicFloat
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _ATOMIC_FLOAT_H_
@@ -0,0 +1,118 @@
+/*!
+ * @file cost_heatmap.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "cost_heatmap.h"
+#include "../ext/stb/stb_image_write.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+// Map [0, 1] to black, purple, red, yellow and white.
+auto HeatColor (float t, uint8_t* rgb) -> void
+{
+  static const float kColors[5][3] =
+  {
+    {0.0f, 0.0f, 0.0f},
+    {0.4f, 0.0f, 0.6f},
+    {0.9f, 0.1f, 0.1f},
+    {1.0f, 0.9f, 0.0f},
+    {1.0f, 1.0f, 1.0f}
+  };
+  const float s = std::min (std::max (t, 0.0f), 1.0f) * 4.0f;
+  const int   i = std::min (static_cast <int> (s), 3);
+  const float f = s - i;
+  for (int c = 0; c < 3; ++c)
+  {
+    const float v = kColors[i][c] * (1.0f - f) + kColors[i + 1][c] * f;
+    rgb[c] = static_cast <uint8_t> (v * 255.0f + 0.5f);
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+CostHeatmap::CostHeatmap (int width, int height) :
+  width_  (width),
+  height_ (height),
+  costs_  (static_cast <std::size_t> (width) * height)
+{}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto CostHeatmap::AddSample (int x, int y, const PixelCost& cost)
+  noexcept -> void
+{
+  auto& sum = costs_[static_cast <std::size_t> (y) * width_ + x];
+  sum.nodes       += cost.nodes;
+  sum.primitives  += cost.primitives;
+  sum.bounces     += cost.bounces;
+  sum.nanoseconds += cost.nanoseconds;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto CostHeatmap::SaveAs (const std::string& prefix) const -> void
+{
+  const std::array <std::pair <const char*, uint64_t PixelCost::*>, 4>
+  counters =
+  {{
+    {"nodes",       &PixelCost::nodes},
+    {"primitives",  &PixelCost::primitives},
+    {"bounces",     &PixelCost::bounces},
+    {"nanoseconds", &PixelCost::nanoseconds}
+  }};
+
+  std::vector <uint64_t> values (costs_.size ());
+  std::vector <uint8_t>  image (costs_.size () * 3);
+  for (const auto& counter : counters)
+  {
+    double sum = 0;
+    for (std::size_t i = 0; i < costs_.size (); ++i)
+    {
+      values[i] = costs_[i].*counter.second;
+      sum += values[i];
+    }
+    const auto max  = *std::max_element (values.begin (), values.end ());
+    const auto mean = sum / values.size ();
+
+    // The scale is taken from a sorted copy, so that values keep the order
+    // of the pixels.
+    auto sorted = values;
+    const auto nth = sorted.begin () + (sorted.size () - 1) * 99 / 100;
+    std::nth_element (sorted.begin (), nth, sorted.end ());
+    const float scale = *nth > 0 ? 1.0f / *nth : 0.0f;
+    for (std::size_t i = 0; i < values.size (); ++i)
+    {
+      HeatColor (values[i] * scale, &image[i * 3]);
+    }
+
+    const auto filename = prefix + "_cost_" + counter.first + ".png";
+    stbi_write_png (filename.c_str (), width_, height_, 3, image.data (),
+                    width_ * 3);
+    std::cout << "Cost " << counter.first << " : mean " << mean
+              << " max " << max << " per pixel" << std::endl;
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,128 @@
+/*!
+ * @file cost_heatmap.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _COST_HEATMAP_H_
+#define _COST_HEATMAP_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "niepce.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+//! True if the renderer is built with -DNIEPCE_COST_HEATMAP=on. Every use is
+//! a branch on this constant, so that the counters are compiled out without
+//! it.
+#ifdef NIEPCE_COST_HEATMAP
+constexpr bool kCostHeatmap = true;
+#else
+constexpr bool kCostHeatmap = false;
+#endif // NIEPCE_COST_HEATMAP
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @struct PixelCost
+ * @brief The work spent on a pixel.
+ * @details
+ */
+struct PixelCost
+{
+  uint64_t nodes       = 0; //!< The BVH nodes whose bounds were tested.
+  uint64_t primitives  = 0; //!< The primitives tested in the leaves.
+  uint64_t bounces     = 0; //!< The rays traced along the paths.
+  uint64_t nanoseconds = 0;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn PixelCost& ThreadPixelCost ()
+ * @brief Return the counters of the sample running on this thread.
+ * @return
+ * @exception none
+ * @details The renderer resets them before each sample, and the BVH and the
+ *          path tracer count into them without synchronization.
+ */
+inline auto ThreadPixelCost () noexcept -> PixelCost&
+{
+  thread_local PixelCost cost;
+  return cost;
+}
+//! ----------------------------------------------------------------------------
+//! @class CostHeatmap
+//! @brief The sum of the costs of the samples of each pixel.
+//! @details The tile scheduler gives a pixel to one task at a time, so that
+//!          samples are added without locks.
+//! ----------------------------------------------------------------------------
+class CostHeatmap
+{
+public:
+  //! The default class constructor.
+  CostHeatmap () = delete;
+
+  //! The constructor takes the resolution.
+  CostHeatmap (int width, int height);
+
+  //! The copy constructor of the class.
+  CostHeatmap (const CostHeatmap& heatmap) = default;
+
+  //! The move constructor of the class.
+  CostHeatmap (CostHeatmap&& heatmap) = default;
+
+  //! The default class destructor.
+  virtual ~CostHeatmap () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const CostHeatmap& heatmap) -> CostHeatmap& = default;
+
+  //! The move assignment operator of the class.
+  auto operator = (CostHeatmap&& heatmap) -> CostHeatmap& = default;
+
+public:
+  /*!
+   * @fn void AddSample (int, int, const PixelCost&)
+   * @brief Add the cost of a sample of the pixel.
+   * @param[in] x
+   * @param[in] y
+   * @param[in] cost
+   * @return
+   * @exception none
+   * @details
+   */
+  auto AddSample (int x, int y, const PixelCost& cost) noexcept -> void;
+
+  /*!
+   * @fn void SaveAs (const std::string&)
+   * @brief Write each counter to "<prefix>_cost_<name>.png".
+   * @param[in] prefix
+   * @return
+   * @exception none
+   * @details Black is zero and white is the 99th percentile of the counter,
+   *          so that a few outliers do not hide the rest. The mean and the
+   *          maximum of each counter are printed.
+   */
+  auto SaveAs (const std::string& prefix) const -> void;
+
+private:
+  int width_;
+  int height_;
+  std::vector <PixelCost> costs_;
+}; // class CostHeatmap
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _COST_HEATMAP_H_
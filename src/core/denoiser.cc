@@ -0,0 +1,289 @@
+/*!
+ * @file denoiser.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "denoiser.h"
+#include "aov_buffer.h"
+#include "film.h"
+#include "thread_pool.h"
+#include "vector3f.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+// The window is (2 * kRadius + 1) pixels on a side.
+constexpr int   kRadius       = 5;
+// The inverse of 2 sigma^2 of each term.
+constexpr float kSpatialScale = 1.0f / (2.0f * 3.0f * 3.0f);
+constexpr float kAlbedoScale  = 1.0f / (2.0f * 0.05f * 0.05f);
+constexpr float kNormalScale  = 1.0f / 0.05f;  // For 1 - cos.
+constexpr float kDepthScale   = 1.0f / (2.0f * 0.02f * 0.02f);  // Relative.
+constexpr float kColorScale   = 1.0f / (2.0f * 0.5f * 0.5f);
+/*
+// ---------------------------------------------------------------------------
+*/
+// exp (x) for x <= 0 by 2^n * 2^f, where n is the nearest integer and f in
+// [-0.5, 0.5] is the Taylor series. n is rounded by adding 1.5 * 2^23, so that
+// it has no branches nor conversions, and loops of it are vectorized.
+inline auto FastExp (float x) -> float
+{
+  constexpr float kRound = 12582912.0f;
+  const float t = std::max (x, -80.0f) * 1.44269504f;
+  const float shifted = t + kRound;
+  int32_t n;
+  std::memcpy (&n, &shifted, sizeof (n));
+  n -= 0x4b400000;
+
+  const float f = t - (shifted - kRound);
+  const float p = 1.0f + f * (0.69314718f + f * (0.24022651f
+                + f * (0.05550411f + f * (0.00961813f + f * 0.00133336f))));
+  const int32_t bits = (n + 127) << 23;
+  float scale;
+  std::memcpy (&scale, &bits, sizeof (scale));
+  return p * scale;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// The planes read by the filter. Each is padded by kRadius pixels which
+// repeat the edge.
+enum Plane
+{
+  kRadianceR = 0,
+  kRadianceG,
+  kRadianceB,
+  kColorR,   // Radiance compressed to [0, 1) for the color term.
+  kColorG,
+  kColorB,
+  kAlbedoR,
+  kAlbedoG,
+  kAlbedoB,
+  kNormalX,
+  kNormalY,
+  kNormalZ,
+  kDepth,
+  kDepthWeight,  // kDepthScale / depth^2 of the center pixel.
+  kNumPlanes
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+class PaddedPlanes
+{
+public:
+  PaddedPlanes (int width, int height) :
+    width_  (width + 2 * kRadius),
+    height_ (height + 2 * kRadius)
+  {
+    for (auto& p : planes_)
+    {
+      p.resize (static_cast <std::size_t> (width_) * height_);
+    }
+  }
+
+  auto Stride () const noexcept -> int { return width_; }
+
+  auto Row (Plane plane, int y) noexcept -> float*
+  {
+    return planes_[plane].data ()
+         + static_cast <std::size_t> (y + kRadius) * width_ + kRadius;
+  }
+
+  // Set the pixel of the unpadded coordinates.
+  auto Set (Plane plane, int x, int y, float value) noexcept -> void
+  {
+    Row (plane, y)[x] = value;
+  }
+
+  // Repeat the edge pixels into the padding.
+  auto FillPadding () noexcept -> void
+  {
+    const int width  = width_  - 2 * kRadius;
+    const int height = height_ - 2 * kRadius;
+    for (auto& p : planes_)
+    {
+      for (int y = 0; y < height_; ++y)
+      {
+        const int sy = Clamp (y - kRadius, 0, height - 1) + kRadius;
+        float* row = p.data () + static_cast <std::size_t> (y) * width_;
+        const float* src = p.data () + static_cast <std::size_t> (sy) * width_;
+        for (int x = 0; x < width_; ++x)
+        {
+          row[x] = src[Clamp (x - kRadius, 0, width - 1) + kRadius];
+        }
+      }
+    }
+  }
+
+private:
+  int width_;
+  int height_;
+  std::array <std::vector <float>, kNumPlanes> planes_;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+auto FilterRow
+(
+ PaddedPlanes* planes,
+ int           y,
+ int           width,
+ Film*         film
+)
+  -> void
+{
+  std::vector <float> sum_w (width, 0.0f);
+  std::vector <float> sum_r (width, 0.0f);
+  std::vector <float> sum_g (width, 0.0f);
+  std::vector <float> sum_b (width, 0.0f);
+
+  // The center pixels.
+  const float* pcr = planes->Row (kColorR,      y);
+  const float* pcg = planes->Row (kColorG,      y);
+  const float* pcb = planes->Row (kColorB,      y);
+  const float* par = planes->Row (kAlbedoR,     y);
+  const float* pag = planes->Row (kAlbedoG,     y);
+  const float* pab = planes->Row (kAlbedoB,     y);
+  const float* pnx = planes->Row (kNormalX,     y);
+  const float* pny = planes->Row (kNormalY,     y);
+  const float* pnz = planes->Row (kNormalZ,     y);
+  const float* pz  = planes->Row (kDepth,       y);
+  const float* pzw = planes->Row (kDepthWeight, y);
+
+  // For each offset, the pixels of the row are weighted at once.
+  for (int dy = -kRadius; dy <= kRadius; ++dy)
+  {
+    for (int dx = -kRadius; dx <= kRadius; ++dx)
+    {
+      const float spatial = (dx * dx + dy * dy) * kSpatialScale;
+      const float* qr  = planes->Row (kRadianceR, y + dy) + dx;
+      const float* qg  = planes->Row (kRadianceG, y + dy) + dx;
+      const float* qb  = planes->Row (kRadianceB, y + dy) + dx;
+      const float* qcr = planes->Row (kColorR,    y + dy) + dx;
+      const float* qcg = planes->Row (kColorG,    y + dy) + dx;
+      const float* qcb = planes->Row (kColorB,    y + dy) + dx;
+      const float* qar = planes->Row (kAlbedoR,   y + dy) + dx;
+      const float* qag = planes->Row (kAlbedoG,   y + dy) + dx;
+      const float* qab = planes->Row (kAlbedoB,   y + dy) + dx;
+      const float* qnx = planes->Row (kNormalX,   y + dy) + dx;
+      const float* qny = planes->Row (kNormalY,   y + dy) + dx;
+      const float* qnz = planes->Row (kNormalZ,   y + dy) + dx;
+      const float* qz  = planes->Row (kDepth,     y + dy) + dx;
+
+      // The sums are never read through the planes, but there are too many
+      // pointers for the compiler to check it at run time.
+#pragma GCC ivdep
+      for (int x = 0; x < width; ++x)
+      {
+        const float dcr = pcr[x] - qcr[x];
+        const float dcg = pcg[x] - qcg[x];
+        const float dcb = pcb[x] - qcb[x];
+        const float dar = par[x] - qar[x];
+        const float dag = pag[x] - qag[x];
+        const float dab = pab[x] - qab[x];
+        const float cos = pnx[x] * qnx[x] + pny[x] * qny[x] + pnz[x] * qnz[x];
+        const float dz  = pz[x] - qz[x];
+        const float e = spatial
+                      + (dcr * dcr + dcg * dcg + dcb * dcb) * kColorScale
+                      + (dar * dar + dag * dag + dab * dab) * kAlbedoScale
+                      + std::max (1.0f - cos, 0.0f) * kNormalScale
+                      + dz * dz * pzw[x];
+        const float w = FastExp (-e);
+        sum_w[x] += w;
+        sum_r[x] += w * qr[x];
+        sum_g[x] += w * qg[x];
+        sum_b[x] += w * qb[x];
+      }
+    }
+  }
+
+  // The center pixel has the weight 1, so that the sum is never zero.
+  for (int x = 0; x < width; ++x)
+  {
+    const float inv = 1.0f / sum_w[x];
+    film->data_[y * width + x]
+      = Spectrum (sum_r[x] * inv, sum_g[x] * inv, sum_b[x] * inv);
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Denoise (const AovBuffer& features, Film* film) -> void
+{
+  const int width  = film->Width ();
+  const int height = film->Height ();
+  if (features.Width () != width || features.Height () != height
+      || !features.Has (Aov::kAlbedo) || !features.Has (Aov::kNormal)
+      || !features.Has (Aov::kDepth))
+  {
+    std::cerr << "The features do not match the film." << std::endl;
+    return;
+  }
+
+  // Gather the planes.
+  PaddedPlanes planes (width, height);
+  const std::array <std::pair <Plane, AovBuffer::Channel>, 7> guides =
+  {{
+    {kAlbedoR, AovBuffer::kAlbedoR},
+    {kAlbedoG, AovBuffer::kAlbedoG},
+    {kAlbedoB, AovBuffer::kAlbedoB},
+    {kNormalX, AovBuffer::kNormalX},
+    {kNormalY, AovBuffer::kNormalY},
+    {kNormalZ, AovBuffer::kNormalZ},
+    {kDepth,   AovBuffer::kDepth}
+  }};
+  ParallelFor (height, [&] (int begin, int end)
+  {
+    for (int y = begin; y < end; ++y)
+    {
+      for (int x = 0; x < width; ++x)
+      {
+        const auto index = y * width + x;
+        const auto& radiance = film->data_[index];
+        for (int c = 0; c < 3; ++c)
+        {
+          const float value = radiance[c];
+          planes.Set (static_cast <Plane> (kRadianceR + c), x, y, value);
+          planes.Set (static_cast <Plane> (kColorR + c), x, y,
+                      value / (1.0f + value));
+        }
+        for (const auto& guide : guides)
+        {
+          planes.Set (guide.first, x, y, features.Plane (guide.second)[index]);
+        }
+        const float depth = features.Plane (AovBuffer::kDepth)[index];
+        planes.Set (kDepthWeight, x, y,
+                    kDepthScale / std::max (depth * depth, 1e-6f));
+      }
+    }
+  });
+  planes.FillPadding ();
+
+  ParallelFor (height, [&] (int begin, int end)
+  {
+    for (int y = begin; y < end; ++y) { FilterRow (&planes, y, width, film); }
+  });
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,46 @@
+/*!
+ * @file denoiser.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _DENOISER_H_
+#define _DENOISER_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "niepce.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn void Denoise (const AovBuffer&, Film*)
+ * @brief Filter the film by the cross bilateral filter.
+ * @param[in] features
+ *    The AOVs of the same resolution as the film, with the albedo, the
+ *    normal and the depth.
+ * @param[in,out] film
+ *    The average radiance of each pixel, before tone mapping.
+ * @return
+ * @exception none
+ * @details Neighbours are weighted by the distance and by the differences
+ *          of albedo, normal, depth and color, all in one exponent. The
+ *          planes are padded by the radius, so that the loop over the
+ *          pixels of a row has no branches and is vectorized. Rows are
+ *          filtered in parallel.
+ */
+auto Denoise (const AovBuffer& features, Film* film) -> void;
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _DENOISER_H_
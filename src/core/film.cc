@@ -8,6 +8,8 @@
 #include "film.h"
 #include "film_tile.h"
 #include "vector3f.h"
+#include "point2f.h"
+#include "thread_pool.h"
 // #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "../ext/stb/stb_image_write.h"
 /*
@@ -26,8 +28,7 @@ Film::Film
  Float        diagonal
 ) :
   bounds_   (width, height),
-  diagonal_ (diagonal),
-  data_     (new Spectrum [width * height])
+  diagonal_ (diagonal)
 {}
 /*
 // ---------------------------------------------------------------------------
@@ -36,6 +37,8 @@ Film::Film (const Film &film) :
   diagonal_ (film.diagonal_),
   bounds_   (film.bounds_)
 {
+  if (!film.data_) { return; }
+
   const auto width  = static_cast <int> (film.Width ());
   const auto height = static_cast <int> (film.Height ());
   this->data_.reset (new Spectrum [width * height]);
@@ -56,6 +59,8 @@ Film::Film (Film &&film) :
   diagonal_ (film.Diagonal ()),
   bounds_   (film.bounds_)
 {
+  if (!film.data_) { return; }
+
   const auto width  = static_cast <int> (film.Width ());
   const auto height = static_cast <int> (film.Height ());
   this->data_.reset (new Spectrum [width * height]);
@@ -72,13 +77,17 @@ Film::Film (Film &&film) :
 /*
 // ---------------------------------------------------------------------------
 */
+auto Film::Allocate (bool accumulation) -> void
+{
+  const auto size = static_cast <std::size_t> (Width ()) * Height ();
+  data_.reset (new Spectrum [size]);
+  if (accumulation) { accumulation_.reset (new AccumulatedPixel [size]); }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 auto Film::SaveAs (const char *filename) const noexcept -> void
 {
-  const auto gammna = [] (Float val) -> Float
-  {
-    return std::pow (val, 1.0 / 2.2);
-  };
-
   const auto width  = Width ();
   const auto height = Height ();
   auto img = new unsigned char [width * height * 4];
@@ -87,9 +96,9 @@ auto Film::SaveAs (const char *filename) const noexcept -> void
     for (int x = 0; x < width; ++x)
     {
       const auto index = y * width + x;
-      img[4 * index + 0] = FloatToInt (gammna (data_[index].X ()));
-      img[4 * index + 1] = FloatToInt (gammna (data_[index].Y ()));
-      img[4 * index + 2] = FloatToInt (gammna (data_[index].Z ()));
+      img[4 * index + 0] = FloatToInt (GammaCorrection (data_[index].X ()));
+      img[4 * index + 1] = FloatToInt (GammaCorrection (data_[index].Y ()));
+      img[4 * index + 2] = FloatToInt (GammaCorrection (data_[index].Z ()));
       img[4 * index + 3] = 255;
     }
   }
@@ -124,7 +133,8 @@ auto Film::Resolution () const noexcept -> Bounds2f
 /*
 // ---------------------------------------------------------------------------
 */
-auto Film::ReplaceFilmTile (const FilmTile& tile) noexcept -> void
+auto Film::ReplaceFilmTile (const FilmTile& tile, Float scale) noexcept
+  -> void
 {
   const auto width = static_cast <int> (bounds_.Width ());
   for (int y = tile.Min().Y (); y < static_cast <int> (tile.Max ().Y ()); ++y)
@@ -132,7 +142,7 @@ auto Film::ReplaceFilmTile (const FilmTile& tile) noexcept -> void
     for (int x = tile.Min().X (); x < static_cast <int> (tile.Max ().X ()); ++x)
     {
       const auto data = tile.At (x - tile.Min ().X (), y - tile.Min ().Y ());
-      data_.get () [y * width + x] = data;
+      data_.get () [y * width + x] = data * scale;
     }
   }
 }
@@ -145,102 +155,69 @@ auto Film::UpdateFilmTile (const FilmTile &tile) noexcept -> void
 }
 /*
 // ---------------------------------------------------------------------------
-auto Denoising (Film *film) -> void
+*/
+auto Film::AddSample (int x, int y, const Spectrum& radiance, Float weight)
+  noexcept -> void
 {
-  const auto src = Film (*film);
-  const auto kernel_size = 3;
-  const auto search_size = 5;
-  const auto half_kernel_size = kernel_size / 2;
-  const auto half_search_size = search_size / 2;
-  const auto &width  = src.Width ();
-  const auto &height = src.Height ();
-
-  const auto h     = 0.01;
-  const auto sigma = 0.01;
-
-  // Get a kernel window.
-  auto GetKernel = [&]
-  (
-   int x,
-   int y,
-   Image <Spectrum>* kernel
-  ) -> void
-  {
-    // For each kernel pixel.
-    for (int sy = 0; sy < kernel_size; ++sy)
-    {
-      for (int sx = 0; sx < kernel_size; ++sx)
-      {
-        int tx = std::max (0, x - half_kernel_size + sx);
-        tx = std::min ((int)width - 1, x + half_kernel_size + sx);
-        int ty = std::max (0, y - half_kernel_size + sy);
-        ty = std::min ((int)height - 1, y + half_kernel_size + sy);
-        kernel->SetValueAt (sx, sy, src.At (tx, ty));
-      }
-    }
-  };
-
-  auto L2Norm = [&]
-  (
-   const Image <Spectrum> &lhs,
-   const Image <Spectrum> &rhs
-  ) -> Float
-  {
-    Float sum = 0;
-    for (int y = 0; y < kernel_size; ++y)
-    {
-      for (int x = 0; x < kernel_size; ++x)
-      {
-        const auto tmp = lhs.At (x, y) - rhs.At (x, y);
-        sum += tmp.X () * tmp.X ();
-        sum += tmp.Y () * tmp.Y ();
-        sum += tmp.Z () * tmp.Z ();
-      }
-    }
-    return sum;
-  };
+  auto& pixel = accumulation_[y * Width () + x];
+  pixel.rgb[0].Add (radiance.X () * weight);
+  pixel.rgb[1].Add (radiance.Y () * weight);
+  pixel.rgb[2].Add (radiance.Z () * weight);
+  pixel.weight.Add (weight);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Film::AddSplat (const Point2f& pfilm, const Spectrum& radiance)
+  noexcept -> void
+{
+  const int x = static_cast <int> (std::floor (pfilm.X ()));
+  const int y = static_cast <int> (std::floor (pfilm.Y ()));
+  if (x < 0 || y < 0 || x >= Width () || y >= Height ()) { return; }
 
-  // For each pixel.
-  for (int y = 0; y < src.Height (); ++y)
+  auto& pixel = accumulation_[y * Width () + x];
+  pixel.splat[0].Add (radiance.X ());
+  pixel.splat[1].Add (radiance.Y ());
+  pixel.splat[2].Add (radiance.Z ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Film::ResolveRows (int begin_y, int end_y, Float splat_scale)
+  noexcept -> void
+{
+  const auto width = Width ();
+  for (int y = begin_y; y < end_y; ++y)
   {
-    for (int x = 0; x < src.Width (); ++x)
+    for (int x = 0; x < width; ++x)
     {
-      // Get kernel image.
-      const auto target = Point2f (x, y);
-      Image <Spectrum> target_kernel (kernel_size, kernel_size);
-      GetKernel (x, y, &target_kernel);
-
-      Float    sum_weight = 0;
-      Spectrum sum_pixel  = Spectrum::Zero ();
-
-      // For each search window.
-      for (int sy = y - half_search_size; sy <= y + half_search_size; ++sy)
+      const auto index  = y * width + x;
+      const auto& pixel = accumulation_[index];
+      Spectrum value (pixel.splat[0].Load () * splat_scale,
+                      pixel.splat[1].Load () * splat_scale,
+                      pixel.splat[2].Load () * splat_scale);
+      const auto weight = pixel.weight.Load ();
+      if (weight != 0)
       {
-        for (int sx = x - half_search_size; sx <= x + half_search_size; ++sx)
-        {
-          auto tx = std::max (0, sx);
-          tx = std::min (sx, (int)width - 1);
-
-          auto ty = std::max (0, sy);
-          ty = std::min (sy, (int)height - 1);
-
-          // Get kernel.
-          Image <Spectrum> search_kernel (kernel_size, kernel_size);
-          GetKernel (tx, ty, &search_kernel);
-
-          const auto norm   = L2Norm (target_kernel, search_kernel);
-          const auto tmp    = std::fmax (norm * norm - 2.0 * sigma * sigma, 0.0);
-          const auto weight = std::exp (-tmp / h * h);
-
-          sum_weight += weight;
-          sum_pixel  =  sum_pixel + src.At (tx, ty) * weight;
-        }
+        const auto inv = 1 / weight;
+        value = value + Spectrum (pixel.rgb[0].Load () * inv,
+                                  pixel.rgb[1].Load () * inv,
+                                  pixel.rgb[2].Load () * inv);
       }
-      film->SetValueAt (x, y, sum_pixel / sum_weight);
+      data_[index] = value;
     }
   }
 }
+/*
+// ---------------------------------------------------------------------------
 */
+auto Film::Resolve (Float splat_scale) -> void
+{
+  ParallelFor (Height (), [this, splat_scale] (int begin, int end)
+  {
+    ResolveRows (begin, end, splat_scale);
+  });
+}
 /*
 // ---------------------------------------------------------------------------
 */
@@ -267,27 +244,41 @@ auto ToneMapping (Film *film) -> void
   {
     for (int x = 0; x < width; ++x)
     {
-      const auto tone_mapping = [] (Float val) -> Float
-      {
-        const auto a = 2.51;
-        const auto b = 0.03;
-        const auto c = 2.43;
-        const auto d = 0.59;
-        const auto e = 0.14;
-        val = (val  * (a * val + b)) / (val * (c * val + d) + e);
-        return Clamp (val, 0.0f, 1.0f);
-      };
       const auto index = y * width + x;
-      const auto r = tone_mapping (film->data_[index].X ());
-      const auto g = tone_mapping (film->data_[index].Y ());
-      const auto b = tone_mapping (film->data_[index].Z ());
-      film->data_[index] = Spectrum (r, g, b);
+      film->data_[index] = ToneMapping (film->data_[index]);
     }
   }
 }
 /*
 // ---------------------------------------------------------------------------
 */
+auto ToneMapping (const Spectrum& value) -> Spectrum
+{
+  // ACES Filmic Tonemapping Curve
+  const auto tone_mapping = [] (Float val) -> Float
+  {
+    const auto a = 2.51;
+    const auto b = 0.03;
+    const auto c = 2.43;
+    const auto d = 0.59;
+    const auto e = 0.14;
+    val = (val  * (a * val + b)) / (val * (c * val + d) + e);
+    return Clamp (val, 0.0f, 1.0f);
+  };
+  return Spectrum (tone_mapping (value.X ()),
+                   tone_mapping (value.Y ()),
+                   tone_mapping (value.Z ()));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto GammaCorrection (Float value) -> Float
+{
+  return std::pow (value, 1.0 / 2.2);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 } // namespace niepce
 /*
 // ---------------------------------------------------------------------------
@@ -13,6 +13,7 @@
 #include "niepce.h"
 #include "bounds2f.h"
 #include "imageio.h"
+#include "atomic_float.h"
 /*
 // ---------------------------------------------------------------------------
 */
@@ -21,8 +22,40 @@ namespace niepce
 /*
 // ---------------------------------------------------------------------------
 */
-auto Denoising   (Film *film) -> void;
 auto ToneMapping (Film *film) -> void;
+/*!
+ * @fn Spectrum ToneMapping (const Spectrum&)
+ * @brief Return the value mapped by the ACES filmic curve to [0, 1].
+ * @param[in] value
+ * @return
+ * @exception none
+ * @details It depends on nothing but the pixel, so that the film can be
+ *          tone mapped a part at a time.
+ */
+auto ToneMapping (const Spectrum& value) -> Spectrum;
+/*!
+ * @fn Float GammaCorrection (Float)
+ * @brief Encode the linear value by the gamma of 2.2.
+ * @param[in] value
+ * @return
+ * @exception none
+ * @details
+ */
+auto GammaCorrection (Float value) -> Float;
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @struct AccumulatedPixel
+ * @brief Weighted sum of the samples of a pixel, and the sum of splats.
+ * @details
+ */
+struct AccumulatedPixel
+{
+  std::array <AtomicFloat, 3> rgb;
+  AtomicFloat                 weight;
+  std::array <AtomicFloat, 3> splat;
+};
 //! ----------------------------------------------------------------------------
 //! @class Film
 //! @brief
@@ -64,6 +97,18 @@ public:
 
   auto SaveAs (const char *filename) const noexcept -> void;
 
+  /*!
+   * @fn void Allocate (bool)
+   * @brief Allocate the pixels.
+   * @param[in] accumulation
+   *    True to allocate the sums of AddSample () and AddSplat () too.
+   * @return
+   * @exception none
+   * @details The film has no pixels until it is called, so that the film
+   *          streamed to the disk never has the whole image in memory.
+   */
+  auto Allocate (bool accumulation) -> void;
+
   /*!
    * @fn Float Diagonal ()
    * @brief Return the physical length of diagonal.
@@ -92,14 +137,17 @@ public:
   auto Resolution () const noexcept -> Bounds2f;
 
   /*!
-   * @fn void SetFilmTile (const)
-   * @brief 
+   * @fn void ReplaceFilmTile (const FilmTile&, Float)
+   * @brief Replace the pixels of the tile.
    * @param[in] tile
+   * @param[in] scale
+   *    The scale of the values of the tile.
    * @return 
    * @exception none
    * @details
    */
-  auto ReplaceFilmTile (const FilmTile& tile) noexcept -> void;
+  auto ReplaceFilmTile (const FilmTile& tile, Float scale = 1) noexcept
+    -> void;
 
   /*!
    * @fn void UpdateFilmTile (const)
@@ -111,6 +159,61 @@ public:
    */
   auto UpdateFilmTile (const FilmTile &tile) noexcept -> void;
 
+  /*!
+   * @fn void AddSample (int, int, const Spectrum&, Float)
+   * @brief Add the weighted sample to the pixel.
+   * @param[in] x
+   * @param[in] y
+   * @param[in] radiance
+   * @param[in] weight
+   *    The weight of the reconstruction filter.
+   * @return
+   * @exception none
+   * @details It is lock free, and can be called from any thread.
+   */
+  auto AddSample (int x, int y, const Spectrum& radiance, Float weight = 1)
+    noexcept -> void;
+
+  /*!
+   * @fn void AddSplat (const Point2f&, const Spectrum&)
+   * @brief Add the contribution to the pixel which contains the point.
+   * @param[in] pfilm
+   *    The point in raster coordinates.
+   * @param[in] radiance
+   * @return
+   * @exception none
+   * @details Splats are not normalized by the weight, but by the scale of
+   *          Resolve (). Points outside the film are ignored. It is lock free,
+   *          and can be called from any thread.
+   */
+  auto AddSplat (const Point2f& pfilm, const Spectrum& radiance)
+    noexcept -> void;
+
+  /*!
+   * @fn void ResolveRows (int, int, Float)
+   * @brief Write the average of the samples to the rows of the film.
+   * @param[in] begin_y
+   * @param[in] end_y
+   * @param[in] splat_scale
+   *    The scale of splats, usually the reciprocal of the number of samples
+   *    per pixel.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto ResolveRows (int begin_y, int end_y, Float splat_scale)
+    noexcept -> void;
+
+  /*!
+   * @fn void Resolve (Float)
+   * @brief Write the average of the samples to the film in parallel.
+   * @param[in] splat_scale
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Resolve (Float splat_scale) -> void;
+
 private:
   //! @brief
   const Bounds2f bounds_;
@@ -120,6 +223,11 @@ private:
 
 public:
   std::unique_ptr <Spectrum []> data_;
+
+private:
+  // Sums updated by AddSample () and AddSplat (). Copies of the film do not
+  // have them.
+  std::unique_ptr <AccumulatedPixel []> accumulation_;
 }; // class Film
 /*
 // ---------------------------------------------------------------------------
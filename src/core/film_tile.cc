@@ -64,4 +64,26 @@ auto FilmTile::ClearTileImage () noexcept -> void
 /*
 // ---------------------------------------------------------------------------
 */
+auto FilmTile::AllocateTileImage () -> void
+{
+  data_.reset (new Spectrum [width_ * height_],
+               std::default_delete <Spectrum []> ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto FilmTile::ReleaseTileImage () noexcept -> void
+{
+  data_.reset ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto FilmTile::HasTileImage () const noexcept -> bool
+{
+  return data_ != nullptr;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 }  // namespace niepce
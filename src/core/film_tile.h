@@ -94,6 +94,34 @@ public:
    */
   auto ClearTileImage () noexcept -> void;
 
+  /*!
+   * @fn void AllocateTileImage ()
+   * @brief Allocate the pixels, cleared to zero.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto AllocateTileImage () -> void;
+
+  /*!
+   * @fn void ReleaseTileImage ()
+   * @brief Free the pixels.
+   * @return
+   * @exception none
+   * @details Tiles flushed to the disk release their pixels, so that only
+   *          tiles in flight take memory.
+   */
+  auto ReleaseTileImage () noexcept -> void;
+
+  /*!
+   * @fn bool HasTileImage ()
+   * @brief
+   * @return
+   * @exception none
+   * @details
+   */
+  auto HasTileImage () const noexcept -> bool;
+
 private:
   const int      tile_number_;
   const Bounds2f tile_bounds_;
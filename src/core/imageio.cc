@@ -9,6 +9,7 @@
 #include "bounds2f.h"
 #include "point2f.h"
 #include "vector3f.h"
+#include "profiler.h"
 /*
 // ---------------------------------------------------------------------------
 // External library
@@ -110,6 +111,8 @@ auto ImageIO<T>::Load (const char *filename) -> void
 template <>
 auto ImageIO <Spectrum>::Load (const char *filename) -> void
 {
+  ProfileScope scope ("texture");
+
   // File check.
   if (!IsFileExist (filename))
   {
@@ -153,6 +156,8 @@ auto ImageIO <Spectrum>::Load (const char *filename) -> void
 template <>
 auto ImageIO <bool>::Load (const char* filename) -> void
 {
+  ProfileScope scope ("texture");
+
   if (!IsFileExist (filename))
   {
     std::cout << "ImageIO: ";
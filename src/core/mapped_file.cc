@@ -0,0 +1,76 @@
+/*!
+ * @file mapped_file.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "mapped_file.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+#ifdef _WIN32
+MappedFile::MappedFile (const char* filename)
+{
+  std::ifstream ifs (filename, std::ios::binary | std::ios::ate);
+  if (!ifs) { return; }
+  buffer_.resize (static_cast <std::size_t> (ifs.tellg ()));
+  ifs.seekg (0);
+  if (buffer_.empty () || !ifs.read (buffer_.data (), buffer_.size ()))
+  {
+    return;
+  }
+  data_ = buffer_.data ();
+  size_ = buffer_.size ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+MappedFile::~MappedFile ()
+{}
+#else
+MappedFile::MappedFile (const char* filename)
+{
+  const int fd = open (filename, O_RDONLY);
+  if (fd < 0) { return; }
+
+  struct stat st;
+  if (fstat (fd, &st) == 0 && st.st_size > 0)
+  {
+    void* data = mmap (nullptr, static_cast <std::size_t> (st.st_size),
+                       PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED)
+    {
+      data_ = static_cast <const char*> (data);
+      size_ = static_cast <std::size_t> (st.st_size);
+    }
+  }
+  // The mapping stays after the descriptor is closed.
+  close (fd);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+MappedFile::~MappedFile ()
+{
+  if (data_ != nullptr) { munmap (const_cast <char*> (data_), size_); }
+}
+#endif // _WIN32
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
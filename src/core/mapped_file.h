@@ -0,0 +1,75 @@
+/*!
+ * @file mapped_file.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "niepce.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+//! ----------------------------------------------------------------------------
+//! @class MappedFile
+//! @brief A read only view of a whole file.
+//! @details The file is mapped into memory, so that pages are read as they
+//!          are touched and are shared with the page cache. The data begins
+//!          at a page boundary. Where the mapping is not supported, the file
+//!          is read into memory instead.
+//! ----------------------------------------------------------------------------
+class MappedFile
+{
+public:
+  //! The default class constructor.
+  MappedFile () = delete;
+
+  //! The constructor maps the file. Check IsOpen for the error.
+  explicit MappedFile (const char* filename);
+
+  //! The copy constructor of the class.
+  MappedFile (const MappedFile& file) = delete;
+
+  //! The move constructor of the class.
+  MappedFile (MappedFile&& file) = delete;
+
+  //! The class destructor unmaps the file.
+  virtual ~MappedFile ();
+
+  //! The copy assignment operator of the class.
+  auto operator = (const MappedFile& file) -> MappedFile& = delete;
+
+  //! The move assignment operator of the class.
+  auto operator = (MappedFile&& file) -> MappedFile& = delete;
+
+public:
+  //! Return true if the file is mapped. An empty file is not.
+  auto IsOpen () const noexcept -> bool { return data_ != nullptr; }
+
+  //! Return the first byte of the file.
+  auto Data () const noexcept -> const char* { return data_; }
+
+  //! Return the size of the file in bytes.
+  auto Size () const noexcept -> std::size_t { return size_; }
+
+private:
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+#ifdef _WIN32
+  std::vector <char> buffer_;
+#endif // _WIN32
+}; // class MappedFile
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _MAPPED_FILE_H_
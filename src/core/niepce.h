@@ -42,9 +42,11 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <future>
 #include <fstream>
@@ -54,6 +56,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <stdexcept>
 #include <sstream>
@@ -105,6 +108,7 @@ namespace niepce
 */
 class AreaLight;
 class Attributes;
+class AovBuffer;
 class AssembledTiles;
 class BeckmannDistribution;
 class Bounds2f;
@@ -115,6 +119,7 @@ class BsdfRecord;
 enum class BsdfType;
 class Camera;
 struct CameraSample;
+class CostHeatmap;
 class Film;
 class FilmTile;
 template <typename T> class Image;
@@ -131,6 +136,7 @@ class Sphere;
 template <typename T> class Texture;
 class ThreadPool;
 class Tile;
+class TiledFilmFile;
 class Transform;
 class PathTracer;
 class PinholeCamera;
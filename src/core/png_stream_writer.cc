@@ -0,0 +1,232 @@
+/*!
+ * @file png_stream_writer.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "png_stream_writer.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+// The maximum length of a stored deflate block.
+constexpr std::size_t kMaxBlockSize = 65535;
+// Blocks are gathered into an IDAT chunk of about this size.
+constexpr std::size_t kChunkSize    = 16 * kMaxBlockSize;
+constexpr uint32_t    kAdlerModulo  = 65521;
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Crc32 (uint32_t crc, const uint8_t* data, std::size_t size) -> uint32_t
+{
+  static const auto table = [] ()
+  {
+    std::array <uint32_t, 256> t;
+    for (uint32_t n = 0; n < 256; ++n)
+    {
+      uint32_t c = n;
+      for (int k = 0; k < 8; ++k)
+      {
+        c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      }
+      t[n] = c;
+    }
+    return t;
+  } ();
+
+  crc = ~crc;
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PutBigEndian (uint32_t value, uint8_t* out) -> void
+{
+  out[0] = static_cast <uint8_t> (value >> 24);
+  out[1] = static_cast <uint8_t> (value >> 16);
+  out[2] = static_cast <uint8_t> (value >> 8);
+  out[3] = static_cast <uint8_t> (value);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+PngStreamWriter::PngStreamWriter (const char* filename, int width, int height) :
+  width_  (width),
+  height_ (height),
+  file_   (filename, std::ios::binary)
+{
+  if (!file_)
+  {
+    std::cerr << "Failed to create " << filename << std::endl;
+    return;
+  }
+
+  const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  file_.write (reinterpret_cast <const char*> (signature), sizeof (signature));
+
+  // 8 bits RGB, no interlace.
+  uint8_t header[13] = {};
+  PutBigEndian (width,  header);
+  PutBigEndian (height, header + 4);
+  header[8] = 8;
+  header[9] = 2;
+  WriteChunk ("IHDR", header, sizeof (header));
+
+  pending_.reserve (kChunkSize + width * 3 + 1);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+PngStreamWriter::~PngStreamWriter ()
+{
+  if (!closed_) { Close (); }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PngStreamWriter::WriteRow (const uint8_t* rgb) -> void
+{
+  const uint8_t filter = 0;
+  Append (&filter, 1);
+  Append (rgb, width_ * 3);
+  ++num_rows_;
+  if (pending_.size () >= kChunkSize) { FlushBlocks (false); }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PngStreamWriter::Close () -> bool
+{
+  if (closed_) { return false; }
+  closed_ = true;
+  if (!file_.is_open ()) { return false; }
+
+  FlushBlocks (true);
+  WriteChunk ("IEND", nullptr, 0);
+  file_.close ();
+  if (num_rows_ != height_)
+  {
+    std::cerr << "PNG has " << num_rows_ << " of " << height_ << " rows."
+              << std::endl;
+    return false;
+  }
+  return !file_.fail ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PngStreamWriter::Append (const uint8_t* data, std::size_t size) -> void
+{
+  // Adler-32 of the uncompressed data. The sums are reduced every 5552 bytes
+  // at most so that they do not overflow.
+  while (size > 0)
+  {
+    const std::size_t n = std::min <std::size_t> (size, 5552);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      adler_a_ += data[i];
+      adler_b_ += adler_a_;
+    }
+    adler_a_ %= kAdlerModulo;
+    adler_b_ %= kAdlerModulo;
+    pending_.insert (pending_.end (), data, data + n);
+    data += n;
+    size -= n;
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PngStreamWriter::FlushBlocks (bool final) -> void
+{
+  std::vector <uint8_t> data;
+  data.reserve (pending_.size () + pending_.size () / kMaxBlockSize * 5 + 16);
+
+  // The zlib header without a preset dictionary.
+  if (!zlib_started_)
+  {
+    data.push_back (0x78);
+    data.push_back (0x01);
+    zlib_started_ = true;
+  }
+
+  // Stored blocks. Unless it is the final, the rest shorter than a block
+  // waits for the next rows.
+  std::size_t offset = 0;
+  while (true)
+  {
+    const std::size_t rest = pending_.size () - offset;
+    if (!final && rest < kMaxBlockSize) { break; }
+
+    const auto length  = static_cast <uint16_t> (std::min (rest, kMaxBlockSize));
+    const auto nlength = static_cast <uint16_t> (~length);
+    const bool is_last = final && rest <= kMaxBlockSize;
+    data.push_back (is_last ? 1 : 0);
+    data.push_back (static_cast <uint8_t> (length));
+    data.push_back (static_cast <uint8_t> (length >> 8));
+    data.push_back (static_cast <uint8_t> (nlength));
+    data.push_back (static_cast <uint8_t> (nlength >> 8));
+    data.insert (data.end (),
+                 pending_.begin () + offset,
+                 pending_.begin () + offset + length);
+    offset += length;
+    if (is_last) { break; }
+  }
+  pending_.erase (pending_.begin (), pending_.begin () + offset);
+
+  if (final)
+  {
+    uint8_t adler[4];
+    PutBigEndian ((adler_b_ << 16) | adler_a_, adler);
+    data.insert (data.end (), adler, adler + 4);
+  }
+  WriteChunk ("IDAT", data.data (), data.size ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PngStreamWriter::WriteChunk
+(
+ const char*    type,
+ const uint8_t* data,
+ std::size_t    size
+)
+  -> void
+{
+  uint8_t length[4];
+  PutBigEndian (static_cast <uint32_t> (size), length);
+  file_.write (reinterpret_cast <const char*> (length), 4);
+  file_.write (type, 4);
+  if (size > 0) { file_.write (reinterpret_cast <const char*> (data), size); }
+
+  uint32_t crc = Crc32 (0, reinterpret_cast <const uint8_t*> (type), 4);
+  crc = Crc32 (crc, data, size);
+  uint8_t tail[4];
+  PutBigEndian (crc, tail);
+  file_.write (reinterpret_cast <const char*> (tail), 4);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
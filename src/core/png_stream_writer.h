@@ -0,0 +1,97 @@
+/*!
+ * @file png_stream_writer.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _PNG_STREAM_WRITER_H_
+#define _PNG_STREAM_WRITER_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "niepce.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+//! ----------------------------------------------------------------------------
+//! @class PngStreamWriter
+//! @brief Write the 8 bits RGB PNG row by row.
+//! @details stbi_write_png () needs the whole image in memory, which is too
+//!          large for films of tens of thousands pixels wide. The rows are
+//!          stored in uncompressed deflate blocks, so that nothing but the
+//!          current block is kept in memory.
+//! ----------------------------------------------------------------------------
+class PngStreamWriter
+{
+public:
+  //! The default class constructor.
+  PngStreamWriter () = delete;
+
+  //! The constructor creates the file and writes the header.
+  PngStreamWriter (const char* filename, int width, int height);
+
+  //! The copy constructor of the class.
+  PngStreamWriter (const PngStreamWriter& writer) = delete;
+
+  //! The move constructor of the class.
+  PngStreamWriter (PngStreamWriter&& writer) = delete;
+
+  //! The class destructor closes the file.
+  virtual ~PngStreamWriter ();
+
+  //! The copy assignment operator of the class.
+  auto operator = (const PngStreamWriter& writer) -> PngStreamWriter& = delete;
+
+  //! The move assignment operator of the class.
+  auto operator = (PngStreamWriter&& writer) -> PngStreamWriter& = delete;
+
+public:
+  /*!
+   * @fn void WriteRow (const uint8_t*)
+   * @brief Write the next row.
+   * @param[in] rgb
+   *    Width x 3 bytes.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto WriteRow (const uint8_t* rgb) -> void;
+
+  /*!
+   * @fn bool Close ()
+   * @brief Finish the image and close the file.
+   * @return False if the file is not written completely.
+   * @exception none
+   * @details Every row must have been written.
+   */
+  auto Close () -> bool;
+
+private:
+  auto Append (const uint8_t* data, std::size_t size) -> void;
+  auto FlushBlocks (bool final) -> void;
+  auto WriteChunk (const char* type, const uint8_t* data, std::size_t size)
+    -> void;
+
+private:
+  const int width_;
+  const int height_;
+  int       num_rows_     = 0;
+  bool      closed_       = false;
+  bool      zlib_started_ = false;
+
+  std::ofstream          file_;
+  std::vector <uint8_t>  pending_;  // Filtered rows not in a block yet.
+  uint32_t               adler_a_ = 1;
+  uint32_t               adler_b_ = 0;
+}; // class PngStreamWriter
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _PNG_STREAM_WRITER_H_
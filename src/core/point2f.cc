@@ -29,7 +29,7 @@ Point2f::Point2f (Float t) :
 #ifdef NIEPCE_USE_SIMD
   xyzw_ (_mm_set_ps (0, 0, t, t))
 #else
-  x_ (t), y_ (t)
+  x_ (t), y_ (t), z_ (0), w_ (0)
 #endif // NIEPCE_USE_SIMD
 {}
 /*
@@ -39,7 +39,7 @@ Point2f::Point2f (Float x, Float y) :
 #ifdef NIEPCE_USE_SIMD
   xyzw_ (_mm_set_ps (0, 0, y, x))
 #else
-  x_ (x), y_ (y)
+  x_ (x), y_ (y), z_ (0), w_ (0)
 #endif // NIEPCE_USE_SIMD
 {}
 /*
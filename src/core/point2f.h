@@ -35,7 +35,7 @@ public:
   Point2f (const Point2f&  p) = default;
   Point2f (      Point2f&& p) = default;
 
-  virtual ~Point2f () = default;
+  ~Point2f () = default;
 
   /* Operators */
   auto operator = (const Point2f&  p) -> Point2f& = default;
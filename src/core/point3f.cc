@@ -19,7 +19,7 @@ Point3f::Point3f () :
 #ifdef NIEPCE_USE_SIMD
   xyzw_ (_mm_setzero_ps ())
 #else
-  x_ (0), y_ (0), z_ (0)
+  x_ (0), y_ (0), z_ (0), w_ (0)
 #endif // NIEPCE_USE_SIMD
 {}
 /*
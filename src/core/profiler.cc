@@ -0,0 +1,249 @@
+/*!
+ * @file profiler.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "profiler.h"
+#include "singleton.h"
+#include <ctime>
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+auto CpuNanoseconds (clockid_t clock) -> uint64_t
+{
+  timespec t;
+  clock_gettime (clock, &t);
+  return static_cast <uint64_t> (t.tv_sec) * 1000000000ull + t.tv_nsec;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Seconds (uint64_t ns) -> double
+{
+  return static_cast <double> (ns) * 1e-9;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto JsonString (const std::string& str) -> std::string
+{
+  std::string escaped = "\"";
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\') { escaped += '\\'; }
+    if (static_cast <unsigned char> (c) < 0x20) { continue; }
+    escaped += c;
+  }
+  return escaped + "\"";
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+Profiler::Profiler () :
+  start_wall_   (std::chrono::steady_clock::now ()),
+  start_cpu_ns_ (CpuNanoseconds (CLOCK_PROCESS_CPUTIME_ID))
+{}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Profiler::Begin (const std::string& name) -> void
+{
+  auto profile = ThisThread ();
+  Frame frame;
+  frame.path = profile->stack.empty ()
+             ? name : profile->stack.back ().path + "/" + name;
+  frame.wall   = std::chrono::steady_clock::now ();
+  frame.cpu_ns = CpuNanoseconds (CLOCK_THREAD_CPUTIME_ID);
+  profile->stack.push_back (std::move (frame));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Profiler::End () -> void
+{
+  auto profile = ThisThread ();
+  if (profile->stack.empty ()) { return; }
+
+  const auto& frame = profile->stack.back ();
+  const auto wall = std::chrono::steady_clock::now () - frame.wall;
+  auto& stat = profile->stats[frame.path];
+  stat.calls       += 1;
+  stat.wall_ns     += std::chrono::duration_cast <std::chrono::nanoseconds>
+                      (wall).count ();
+  stat.cpu_ns      += CpuNanoseconds (CLOCK_THREAD_CPUTIME_ID) - frame.cpu_ns;
+  stat.num_threads  = 1;
+  if (stat.calls == 1)
+  {
+    stat.first_ns = std::chrono::duration_cast <std::chrono::nanoseconds>
+                    (frame.wall - start_wall_).count ();
+  }
+  profile->stack.pop_back ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Profiler::Report (std::ostream& os) -> void
+{
+  const auto stats = Merge ();
+
+  os << std::left  << std::setw (32) << "Stage"
+     << std::right << std::setw (8)  << "calls"
+     << std::setw (12) << "wall [s]"
+     << std::setw (12) << "cpu [s]"
+     << std::setw (9)  << "threads" << "\n";
+  os << std::fixed << std::setprecision (3);
+  for (const auto& entry : stats)
+  {
+    // Indent the last name of the path by the depth.
+    const auto& path  = entry.first;
+    const auto  depth = std::count (path.begin (), path.end (), '/');
+    const auto  slash = path.rfind ('/');
+    const auto  name  = std::string (depth * 2, ' ')
+                      + (slash == std::string::npos
+                         ? path : path.substr (slash + 1));
+    const auto& stat = entry.second;
+    os << std::left  << std::setw (32) << name
+       << std::right << std::setw (8)  << stat.calls
+       << std::setw (12) << Seconds (stat.wall_ns)
+       << std::setw (12) << Seconds (stat.cpu_ns)
+       << std::setw (9)  << stat.num_threads << "\n";
+  }
+
+  const auto wall = std::chrono::steady_clock::now () - start_wall_;
+  os << std::left << std::setw (40) << "Total"
+     << std::right << std::setw (12) << std::chrono::duration <double>
+                                        (wall).count ()
+     << std::setw (12)
+     << Seconds (CpuNanoseconds (CLOCK_PROCESS_CPUTIME_ID) - start_cpu_ns_)
+     << "\n";
+  os.unsetf (std::ios::floatfield);
+  os << std::flush;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Profiler::WriteJson (const std::string& filename, const std::string& scene)
+  -> bool
+{
+  std::ofstream ofs (filename);
+  if (!ofs)
+  {
+    std::cerr << "Failed to open " << filename << std::endl;
+    return false;
+  }
+
+  const auto stats = Merge ();
+  const auto wall = std::chrono::steady_clock::now () - start_wall_;
+  ofs << std::setprecision (9)
+      << "{\n"
+      << "  \"scene\": " << JsonString (scene) << ",\n"
+      << "  \"wall_seconds\": "
+      << std::chrono::duration <double> (wall).count () << ",\n"
+      << "  \"cpu_seconds\": "
+      << Seconds (CpuNanoseconds (CLOCK_PROCESS_CPUTIME_ID) - start_cpu_ns_)
+      << ",\n"
+      << "  \"stages\": [";
+  bool first = true;
+  for (const auto& entry : stats)
+  {
+    const auto& stat = entry.second;
+    ofs << (first ? "\n" : ",\n")
+        << "    {\"name\": " << JsonString (entry.first)
+        << ", \"calls\": " << stat.calls
+        << ", \"wall_seconds\": " << Seconds (stat.wall_ns)
+        << ", \"cpu_seconds\": " << Seconds (stat.cpu_ns)
+        << ", \"threads\": " << stat.num_threads << "}";
+    first = false;
+  }
+  ofs << "\n  ]\n}\n";
+  return static_cast <bool> (ofs);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Profiler::ThisThread () -> ThreadProfile*
+{
+  thread_local ThreadProfile* profile = nullptr;
+  if (profile == nullptr)
+  {
+    std::lock_guard <std::mutex> lock (mutex_);
+    threads_.emplace_back (new ThreadProfile);
+    profile = threads_.back ().get ();
+  }
+  return profile;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Profiler::Merge () -> std::vector <std::pair <std::string, ProfileStat>>
+{
+  std::map <std::string, ProfileStat> merged;
+  {
+    std::lock_guard <std::mutex> lock (mutex_);
+    for (const auto& profile : threads_)
+    {
+      for (const auto& entry : profile->stats)
+      {
+        const auto& stat = entry.second;
+        auto& sum = merged[entry.first];
+        sum.first_ns     = sum.calls == 0
+                         ? stat.first_ns : std::min (sum.first_ns,
+                                                     stat.first_ns);
+        sum.calls       += stat.calls;
+        sum.wall_ns     += stat.wall_ns;
+        sum.cpu_ns      += stat.cpu_ns;
+        sum.num_threads += stat.num_threads;
+      }
+    }
+  }
+
+  // In the order that stages were entered first, so that a stage follows
+  // its parent.
+  std::vector <std::pair <std::string, ProfileStat>> stats (merged.begin (),
+                                                            merged.end ());
+  std::stable_sort (stats.begin (), stats.end (),
+                    [] (const std::pair <std::string, ProfileStat>& a,
+                        const std::pair <std::string, ProfileStat>& b)
+  {
+    return a.second.first_ns < b.second.first_ns;
+  });
+  return stats;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+ProfileScope::ProfileScope (const std::string& name) :
+  profiler_ (Singleton <Profiler>::Instance ())
+{
+  profiler_.Begin (name);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+ProfileScope::~ProfileScope ()
+{
+  profiler_.End ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
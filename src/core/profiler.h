@@ -0,0 +1,173 @@
+/*!
+ * @file profiler.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "niepce.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @struct ProfileStat
+ * @brief The time spent in a stage.
+ * @details The times of a stage entered by several threads are summed.
+ */
+struct ProfileStat
+{
+  uint64_t calls       = 0;
+  uint64_t wall_ns     = 0;
+  uint64_t cpu_ns      = 0; //!< The CPU time of the thread.
+  int      num_threads = 0; //!< The threads which entered the stage.
+  uint64_t first_ns    = 0; //!< When it was entered first, from the start.
+};
+//! ----------------------------------------------------------------------------
+//! @class Profiler
+//! @brief The times of the named stages of the whole run.
+//! @details Stages are nested by ProfileScope. The name of a nested stage is
+//!          the path from the outermost one, separated by '/'. Each thread
+//!          sums its own stages without locks, and they are merged by the
+//!          report. It is used through Singleton <Profiler>.
+//! ----------------------------------------------------------------------------
+class Profiler
+{
+public:
+  //! The class constructor starts the total time.
+  Profiler ();
+
+  //! The copy constructor of the class.
+  Profiler (const Profiler& profiler) = delete;
+
+  //! The move constructor of the class.
+  Profiler (Profiler&& profiler) = delete;
+
+  //! The default class destructor.
+  virtual ~Profiler () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const Profiler& profiler) -> Profiler& = delete;
+
+  //! The move assignment operator of the class.
+  auto operator = (Profiler&& profiler) -> Profiler& = delete;
+
+public:
+  /*!
+   * @fn void Begin (const std::string&)
+   * @brief Enter the stage in the current stage of this thread.
+   * @param[in] name
+   *    The name which may contain '/' to be nested further.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Begin (const std::string& name) -> void;
+
+  /*!
+   * @fn void End ()
+   * @brief Leave the innermost stage of this thread.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto End () -> void;
+
+  /*!
+   * @fn void Report (std::ostream&)
+   * @brief Print the merged stages as a tree.
+   * @param[out] os
+   * @return
+   * @exception none
+   * @details Every thread must have left its stages.
+   */
+  auto Report (std::ostream& os) -> void;
+
+  /*!
+   * @fn bool WriteJson (const std::string&, const std::string&)
+   * @brief Write the merged stages to the JSON file.
+   * @param[in] filename
+   * @param[in] scene
+   *    The scene file, so that runs of the same scene are compared.
+   * @return False if the file could not be written.
+   * @exception none
+   * @details Every thread must have left its stages.
+   */
+  auto WriteJson (const std::string& filename, const std::string& scene)
+    -> bool;
+
+private:
+  struct Frame
+  {
+    std::string path;
+    std::chrono::steady_clock::time_point wall;
+    uint64_t cpu_ns;
+  };
+
+  struct ThreadProfile
+  {
+    std::vector <Frame>                   stack;
+    std::map <std::string, ProfileStat>   stats;
+  };
+
+  auto ThisThread () -> ThreadProfile*;
+  auto Merge () -> std::vector <std::pair <std::string, ProfileStat>>;
+
+private:
+  std::chrono::steady_clock::time_point start_wall_;
+  uint64_t                              start_cpu_ns_;
+
+  // Profiles of the threads. They live as long as the profiler, since pool
+  // threads outlive their tasks.
+  std::mutex                                    mutex_;
+  std::vector <std::unique_ptr <ThreadProfile>> threads_;
+}; // class Profiler
+//! ----------------------------------------------------------------------------
+//! @class ProfileScope
+//! @brief Time the enclosing block as a stage of Singleton <Profiler>.
+//! @details
+//! ----------------------------------------------------------------------------
+class ProfileScope
+{
+public:
+  //! The default class constructor.
+  ProfileScope () = delete;
+
+  //! The constructor enters the stage.
+  explicit ProfileScope (const std::string& name);
+
+  //! The copy constructor of the class.
+  ProfileScope (const ProfileScope& scope) = delete;
+
+  //! The move constructor of the class.
+  ProfileScope (ProfileScope&& scope) = delete;
+
+  //! The class destructor leaves the stage.
+  ~ProfileScope ();
+
+  //! The copy assignment operator of the class.
+  auto operator = (const ProfileScope& scope) -> ProfileScope& = delete;
+
+  //! The move assignment operator of the class.
+  auto operator = (ProfileScope&& scope) -> ProfileScope& = delete;
+
+private:
+  Profiler& profiler_;
+}; // class ProfileScope
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _PROFILER_H_
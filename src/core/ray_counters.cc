@@ -0,0 +1,88 @@
+/*!
+ * @file ray_counters.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "ray_counters.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+auto RayCount::ToString (double seconds) const noexcept -> std::string
+{
+  const auto rays  = static_cast <double> (Rays ());
+  const auto per_s = seconds > 0 ? 1e-6 / seconds : 0.0;
+  const auto per_ray = [rays] (uint64_t n)
+  {
+    return rays > 0 ? n / rays : 0.0;
+  };
+
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision (2)
+      << "Camera rays     " << std::setw (16) << camera_rays    << "\n"
+      << "Extension rays  " << std::setw (16) << extension_rays << "\n"
+      << "Shadow rays     " << std::setw (16) << shadow_rays    << "\n"
+      << "BVH nodes       " << std::setw (16) << nodes
+      << std::setw (10) << per_ray (nodes) << " / ray\n"
+      << "Primitive tests " << std::setw (16) << primitives
+      << std::setw (10) << per_ray (primitives) << " / ray\n"
+      << "Rays            " << std::setw (16) << rays * per_s
+      << " M/s\n"
+      << "Samples         " << std::setw (16) << camera_rays * per_s
+      << " M/s\n";
+  return oss.str ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto operator - (const RayCount& lhs, const RayCount& rhs) noexcept
+  -> RayCount
+{
+  RayCount count;
+  count.camera_rays    = lhs.camera_rays    - rhs.camera_rays;
+  count.extension_rays = lhs.extension_rays - rhs.extension_rays;
+  count.shadow_rays    = lhs.shadow_rays    - rhs.shadow_rays;
+  count.nodes          = lhs.nodes          - rhs.nodes;
+  count.primitives     = lhs.primitives     - rhs.primitives;
+  return count;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto RayCounters::Register () -> Counters*
+{
+  std::lock_guard <std::mutex> lock (mutex_);
+  threads_.emplace_back (new Counters);
+  return threads_.back ().get ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto RayCounters::Sum () -> RayCount
+{
+  std::lock_guard <std::mutex> lock (mutex_);
+  RayCount sum;
+  for (const auto& counters : threads_)
+  {
+    const auto order = std::memory_order_relaxed;
+    sum.camera_rays    += counters->camera_rays.load    (order);
+    sum.extension_rays += counters->extension_rays.load (order);
+    sum.shadow_rays    += counters->shadow_rays.load    (order);
+    sum.nodes          += counters->nodes.load          (order);
+    sum.primitives     += counters->primitives.load     (order);
+  }
+  return sum;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,159 @@
+/*!
+ * @file ray_counters.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _RAY_COUNTERS_H_
+#define _RAY_COUNTERS_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "niepce.h"
+#include "singleton.h"
+#include <atomic>
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @struct RayCount
+ * @brief The work done by the renderer.
+ * @details
+ */
+struct RayCount
+{
+  uint64_t camera_rays    = 0; //!< The first rays of the samples.
+  uint64_t extension_rays = 0; //!< The rays traced from the path vertices.
+  uint64_t shadow_rays    = 0; //!< The rays traced to the sampled lights.
+  uint64_t nodes          = 0; //!< The BVH nodes whose bounds were tested.
+  uint64_t primitives     = 0; //!< The primitives tested in the leaves.
+
+  //! Return the number of rays of every kind.
+  auto Rays () const noexcept -> uint64_t
+  {
+    return camera_rays + extension_rays + shadow_rays;
+  }
+
+  /*!
+   * @fn std::string ToString (double)
+   * @brief Return the counts and the rates of the render.
+   * @param[in] seconds
+   *    The wall time spent on the counts.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto ToString (double seconds) const noexcept -> std::string;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+auto operator - (const RayCount& lhs, const RayCount& rhs) noexcept
+  -> RayCount;
+//! ----------------------------------------------------------------------------
+//! @class RayCounters
+//! @brief The counters of every thread.
+//! @details Each thread counts into its own counters, and Sum adds them up
+//!          while the threads run. It is used through Singleton
+//!          <RayCounters>.
+//! ----------------------------------------------------------------------------
+class RayCounters
+{
+public:
+  /*!
+   * @struct Counters
+   * @brief The counters of a thread.
+   * @details Only the thread writes them, so that a relaxed load and store
+   *          is enough to let another thread read them. The padding keeps
+   *          the counters of other threads out of the cache line.
+   */
+  struct Counters
+  {
+    std::atomic <uint64_t> camera_rays    {0};
+    std::atomic <uint64_t> extension_rays {0};
+    std::atomic <uint64_t> shadow_rays    {0};
+    std::atomic <uint64_t> nodes          {0};
+    std::atomic <uint64_t> primitives     {0};
+    char padding[64];
+  };
+
+public:
+  //! The default class constructor.
+  RayCounters () = default;
+
+  //! The copy constructor of the class.
+  RayCounters (const RayCounters& counters) = delete;
+
+  //! The move constructor of the class.
+  RayCounters (RayCounters&& counters) = delete;
+
+  //! The default class destructor.
+  virtual ~RayCounters () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const RayCounters& counters) -> RayCounters& = delete;
+
+  //! The move assignment operator of the class.
+  auto operator = (RayCounters&& counters) -> RayCounters& = delete;
+
+public:
+  /*!
+   * @fn Counters* Register ()
+   * @brief Add the counters of a thread.
+   * @return The counters which live as long as this.
+   * @exception none
+   * @details Use ThreadRayCounters instead, which registers once per
+   *          thread.
+   */
+  auto Register () -> Counters*;
+
+  /*!
+   * @fn RayCount Sum ()
+   * @brief Add up the counters of the threads.
+   * @return
+   * @exception none
+   * @details The counts of the running threads may be a little behind.
+   */
+  auto Sum () -> RayCount;
+
+private:
+  std::mutex                                mutex_;
+  std::vector <std::unique_ptr <Counters>>  threads_;
+}; // class RayCounters
+/*
+// ---------------------------------------------------------------------------
+*/
+//! Return the counters of this thread.
+inline auto ThreadRayCounters () -> RayCounters::Counters&
+{
+  thread_local RayCounters::Counters* counters = nullptr;
+  if (counters == nullptr)
+  {
+    counters = Singleton <RayCounters>::Instance ().Register ();
+  }
+  return *counters;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+//! Add to a counter of this thread.
+inline auto Increase (std::atomic <uint64_t>& counter, uint64_t n = 1)
+  noexcept -> void
+{
+  counter.store (counter.load (std::memory_order_relaxed) + n,
+                 std::memory_order_relaxed);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _RAY_COUNTERS_H_
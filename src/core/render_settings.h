@@ -16,6 +16,103 @@
 */
 namespace niepce
 {
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @enum LightSampling
+ * @brief The strategy to choose a light for the next event estimation.
+ * @details
+ */
+enum class LightSampling : unsigned int
+{
+  kPower   = 0, /*!< In proportion to the power of lights. */
+  kUniform = 1, /*!< All lights are equally likely. */
+  kBvh     = 2, /*!< Traverse the light BVH by the importance to the point. */
+};
+/*!
+ * @enum MisHeuristic
+ * @brief The weight to combine the BSDF sampling and the light sampling.
+ * @details
+ */
+enum class MisHeuristic : unsigned int
+{
+  kPower = 0, /*!< The power heuristic with the exponent 2. */
+  kNone  = 1, /*!< Lights are reached only by the next event estimation. */
+};
+/*!
+ * @enum RussianRoulette
+ * @brief The policy to terminate paths before the maximum depth.
+ * @details
+ */
+enum class RussianRoulette : unsigned int
+{
+  kNone       = 0, /*!< Paths run to the maximum depth unless they escape. */
+  kThroughput = 1, /*!< Survive in proportion to the throughput luminance. */
+  kEfficiency = 2, /*!< Also scaled by what each depth adds to the image. */
+};
+/*!
+ * @enum SamplerType
+ * @brief The sampler to draw samples of each pixel.
+ * @details
+ */
+enum class SamplerType : unsigned int
+{
+  kSobol     = 0, /*!< Owen-scrambled Sobol sequence of each pixel. */
+  kRandom    = 1, /*!< Independent uniform random numbers. */
+  kBlueNoise = 2, /*!< Sobol sequence with the error as blue noise. */
+};
+/*!
+ * @enum FilmAccumulation
+ * @brief The way samples reach the film.
+ * @details
+ */
+enum class FilmAccumulation : unsigned int
+{
+  kTile   = 0, /*!< Each tile sums its pixels and replaces them in the film. */
+  kAtomic = 1, /*!< Samples are added to the film by atomic float adds. */
+  kStream = 2, /*!< Finished tiles are flushed to the disk (out of core). */
+};
+/*!
+ * @enum DenoiserType
+ * @brief The filter applied to the film before tone mapping.
+ * @details
+ */
+enum class DenoiserType : unsigned int
+{
+  kNone      = 0, /*!< The film is saved as rendered. */
+  kBilateral = 1, /*!< Cross bilateral filter guided by first hit features. */
+};
+/*!
+ * @enum Aov
+ * @brief The arbitrary output variables written in the same pass as the film.
+ * @details Item::kAovs is the bitwise or of AovBit () of the enabled ones.
+ */
+enum class Aov : unsigned int
+{
+  kAlbedo      = 0, /*!< The weight of the BSDF sample at the first hit. */
+  kNormal      = 1, /*!< The shading normal of the first hit. */
+  kDepth       = 2, /*!< The distance of the first hit from the camera. */
+  kPrimitiveId = 3, /*!< The index of the primitive of the first hit. */
+  kMaterialId  = 4, /*!< The index of the material of the first hit. */
+  kDirect      = 5, /*!< The radiance of paths of at most one bounce. */
+  kIndirect    = 6, /*!< The radiance of the other paths. */
+  kSampleCount = 7, /*!< The number of samples of the pixel. */
+  kTime        = 8, /*!< The seconds spent on the samples of the pixel. */
+  kNumAovs
+};
+/*!
+ * @fn unsigned int AovBit (Aov)
+ * @brief Return the bit of the AOV in Item::kAovs.
+ * @param[in] aov
+ * @return
+ * @exception none
+ * @details
+ */
+constexpr auto AovBit (Aov aov) noexcept -> unsigned int
+{
+  return 1u << static_cast <unsigned int> (aov);
+}
 //! ----------------------------------------------------------------------------
 //! @class RenderSettings
 //! @brief
@@ -36,10 +133,21 @@ public:
     kHeight,     /*!< The length of height of image. */
     kTileWidth,  /*!< The length of width of tile. */
     kTileHeight, /*!< The length of height of tile. */
-    kNumThread,  /*!< The number of thread to render a image. */
+    kNumThread,  /*!< The number of render tasks, or 0 for each core. */
     kNumSamples, /*!< The number of sampling. */
     kPTMaxDepth, /*!< The number of depth if path tracing avaliable. */
     kNumRound,
+    kLightSampling, /*!< The strategy to choose a light. See LightSampling. */
+    kMis,           /*!< The weight of light paths. See MisHeuristic. */
+    kRoulette,      /*!< The termination policy. See RussianRoulette. */
+    kRouletteDepth, /*!< The depth from which Russian roulette starts. */
+    kSampler,       /*!< The sampler of pixels. See SamplerType. */
+    kFilm,          /*!< The accumulation of the film. See FilmAccumulation. */
+    kDenoiser,      /*!< The post process filter. See DenoiserType. */
+    kAovs,          /*!< The bits of the output variables. See Aov. */
+    kTrace,         /*!< Write the timeline of the tasks to trace.json. */
+    kTimeLimit,     /*!< Milliseconds to render, or 0 for all rounds. */
+    kKeepFilm,      /*!< Keep the tiled film file of the streamed film. */
   };
 
 public:
@@ -6,6 +6,8 @@
  * @details
  */
 #include "thread_pool.h"
+#include "tracer.h"
+#include <atomic>
 /*
 // ---------------------------------------------------------------------------
 */
@@ -48,6 +50,7 @@ ThreadPool::ThreadPool (unsigned int num_thread) :
       }
 
       // Operate the task
+      TraceScope trace ("task");
       task ();
     }
   }; // lambda
@@ -81,4 +84,59 @@ ThreadPool::~ThreadPool ()
 /*
 // ---------------------------------------------------------------------------
 */
+auto ParallelFor (int n, const std::function <void (int, int)>& func) -> void
+{
+  if (n <= 0) { return ; }
+
+  // A few chunks per thread to balance the load.
+  const int num_threads = std::max (1u, std::thread::hardware_concurrency ());
+  const int chunk_size  = (n + std::min (n, num_threads * 4) - 1)
+                        / std::min (n, num_threads * 4);
+  const int num_chunks  = (n + chunk_size - 1) / chunk_size;
+
+  // The chunks are a group which the caller and the workers take from. The
+  // caller runs only chunks of the group, not other tasks of the pool, and
+  // it waits only for chunks which are running.
+  struct Group
+  {
+    std::atomic <int>       next {0};
+    std::atomic <int>       done {0};
+    std::mutex              mutex;
+    std::condition_variable finished;
+  };
+  auto group = std::make_shared <Group> ();
+
+  // A worker which starts after all chunks were taken returns without
+  // touching func, which may be gone by then.
+  const std::function <void (int, int)>* f = &func;
+  auto run = [group, f, n, chunk_size, num_chunks] ()
+  {
+    for (int chunk = group->next++; chunk < num_chunks; chunk = group->next++)
+    {
+      const int begin = chunk * chunk_size;
+      (*f) (begin, std::min (begin + chunk_size, n));
+      if (++group->done == num_chunks)
+      {
+        std::lock_guard <std::mutex> lock (group->mutex);
+        group->finished.notify_all ();
+      }
+    }
+  };
+
+  ThreadPool& pool = Singleton <ThreadPool>::Instance ();
+  for (int i = 1; i < std::min (num_threads, num_chunks); ++i)
+  {
+    pool.Enqueue (run);
+  }
+  run ();
+
+  std::unique_lock <std::mutex> lock (group->mutex);
+  group->finished.wait (lock, [&group, num_chunks] ()
+  {
+    return group->done == num_chunks;
+  });
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 }  // namespace niepce
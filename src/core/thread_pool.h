@@ -102,6 +102,23 @@ auto ThreadPool::Enqueue(F&& func, Args&& ... args)
 /*
 // ---------------------------------------------------------------------------
 */
+/*!
+ * @fn void ParallelFor (int, const std::function <void (int, int)>&)
+ * @brief Split [0, n) into chunks and run them on the thread pool.
+ * @param[in] n
+ *    The number of items.
+ * @param[in] func
+ *    The function takes the range [begin, end) of a chunk.
+ * @return void
+ * @exception none
+ * @details The calling thread runs chunks too, and while it waits it runs
+ *          no other task, so that it may be called from tasks running on
+ *          the thread pool without delaying them by unrelated work.
+ */
+auto ParallelFor (int n, const std::function <void (int, int)>& func) -> void;
+/*
+// ---------------------------------------------------------------------------
+*/
 }  // namespace niepce
 /*
 // ---------------------------------------------------------------------------
@@ -0,0 +1,159 @@
+/*!
+ * @file tiled_film_file.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "tiled_film_file.h"
+#include "film_tile.h"
+#include "point2f.h"
+#include "vector3f.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+constexpr char kMagic[4] = {'N', 'P', 'T', 'F'};
+constexpr std::streamoff kHeaderSize = sizeof (kMagic) + 4 * sizeof (int32_t);
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+TiledFilmFile::TiledFilmFile
+(
+ const char* filename,
+ int width,
+ int height,
+ int tile_width,
+ int tile_height
+) :
+  width_       (width),
+  height_      (height),
+  tile_width_  (tile_width),
+  tile_height_ (tile_height),
+  num_tiles_x_ ((width + tile_width - 1) / tile_width),
+  file_ (filename, std::ios::in | std::ios::out
+                 | std::ios::trunc | std::ios::binary)
+{
+  if (!file_)
+  {
+    std::cerr << "Failed to create the film file " << filename << std::endl;
+    return;
+  }
+  const int32_t header[4] = {width, height, tile_width, tile_height};
+  file_.write (kMagic, sizeof (kMagic));
+  file_.write (reinterpret_cast <const char*> (header), sizeof (header));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto TiledFilmFile::IsOpen () const noexcept -> bool
+{
+  return file_.is_open () && !file_.fail ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto TiledFilmFile::NumTileRows () const noexcept -> int
+{
+  return (height_ + tile_height_ - 1) / tile_height_;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto TiledFilmFile::WriteTile (const FilmTile& tile, Float scale) -> bool
+{
+  const int begin_x = static_cast <int> (tile.Min ().X ());
+  const int begin_y = static_cast <int> (tile.Min ().Y ());
+  const int width   = static_cast <int> (tile.Max ().X ()) - begin_x;
+  const int height  = static_cast <int> (tile.Max ().Y ()) - begin_y;
+
+  // Convert the tile before locking the file.
+  std::vector <float> pixels (tile_width_ * tile_height_ * 3, 0.0f);
+  for (int y = 0; y < height; ++y)
+  {
+    for (int x = 0; x < width; ++x)
+    {
+      const auto value = tile.At (x, y) * scale;
+      float* p = &pixels[(y * tile_width_ + x) * 3];
+      p[0] = value.X ();
+      p[1] = value.Y ();
+      p[2] = value.Z ();
+    }
+  }
+
+  std::lock_guard <std::mutex> lock (mutex_);
+  file_.seekp (TileOffset (begin_x / tile_width_, begin_y / tile_height_));
+  file_.write (reinterpret_cast <const char*> (pixels.data ()),
+               pixels.size () * sizeof (float));
+  if (!file_)
+  {
+    std::cerr << "Failed to write the tile " << tile.TileNumber () << std::endl;
+    return false;
+  }
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto TiledFilmFile::ReadTileRow (int row, std::vector <float>* pixels) -> bool
+{
+  const int begin_y = row * tile_height_;
+  const int height  = std::min (tile_height_, height_ - begin_y);
+  pixels->resize (width_ * height * 3);
+
+  std::vector <float> tile (tile_width_ * tile_height_ * 3);
+  std::lock_guard <std::mutex> lock (mutex_);
+  file_.flush ();
+  for (int tx = 0; tx < num_tiles_x_; ++tx)
+  {
+    file_.seekg (TileOffset (tx, row));
+    file_.read (reinterpret_cast <char*> (tile.data ()),
+                tile.size () * sizeof (float));
+    if (!file_)
+    {
+      std::cerr << "Failed to read the tile row " << row << std::endl;
+      return false;
+    }
+
+    // Drop the padding of the tiles at the right edge.
+    const int begin_x = tx * tile_width_;
+    const int width   = std::min (tile_width_, width_ - begin_x);
+    for (int y = 0; y < height; ++y)
+    {
+      const float* src = tile.data () + y * tile_width_ * 3;
+      std::copy (src, src + width * 3,
+                 pixels->data () + (y * width_ + begin_x) * 3);
+    }
+  }
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto TiledFilmFile::TileOffset (int tile_x, int tile_y)
+  const noexcept -> std::streamoff
+{
+  const std::streamoff index = tile_y * num_tiles_x_ + tile_x;
+  return kHeaderSize
+       + index * tile_width_ * tile_height_ * 3 * sizeof (float);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
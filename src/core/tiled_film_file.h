@@ -0,0 +1,128 @@
+/*!
+ * @file tiled_film_file.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _TILED_FILM_FILE_H_
+#define _TILED_FILM_FILE_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "niepce.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+//! ----------------------------------------------------------------------------
+//! @class TiledFilmFile
+//! @brief The film on the disk, stored tile by tile.
+//! @details The header (magic "NPTF", width, height, tile width and tile
+//!          height as 32 bits integers) is followed by the tiles in row major
+//!          order. Each tile has tile width x tile height pixels of 3 floats,
+//!          even at the edges, so that the offset of a tile is known before
+//!          any tile is written. Tiles are written in any order as they
+//!          finish, and read back a row of tiles at a time. It is thread safe.
+//! ----------------------------------------------------------------------------
+class TiledFilmFile
+{
+public:
+  //! The default class constructor.
+  TiledFilmFile () = delete;
+
+  //! The constructor creates the file of the resolution and the tile size.
+  TiledFilmFile
+  (
+   const char* filename,
+   int width,
+   int height,
+   int tile_width,
+   int tile_height
+  );
+
+  //! The copy constructor of the class.
+  TiledFilmFile (const TiledFilmFile& file) = delete;
+
+  //! The move constructor of the class.
+  TiledFilmFile (TiledFilmFile&& file) = delete;
+
+  //! The default class destructor.
+  virtual ~TiledFilmFile () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const TiledFilmFile& file) -> TiledFilmFile& = delete;
+
+  //! The move assignment operator of the class.
+  auto operator = (TiledFilmFile&& file) -> TiledFilmFile& = delete;
+
+public:
+  auto Width  () const noexcept -> int { return width_; }
+  auto Height () const noexcept -> int { return height_; }
+  auto TileHeight () const noexcept -> int { return tile_height_; }
+
+  /*!
+   * @fn bool IsOpen ()
+   * @brief
+   * @return
+   * @exception none
+   * @details
+   */
+  auto IsOpen () const noexcept -> bool;
+
+  /*!
+   * @fn int NumTileRows ()
+   * @brief Return the number of rows of tiles.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto NumTileRows () const noexcept -> int;
+
+  /*!
+   * @fn bool WriteTile (const FilmTile&, Float)
+   * @brief Write the pixels of the tile.
+   * @param[in] tile
+   *    Its bounds must be a cell of the tile grid.
+   * @param[in] scale
+   *    The scale of the values of the tile.
+   * @return False if it failed to write.
+   * @exception none
+   * @details
+   */
+  auto WriteTile (const FilmTile& tile, Float scale) -> bool;
+
+  /*!
+   * @fn bool ReadTileRow (int, std::vector <float>*)
+   * @brief Read the pixels of the row of tiles.
+   * @param[in] row
+   * @param[out] pixels
+   *    RGB of width x the rows of the tiles, without the padding of tiles.
+   * @return False if it failed to read.
+   * @exception none
+   * @details
+   */
+  auto ReadTileRow (int row, std::vector <float>* pixels) -> bool;
+
+private:
+  auto TileOffset (int tile_x, int tile_y) const noexcept -> std::streamoff;
+
+private:
+  const int width_;
+  const int height_;
+  const int tile_width_;
+  const int tile_height_;
+  const int num_tiles_x_;
+
+  std::mutex   mutex_;
+  std::fstream file_;
+}; // class TiledFilmFile
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _TILED_FILM_FILE_H_
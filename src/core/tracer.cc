@@ -0,0 +1,153 @@
+/*!
+ * @file tracer.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "tracer.h"
+#include "singleton.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+Tracer::Tracer () :
+  start_   (std::chrono::steady_clock::now ()),
+  enabled_ (false)
+{}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Tracer::Enable (std::size_t capacity) -> void
+{
+  std::lock_guard <std::mutex> lock (mutex_);
+  capacity_ = std::max (capacity, static_cast <std::size_t> (1));
+  for (auto& buffer : threads_)
+  {
+    buffer->events.resize (capacity_);
+    buffer->count.store (0, std::memory_order_relaxed);
+  }
+  enabled_.store (true, std::memory_order_release);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Tracer::Now () const noexcept -> uint64_t
+{
+  return std::chrono::duration_cast <std::chrono::nanoseconds>
+    (std::chrono::steady_clock::now () - start_).count ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Tracer::Record (const TraceEvent& event) -> void
+{
+  auto buffer = ThisThread ();
+  const auto count = buffer->count.load (std::memory_order_relaxed);
+  buffer->events[count % buffer->events.size ()] = event;
+  buffer->count.store (count + 1, std::memory_order_release);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Tracer::WriteChromeTrace (const std::string& filename) -> bool
+{
+  std::ofstream ofs (filename);
+  if (!ofs)
+  {
+    std::cerr << "Failed to open " << filename << std::endl;
+    return false;
+  }
+
+  std::lock_guard <std::mutex> lock (mutex_);
+  ofs << std::fixed << std::setprecision (3) << "{\"traceEvents\": [";
+  bool first = true;
+  for (const auto& buffer : threads_)
+  {
+    const auto tid = buffer->thread_id;
+    ofs << (first ? "\n" : ",\n")
+        << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, "
+        << "\"tid\": " << tid << ", \"args\": {\"name\": \"thread "
+        << tid << "\"}}";
+    first = false;
+
+    // Only the last events are in the ring when it has wrapped around.
+    const auto count = buffer->count.load (std::memory_order_acquire);
+    const auto size  = static_cast <uint64_t> (buffer->events.size ());
+    for (auto i = count > size ? count - size : 0; i < count; ++i)
+    {
+      const auto& event = buffer->events[i % size];
+      ofs << ",\n  {\"name\": \"" << event.name << "\", \"ph\": \"X\", "
+          << "\"pid\": 0, \"tid\": " << tid
+          << ", \"ts\": " << event.begin_ns * 1e-3
+          << ", \"dur\": " << (event.end_ns - event.begin_ns) * 1e-3;
+      if (event.tile >= 0)
+      {
+        ofs << ", \"args\": {\"tile\": " << event.tile
+            << ", \"round\": " << event.round << "}";
+      }
+      ofs << "}";
+    }
+    if (count > size)
+    {
+      std::cerr << "The trace of thread " << tid << " dropped "
+                << count - size << " events." << std::endl;
+    }
+  }
+  ofs << "\n], \"displayTimeUnit\": \"ms\"}\n";
+  return static_cast <bool> (ofs);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Tracer::ThisThread () -> ThreadBuffer*
+{
+  thread_local ThreadBuffer* buffer = nullptr;
+  if (buffer == nullptr)
+  {
+    std::lock_guard <std::mutex> lock (mutex_);
+    threads_.emplace_back (new ThreadBuffer);
+    buffer = threads_.back ().get ();
+    buffer->thread_id = static_cast <int> (threads_.size ()) - 1;
+    buffer->events.resize (capacity_);
+    buffer->count.store (0, std::memory_order_relaxed);
+  }
+  return buffer;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TraceScope::TraceScope (const char* name, int tile, int round) :
+  tracer_ (&Singleton <Tracer>::Instance ())
+{
+  if (!tracer_->IsEnabled ())
+  {
+    tracer_ = nullptr;
+    return;
+  }
+  event_.name     = name;
+  event_.begin_ns = tracer_->Now ();
+  event_.end_ns   = event_.begin_ns;
+  event_.tile     = tile;
+  event_.round    = round;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TraceScope::~TraceScope ()
+{
+  if (tracer_ == nullptr) { return; }
+  event_.end_ns = tracer_->Now ();
+  tracer_->Record (event_);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
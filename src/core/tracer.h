@@ -0,0 +1,167 @@
+/*!
+ * @file tracer.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _TRACER_H_
+#define _TRACER_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "niepce.h"
+#include <atomic>
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @struct TraceEvent
+ * @brief A span of work on a thread.
+ * @details
+ */
+struct TraceEvent
+{
+  const char* name;     //!< A string literal.
+  uint64_t    begin_ns; //!< From the start of the tracer.
+  uint64_t    end_ns;
+  int32_t     tile;     //!< -1 if the event is not of a tile.
+  int32_t     round;
+};
+//! ----------------------------------------------------------------------------
+//! @class Tracer
+//! @brief The timeline of the work of each thread.
+//! @details Each thread writes to its own ring buffer without locks, and
+//!          the oldest events are overwritten when it is full. Nothing is
+//!          recorded until it is enabled, so that a disabled trace costs a
+//!          load and a branch per event. It is used through
+//!          Singleton <Tracer>.
+//! ----------------------------------------------------------------------------
+class Tracer
+{
+public:
+  //! The class constructor starts the clock of the events.
+  Tracer ();
+
+  //! The copy constructor of the class.
+  Tracer (const Tracer& tracer) = delete;
+
+  //! The move constructor of the class.
+  Tracer (Tracer&& tracer) = delete;
+
+  //! The default class destructor.
+  virtual ~Tracer () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const Tracer& tracer) -> Tracer& = delete;
+
+  //! The move assignment operator of the class.
+  auto operator = (Tracer&& tracer) -> Tracer& = delete;
+
+public:
+  /*!
+   * @fn void Enable (std::size_t)
+   * @brief Start recording the events.
+   * @param[in] capacity
+   *    The number of events kept by each thread.
+   * @return
+   * @exception none
+   * @details It must be called while no thread records events.
+   */
+  auto Enable (std::size_t capacity) -> void;
+
+  //! Return true if the events are recorded.
+  auto IsEnabled () const noexcept -> bool
+  {
+    return enabled_.load (std::memory_order_relaxed);
+  }
+
+  //! Return the time from the start of the tracer.
+  auto Now () const noexcept -> uint64_t;
+
+  /*!
+   * @fn void Record (const TraceEvent&)
+   * @brief Add the event to the buffer of this thread.
+   * @param[in] event
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Record (const TraceEvent& event) -> void;
+
+  /*!
+   * @fn bool WriteChromeTrace (const std::string&)
+   * @brief Write the events in the trace event format of Chrome.
+   * @param[in] filename
+   * @return False if the file could not be written.
+   * @exception none
+   * @details Open it by chrome://tracing or Perfetto. Threads must not
+   *          record events while it is written.
+   */
+  auto WriteChromeTrace (const std::string& filename) -> bool;
+
+private:
+  struct ThreadBuffer
+  {
+    int                     thread_id;
+    std::vector <TraceEvent> events;
+    std::atomic <uint64_t>  count;  // Events recorded so far.
+  };
+
+  auto ThisThread () -> ThreadBuffer*;
+
+private:
+  std::chrono::steady_clock::time_point start_;
+  std::atomic <bool> enabled_;
+  std::size_t        capacity_ = 0;
+
+  // Buffers of the threads. A thread takes the lock only to add its own.
+  std::mutex                                   mutex_;
+  std::vector <std::unique_ptr <ThreadBuffer>> threads_;
+}; // class Tracer
+//! ----------------------------------------------------------------------------
+//! @class TraceScope
+//! @brief Record the enclosing block as an event of Singleton <Tracer>.
+//! @details
+//! ----------------------------------------------------------------------------
+class TraceScope
+{
+public:
+  //! The default class constructor.
+  TraceScope () = delete;
+
+  //! The constructor takes the name, which must be a string literal.
+  TraceScope (const char* name, int tile = -1, int round = -1);
+
+  //! The copy constructor of the class.
+  TraceScope (const TraceScope& scope) = delete;
+
+  //! The move constructor of the class.
+  TraceScope (TraceScope&& scope) = delete;
+
+  //! The class destructor records the event.
+  ~TraceScope ();
+
+  //! The copy assignment operator of the class.
+  auto operator = (const TraceScope& scope) -> TraceScope& = delete;
+
+  //! The move assignment operator of the class.
+  auto operator = (TraceScope&& scope) -> TraceScope& = delete;
+
+private:
+  Tracer*    tracer_;  // nullptr if the tracer is disabled.
+  TraceEvent event_;
+}; // class TraceScope
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _TRACER_H_
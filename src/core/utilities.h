@@ -60,6 +60,17 @@ inline auto SolveQuadratic
 /*
 // ---------------------------------------------------------------------------
 */
+inline auto PowerHeuristic (int nf, Float f_pdf, int ng, Float g_pdf) -> Float
+{
+  // Veach's power heuristic with the exponent of two.
+  const Float f = nf * f_pdf;
+  const Float g = ng * g_pdf;
+  if (f == 0) { return 0; }
+  return (f * f) / (f * f + g * g);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 }  // namespace niepce
 /*
 // ---------------------------------------------------------------------------
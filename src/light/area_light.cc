@@ -6,7 +6,11 @@
  * @details 
  */
 #include "area_light.h"
+#include "light_bvh.h"
+#include "../core/utilities.h"
 #include "../core/attributes.h"
+#include "../core/intersection.h"
+#include "../core/ray.h"
 #include "../shape/shape.h"
 /*
 // ---------------------------------------------------------------------------
@@ -43,6 +47,32 @@ auto AreaLight::Emission () const noexcept -> Spectrum
 /*
 // ---------------------------------------------------------------------------
 */
+auto AreaLight::Power () const noexcept -> Spectrum
+{
+  if (shape_ == nullptr) { return Spectrum::Zero (); }
+  // Lambertian emission from both sides of the surface.
+  return emission_ * shape_->SurfaceArea () * 2 * kPi;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto AreaLight::Bounds () const noexcept -> LightBounds
+{
+  LightBounds bounds;
+  if (shape_ == nullptr) { return bounds; }
+
+  bounds.bounds = shape_->Bounds ();
+  shape_->NormalBounds (&bounds.axis, &bounds.cos_theta_o);
+  // Diffuse emission falls off to the tangent plane.
+  bounds.cos_theta_e = 0;
+  bounds.power       = RgbToMonochrome (Power ());
+  // Emission, Pdf () and the light sampling do not depend on the side.
+  bounds.two_sided   = true;
+  return bounds;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 auto AreaLight::Evaluate (Float* pdf) -> Spectrum
 {
   *pdf = 1.0 / shape_->SurfaceArea ();
@@ -58,6 +88,27 @@ auto AreaLight::Pdf () const noexcept -> Float
 /*
 // ---------------------------------------------------------------------------
 */
+auto AreaLight::Pdf (const Intersection& ref, const Vector3f& wi)
+  const noexcept -> Float
+{
+  if (shape_ == nullptr) { return 0; }
+
+  Intersection isect;
+  if (!shape_->IsIntersect (Ray (ref.Position (), wi), &isect)
+      || isect.Distance () <= 0)
+  {
+    return 0;
+  }
+
+  const auto cos_theta = std::fabs (Dot (isect.Normal (), -Normalize (wi)));
+  if (cos_theta == 0) { return 0; }
+
+  const auto distance = (isect.Position () - ref.Position ()).LengthSquared ();
+  return distance / (cos_theta * shape_->SurfaceArea ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 auto AreaLight::Sample
 (
  const Intersection& intersection,
@@ -18,6 +18,10 @@
 */
 namespace niepce
 {
+/*
+// ---------------------------------------------------------------------------
+*/
+struct LightBounds;
 //! ----------------------------------------------------------------------------
 //! @class AreaLight
 //! @brief
@@ -68,6 +72,24 @@ public:
    */
   auto Emission () const noexcept -> Spectrum override final;
 
+  /*!
+   * @fn Spectrum Power ()
+   * @brief Return the power emitted from both sides of the shape.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Power () const noexcept -> Spectrum override final;
+
+  /*!
+   * @fn LightBounds Bounds ()
+   * @brief Return the spatial and directional bounds of the emission.
+   * @return
+   * @exception none
+   * @details It is used to build the light BVH.
+   */
+  auto Bounds () const noexcept -> LightBounds;
+
   /*!
    * @fn Point3f SamplePosition (const)
    * @brief 
@@ -89,6 +111,19 @@ public:
    */
   auto Pdf () const noexcept -> Float override final;
 
+  /*!
+   * @fn Float Pdf (const Intersection&, const Vector3f&)
+   * @brief Return the density in solid angle measure to sample wi.
+   * @param[in] ref
+   * @param[in] wi
+   * @return
+   * @exception none
+   * @details The area density of uniform position sampling is converted to
+   *          the solid angle measure at the point where wi hits the shape.
+   */
+  auto Pdf (const Intersection& ref, const Vector3f& wi)
+    const noexcept -> Float override final;
+
   /*!
    * @fn Spectrum Evaluate (Float*)
    * @brief 
@@ -9,6 +9,9 @@
 #include "../core/transform.h"
 #include "../core/attributes.h"
 #include "../core/intersection.h"
+#include "../core/point2f.h"
+#include "../core/thread_pool.h"
+#include "../core/utilities.h"
 /*
 // ---------------------------------------------------------------------------
 */
@@ -22,9 +25,32 @@ InfiniteLight::InfiniteLight
  const Transform& light_to_world,
  const char* filename
 ) :
-  image_ (std::make_shared <ImageIO <Spectrum>> (filename))
+  image_          (std::make_shared <ImageIO <Spectrum>> (filename)),
+  light_to_world_ (light_to_world),
+  world_to_light_ (Inverse (light_to_world))
 {
-  // Todo : Transform matrix.
+  const int width  = image_->Width ();
+  const int height = image_->Height ();
+  if (width <= 0 || height <= 0) { return ; }
+
+  // Weight the luminance by sin (theta) to compensate the distortion of the
+  // lat-long mapping near the poles.
+  std::vector <Float> func (width * height);
+  ParallelFor (height, [&] (int begin, int end)
+  {
+    for (int y = begin; y < end; ++y)
+    {
+      const Float sin_theta = std::sin (kPi * (y + 0.5) / height);
+      for (int x = 0; x < width; ++x)
+      {
+        const auto l = RgbToMonochrome (image_->At (x, y));
+        func[y * width + x] = std::fmax (l, 0.0f) * sin_theta;
+      }
+    }
+  });
+  distribution_ = std::make_shared <Distribution2D> (func.data (),
+                                                     width,
+                                                     height);
 }
 /*
 // ---------------------------------------------------------------------------
@@ -36,11 +62,57 @@ auto InfiniteLight::Emission () const noexcept -> Spectrum
 /*
 // ---------------------------------------------------------------------------
 */
+auto InfiniteLight::Power () const noexcept -> Spectrum
+{
+  return Spectrum::Zero ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 auto InfiniteLight::SamplePosition (const Point2f &sample) const noexcept
   -> Point3f
 {
-  std::cerr << "InfiniteLight::SamplePosition was called." << std::endl;
-  return Point3f::Zero ();
+  Vector3f wi;
+  Float pdf = 0;
+  SampleDirection (sample, &wi, &pdf);
+  return Point3f::Zero () + wi;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto InfiniteLight::SampleDirection
+(
+ const Point2f& sample,
+ Vector3f*      wi,
+ Float*         pdf
+)
+  const noexcept -> Spectrum
+{
+  *pdf = 0;
+  if (distribution_ == nullptr) { return Spectrum::Zero (); }
+
+  // Sample a position on the image.
+  Float map_pdf = 0;
+  const auto uv = distribution_->SampleContinuous (sample, &map_pdf);
+  if (map_pdf == 0) { return Spectrum::Zero (); }
+
+  // Convert it to a direction.
+  const Float theta = uv[1] * kPi;
+  const Float phi   = uv[0] * 2.0 * kPi;
+  const Float sin_theta = std::sin (theta);
+  if (sin_theta == 0) { return Spectrum::Zero (); }
+
+  const Vector3f w (sin_theta * std::sin (phi),
+                    std::cos (theta),
+                    sin_theta * std::cos (phi));
+  *wi  = Normalize (light_to_world_ * w);
+
+  // Change of variables from the image to solid angle.
+  *pdf = map_pdf / (2.0 * kPi * kPi * sin_theta);
+
+  // Look up the sampled pixel itself, not the one of the direction, so
+  // that the radiance and pdf agree on the boundary of pixels.
+  return Lookup (uv);
 }
 /*
 // ---------------------------------------------------------------------------
@@ -48,32 +120,70 @@ auto InfiniteLight::SamplePosition (const Point2f &sample) const noexcept
 auto InfiniteLight::Evaluate (const Intersection &intersection, Float* pdf)
   const noexcept -> Spectrum
 {
-  // Get a ray
-  const auto& tmp = -intersection.Outgoing ();
+  // The direction toward the light.
+  const auto w = Normalize (world_to_light_ * -intersection.Outgoing ());
 
-  // Compute UV position of sphere.
-  const auto theta = std::acos (tmp.Y ());
-  auto phi = std::atan2 (tmp.X (), tmp.Z ());
-  if (phi < 0.0) { phi += 2.0 * kPi; }
-  const auto u = (phi / (2.0 * kPi));
-  const auto v = (theta / kPi);
-  const auto x = static_cast <int> ((image_->Width  () - 1) * u);
-  const auto y = static_cast <int> ((image_->Height () - 1) * v);
+  const auto uv = ToImage (w);
+  const auto l  = Lookup (uv);
 
-  if (theta == 0)
+  *pdf = 0;
+  const Float sin_theta = std::sin (uv[1] * kPi);
+  if (distribution_ != nullptr && sin_theta != 0)
   {
-    return Spectrum (0.0);
+    *pdf = distribution_->Pdf (uv) / (2.0 * kPi * kPi * sin_theta);
   }
-  *pdf = 1.0 / (2.0 * kPi * kPi * std::sin (theta));
-  return image_->At (x, y) * *pdf;
+  return l;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto InfiniteLight::Pdf (const Vector3f& wi) const noexcept -> Float
+{
+  if (distribution_ == nullptr) { return 0; }
+
+  const auto uv = ToImage (Normalize (world_to_light_ * wi));
+  const Float sin_theta = std::sin (uv[1] * kPi);
+  if (sin_theta == 0) { return 0; }
+  return distribution_->Pdf (uv) / (2.0 * kPi * kPi * sin_theta);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto InfiniteLight::Pdf (const Intersection& ref, const Vector3f& wi)
+  const noexcept -> Float
+{
+  return Pdf (wi);
 }
 /*
 // ---------------------------------------------------------------------------
 */
 auto InfiniteLight::Pdf () const noexcept -> Float
 {
-  std::cerr << "Error::InfiniteLight::Pdf was called." << std::endl;
-  return 1;
+  return 0;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto InfiniteLight::ToImage (const Vector3f& w) const noexcept -> Point2f
+{
+  // Compute UV position of sphere.
+  const Float theta = std::acos (Clamp (w.Y (), -1.0f, 1.0f));
+  Float phi = std::atan2 (w.X (), w.Z ());
+  if (phi < 0.0) { phi += 2.0 * kPi; }
+  return Point2f (phi / (2.0 * kPi), theta / kPi);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto InfiniteLight::Lookup (const Point2f& uv) const noexcept -> Spectrum
+{
+  const int width  = image_->Width ();
+  const int height = image_->Height ();
+  if (width <= 0 || height <= 0) { return Spectrum::Zero (); }
+
+  const auto x = Clamp (static_cast <int> (uv[0] * width),  0, width  - 1);
+  const auto y = Clamp (static_cast <int> (uv[1] * height), 0, height - 1);
+  return image_->At (x, y);
 }
 /*
 // ---------------------------------------------------------------------------
@@ -83,8 +193,9 @@ auto CreateInfiniteLight (const Attributes& attributes)
 {
   // Get filename.
   const auto& filename = attributes.FindString ("filename");
-  // Todo: support rotation.
-  return std::make_shared <InfiniteLight> (Transform (), filename.c_str ());
+  // Get the light to world transform. It is identity if not given.
+  const auto  transform = attributes.FindTransform ("transform");
+  return std::make_shared <InfiniteLight> (transform, filename.c_str ());
 }
 /*
 // ---------------------------------------------------------------------------
@@ -12,6 +12,8 @@
 */
 #include "../core/niepce.h"
 #include "../core/imageio.h"
+#include "../core/transform.h"
+#include "../sampler/distribution.h"
 #include "light.h"
 /*
 // ---------------------------------------------------------------------------
@@ -20,8 +22,9 @@ namespace niepce
 {
 //! ----------------------------------------------------------------------------
 //! @class InfiniteLight
-//! @brief
-//! @details
+//! @brief Environment light by a lat-long image.
+//! @details Directions are sampled by the piecewise-constant distribution
+//!          of the luminance of the image weighted by sin (theta).
 //! ----------------------------------------------------------------------------
 class InfiniteLight final : public Light
 {
@@ -60,25 +63,57 @@ public:
   auto Emission () const noexcept -> Spectrum override final;
 
   /*!
-   * @fn Point3f SamplePosition (const)
-   * @brief 
-   * @param[in] 
-   * @param[out] 
-   * @return 
+   * @fn Spectrum Power ()
+   * @brief
+   * @return
    * @exception none
-   * @details
+   * @details The infinite light is not chosen with area lights, so that it
+   *          returns zero.
+   */
+  auto Power () const noexcept -> Spectrum override final;
+
+  /*!
+   * @fn Point3f SamplePosition (const Point2f&)
+   * @brief Sample a direction and return it as a point on the unit sphere.
+   * @param[in] sample
+   * @return
+   * @exception none
+   * @details The infinite light has no position. Use SampleDirection ().
    */
   auto SamplePosition (const Point2f &sample)
     const noexcept -> Point3f override final;
 
   /*!
-   * @fn Spectrum Evaluate (const)
-   * @brief 
+   * @fn Spectrum SampleDirection (const Point2f&, Vector3f*, Float*)
+   * @brief Sample an incident direction in proportion to the radiance.
+   * @param[in] sample
+   *    The uniform distributed sample on [0, 1)^2.
+   * @param[out] wi
+   *    The direction toward the light in world coordinates.
+   * @param[out] pdf
+   *    The density in solid angle measure.
+   * @return The radiance arriving from wi.
+   * @exception none
+   * @details
+   */
+  auto SampleDirection
+  (
+   const Point2f& sample,
+   Vector3f*      wi,
+   Float*         pdf
+  )
+    const noexcept -> Spectrum;
+
+  /*!
+   * @fn Spectrum Evaluate (const Intersection&, Float*)
+   * @brief Return the radiance arriving at the intersection.
    * @param[in] intersection
-   *    
-   * @return 
+   *    The intersection whose outgoing direction is the reversed ray.
+   * @param[out] pdf
+   *    The density that SampleDirection () samples the direction.
+   * @return
    * @exception none
-   * @details 
+   * @details
    */
   auto Evaluate
   (
@@ -87,18 +122,64 @@ public:
   )
     const noexcept -> Spectrum;
 
+  /*!
+   * @fn Float Pdf (const Vector3f&)
+   * @brief Return the density in solid angle measure to sample the direction.
+   * @param[in] wi
+   *    The direction toward the light in world coordinates.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Pdf (const Vector3f& wi) const noexcept -> Float;
+
+  /*!
+   * @fn Float Pdf (const Intersection&, const Vector3f&)
+   * @brief Return the density in solid angle measure to sample wi.
+   * @param[in] ref
+   * @param[in] wi
+   * @return
+   * @exception none
+   * @details Same as Pdf (wi), since the light is infinitely far away.
+   */
+  auto Pdf (const Intersection& ref, const Vector3f& wi)
+    const noexcept -> Float override final;
+
   /*!
    * @fn Float Pdf ()
-   * @brief 
-   * @return 
+   * @brief
+   * @return Always zero, since there is no area. Use Pdf (wi).
    * @exception none
-   * @details 
+   * @details
    */
   auto Pdf () const noexcept -> Float override final;
 
+private:
+  /*!
+   * @fn Point2f ToImage (const Vector3f&)
+   * @brief Map the direction in light coordinates to the image.
+   * @param[in] w
+   * @return The position on the image in [0, 1)^2.
+   * @exception none
+   * @details
+   */
+  auto ToImage (const Vector3f& w) const noexcept -> Point2f;
+
+  /*!
+   * @fn Spectrum Lookup (const Point2f&)
+   * @brief Return the radiance of the position on the image.
+   * @param[in] uv
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Lookup (const Point2f& uv) const noexcept -> Spectrum;
 
 private:
   std::shared_ptr <ImageIO <Spectrum>> image_;
+  std::shared_ptr <Distribution2D>     distribution_;
+  Transform light_to_world_;
+  Transform world_to_light_;
 }; // class InfiniteLight
 /*
 // ---------------------------------------------------------------------------
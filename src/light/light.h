@@ -63,6 +63,15 @@ public:
    */
   virtual auto Emission () const noexcept -> Spectrum = 0;
 
+  /*!
+   * @fn Spectrum Power ()
+   * @brief Return the total power emitted by the light.
+   * @return
+   * @exception none
+   * @details It is used to choose lights in proportion to their power.
+   */
+  virtual auto Power () const noexcept -> Spectrum = 0;
+
   /*!
    * @fn Point3f SamplePosition (const Point2f&)
    * @brief 
@@ -84,6 +93,21 @@ public:
    */
   virtual auto Pdf () const noexcept -> Float = 0;
 
+  /*!
+   * @fn Float Pdf (const Intersection&, const Vector3f&)
+   * @brief Return the density to sample the direction from the point.
+   * @param[in] ref
+   *    The intersection to be lit.
+   * @param[in] wi
+   *    The direction toward the light in world coordinates.
+   * @return The density in solid angle measure, zero if wi misses the light.
+   * @exception none
+   * @details It is used to weight the paths which hit the light by BSDF
+   *          sampling against the next event estimation.
+   */
+  virtual auto Pdf (const Intersection& ref, const Vector3f& wi)
+    const noexcept -> Float = 0;
+
 protected:
 
 }; // class Light
@@ -0,0 +1,432 @@
+/*!
+ * @file light_bvh.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "light_bvh.h"
+#include "area_light.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+static constexpr int kNumBuckets = 12;
+// Trails are 64 bits. Deep subtrees are split in the middle to keep them
+// balanced within the limit.
+static constexpr int kMaxSaohDepth = 40;
+/*
+// ---------------------------------------------------------------------------
+*/
+inline auto SafeSqrt (Float x) -> Float
+{
+  return std::sqrt (std::fmax (0.0f, x));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+inline auto SafeAcos (Float x) -> Float
+{
+  return std::acos (Clamp (x, -1.0f, 1.0f));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// cos (max (0, a - b))
+inline auto CosSubClamped
+(
+ Float sin_a, Float cos_a,
+ Float sin_b, Float cos_b
+)
+  -> Float
+{
+  if (cos_a > cos_b) { return 1; }
+  return cos_a * cos_b + sin_a * sin_b;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// sin (max (0, a - b))
+inline auto SinSubClamped
+(
+ Float sin_a, Float cos_a,
+ Float sin_b, Float cos_b
+)
+  -> Float
+{
+  if (cos_a > cos_b) { return 0; }
+  return sin_a * cos_b - cos_a * sin_b;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Rotate v around the unit axis k by theta. (Rodrigues' rotation formula)
+inline auto Rotate (const Vector3f& v, const Vector3f& k, Float theta)
+  -> Vector3f
+{
+  const Float c = std::cos (theta);
+  const Float s = std::sin (theta);
+  return v * c + Cross (k, v) * s + k * (Dot (k, v) * (1 - c));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// The solid angle measure of the orientation bounds used in the SAOH.
+inline auto OrientationMeasure (const LightBounds& b) -> Float
+{
+  const Float theta_o = SafeAcos (b.cos_theta_o);
+  const Float theta_e = SafeAcos (b.cos_theta_e);
+  const Float theta_w = std::fmin (theta_o + theta_e, kPi);
+  const Float sin_o   = std::sin (theta_o);
+  return 2 * kPi * (1 - b.cos_theta_o)
+       + kPi / 2 * (2 * theta_w * sin_o - std::cos (theta_o - 2 * theta_w)
+                    - 2 * theta_o * sin_o + b.cos_theta_o);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SplitCost (const LightBounds& b, const Bounds3f& parent, int axis)
+  -> Float
+{
+  // Penalize thin splits along the short axis of the parent.
+  const auto d = parent.Diagonal ();
+  const Float max_extent = std::fmax (d.X (), std::fmax (d.Y (), d.Z ()));
+  const Float kr = d[axis] > 0 ? max_extent / d[axis] : 0;
+  return b.power * OrientationMeasure (b) * b.bounds.SurfaceArea () * kr;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+auto LightBounds::Importance (const Point3f& p, const Vector3f& n)
+  const noexcept -> Float
+{
+  // Distance to the center, clamped by the size of the bounds so that the
+  // importance doesn't diverge for points inside of them.
+  const Point3f  pc = bounds.Center ();
+  const Vector3f d  = p - pc;
+  const Float    r  = bounds.Diagonal ().Length () * 0.5;
+  const Float    d2 = std::fmax (d.LengthSquared (), r);
+
+  const Vector3f wi = d.LengthSquared () > 0 ? Normalize (d) : axis;
+  Float cos_theta_w = Dot (axis, wi);
+  if (two_sided) { cos_theta_w = std::fabs (cos_theta_w); }
+  const Float sin_theta_w = SafeSqrt (1 - cos_theta_w * cos_theta_w);
+
+  // The angle subtended by the bounding sphere from p.
+  Float cos_theta_b = -1;
+  if (d.LengthSquared () > r * r)
+  {
+    const Float sin2 = r * r / d.LengthSquared ();
+    cos_theta_b = SafeSqrt (1 - sin2);
+  }
+  const Float sin_theta_b = SafeSqrt (1 - cos_theta_b * cos_theta_b);
+
+  // theta' = max (0, theta_w - theta_o - theta_b)
+  const Float sin_theta_o = SafeSqrt (1 - cos_theta_o * cos_theta_o);
+  const Float cos_theta_x = CosSubClamped (sin_theta_w, cos_theta_w,
+                                           sin_theta_o, cos_theta_o);
+  const Float sin_theta_x = SinSubClamped (sin_theta_w, cos_theta_w,
+                                           sin_theta_o, cos_theta_o);
+  const Float cos_theta_p = CosSubClamped (sin_theta_x, cos_theta_x,
+                                           sin_theta_b, cos_theta_b);
+  if (cos_theta_p <= cos_theta_e) { return 0; }
+
+  Float importance = power * cos_theta_p / d2;
+
+  // Bound the cosine at the receiver.
+  if (n.LengthSquared () > 0)
+  {
+    const Float cos_theta_i = std::fabs (Dot (wi, n));
+    const Float sin_theta_i = SafeSqrt (1 - cos_theta_i * cos_theta_i);
+    importance *= CosSubClamped (sin_theta_i, cos_theta_i,
+                                 sin_theta_b, cos_theta_b);
+  }
+  return std::fmax (importance, 0.0f);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Union (const LightBounds& lhs, const LightBounds& rhs) -> LightBounds
+{
+  if (lhs.power == 0) { return rhs; }
+  if (rhs.power == 0) { return lhs; }
+
+  LightBounds res;
+  res.bounds      = Union (lhs.bounds, rhs.bounds);
+  res.cos_theta_e = std::fmin (lhs.cos_theta_e, rhs.cos_theta_e);
+  res.power       = lhs.power + rhs.power;
+  res.two_sided   = lhs.two_sided || rhs.two_sided;
+
+  // Merge the orientation cones.
+  const Float theta_a = SafeAcos (lhs.cos_theta_o);
+  const Float theta_b = SafeAcos (rhs.cos_theta_o);
+  const Float theta_d = SafeAcos (Dot (lhs.axis, rhs.axis));
+  if (std::fmin (theta_d + theta_b, kPi) <= theta_a)
+  {
+    res.axis        = lhs.axis;
+    res.cos_theta_o = lhs.cos_theta_o;
+    return res;
+  }
+  if (std::fmin (theta_d + theta_a, kPi) <= theta_b)
+  {
+    res.axis        = rhs.axis;
+    res.cos_theta_o = rhs.cos_theta_o;
+    return res;
+  }
+
+  const Float theta_o = (theta_a + theta_d + theta_b) * 0.5;
+  const Vector3f wr   = Cross (lhs.axis, rhs.axis);
+  if (theta_o >= kPi || wr.LengthSquared () == 0)
+  {
+    res.axis        = lhs.axis;
+    res.cos_theta_o = -1;
+    return res;
+  }
+  res.axis        = Normalize (Rotate (lhs.axis, Normalize (wr),
+                                       theta_o - theta_a));
+  res.cos_theta_o = std::cos (theta_o);
+  return res;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+LightBvh::LightBvh (const std::vector <std::shared_ptr <Light>>& lights)
+{
+  std::vector <std::pair <int, LightBounds>> bounded;
+  for (std::size_t i = 0; i < lights.size (); ++i)
+  {
+    // Only area lights have spatial bounds.
+    const auto light = std::dynamic_pointer_cast <AreaLight> (lights[i]);
+    if (light == nullptr) { continue; }
+
+    const auto b = light->Bounds ();
+    if (b.power > 0) { bounded.push_back (std::make_pair (i, b)); }
+  }
+  if (bounded.empty ()) { return ; }
+
+  nodes_.reserve (2 * bounded.size () - 1);
+  RecursiveBuild (&bounded, 0, bounded.size (), 0, 0);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto LightBvh::Sample
+(
+ const Point3f&  p,
+ const Vector3f& n,
+ Float           sample,
+ Float*          pdf,
+ Float*          remapped
+)
+  const noexcept -> int
+{
+  *pdf = 0;
+  if (nodes_.empty ()) { return -1; }
+
+  int   node_idx = 0;
+  Float pmf      = 1;
+  Float u        = sample;
+  while (true)
+  {
+    const auto& node = nodes_[node_idx];
+    if (node.is_leaf)
+    {
+      // The root can be a leaf that doesn't illuminate the point.
+      if (node_idx == 0 && node.bounds.Importance (p, n) == 0) { return -1; }
+      *pdf = pmf;
+      if (remapped) { *remapped = u; }
+      return node.index;
+    }
+
+    // Choose a child in proportion to its importance.
+    const Float c0 = nodes_[node_idx + 1].bounds.Importance (p, n);
+    const Float c1 = nodes_[node.index].bounds.Importance (p, n);
+    if (c0 == 0 && c1 == 0) { return -1; }
+
+    const Float p0 = c0 / (c0 + c1);
+    if (u < p0)
+    {
+      u        = std::fmin (u / p0, 1.0f - kEpsilon);
+      pmf     *= p0;
+      node_idx = node_idx + 1;
+    }
+    else
+    {
+      u        = std::fmin ((u - p0) / (1 - p0), 1.0f - kEpsilon);
+      pmf     *= 1 - p0;
+      node_idx = node.index;
+    }
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto LightBvh::Pdf (const Point3f& p, const Vector3f& n, int idx)
+  const noexcept -> Float
+{
+  const auto found = trails_.find (idx);
+  if (found == trails_.end ()) { return 0; }
+
+  // Follow the trail from the root to the leaf of the light.
+  uint64_t trail    = found->second;
+  int      node_idx = 0;
+  Float    pmf      = 1;
+  while (!nodes_[node_idx].is_leaf)
+  {
+    const auto& node = nodes_[node_idx];
+    const Float c0 = nodes_[node_idx + 1].bounds.Importance (p, n);
+    const Float c1 = nodes_[node.index].bounds.Importance (p, n);
+    if (c0 == 0 && c1 == 0) { return 0; }
+
+    if (trail & 1)
+    {
+      pmf     *= c1 / (c0 + c1);
+      node_idx = node.index;
+    }
+    else
+    {
+      pmf     *= c0 / (c0 + c1);
+      node_idx = node_idx + 1;
+    }
+    trail >>= 1;
+  }
+  if (node_idx == 0 && nodes_[0].bounds.Importance (p, n) == 0) { return 0; }
+  return pmf;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto LightBvh::NumNodes () const noexcept -> std::size_t
+{
+  return nodes_.size ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto LightBvh::RecursiveBuild
+(
+ std::vector <std::pair <int, LightBounds>>* lights,
+ int      begin,
+ int      end,
+ uint64_t trail,
+ int      depth
+)
+  -> int
+{
+  const int node_idx = nodes_.size ();
+  nodes_.push_back (Node ());
+
+  // Create a leaf.
+  if (end - begin == 1)
+  {
+    const auto& light = (*lights)[begin];
+    nodes_[node_idx].bounds  = light.second;
+    nodes_[node_idx].index   = light.first;
+    nodes_[node_idx].is_leaf = true;
+    trails_[light.first] = trail;
+    return node_idx;
+  }
+
+  // Compute the bounds of lights and their centroids.
+  LightBounds all   = (*lights)[begin].second;
+  Bounds3f centroid ((*lights)[begin].second.bounds.Center (),
+                     (*lights)[begin].second.bounds.Center ());
+  for (int i = begin + 1; i < end; ++i)
+  {
+    all = Union (all, (*lights)[i].second);
+    centroid.Merge ((*lights)[i].second.bounds.Center ());
+  }
+
+  // Find the split that minimizes the surface area orientation heuristic.
+  Float min_cost  = kInfinity;
+  int   min_axis  = -1;
+  int   min_split = -1;
+  if (depth < kMaxSaohDepth)
+  {
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      const Float cmin   = centroid.Min ()[axis];
+      const Float extent = centroid.Max ()[axis] - cmin;
+      if (extent == 0) { continue; }
+
+      std::array <LightBounds, kNumBuckets> buckets;
+      for (int i = begin; i < end; ++i)
+      {
+        const auto& lb = (*lights)[i].second;
+        int b = kNumBuckets * ((lb.bounds.Center ()[axis] - cmin) / extent);
+        b = Clamp (b, 0, kNumBuckets - 1);
+        buckets[b] = Union (buckets[b], lb);
+      }
+
+      for (int split = 0; split < kNumBuckets - 1; ++split)
+      {
+        LightBounds below, above;
+        for (int i = 0; i <= split; ++i) { below = Union (below, buckets[i]); }
+        for (int i = split + 1; i < kNumBuckets; ++i)
+        {
+          above = Union (above, buckets[i]);
+        }
+        if (below.power == 0 || above.power == 0) { continue; }
+
+        const Float cost = SplitCost (below, all.bounds, axis)
+                         + SplitCost (above, all.bounds, axis);
+        if (cost < min_cost)
+        {
+          min_cost  = cost;
+          min_axis  = axis;
+          min_split = split;
+        }
+      }
+    }
+  }
+
+  // Partition lights. Fall back to the middle if no split was found.
+  int mid = (begin + end) / 2;
+  if (min_axis != -1)
+  {
+    const Float cmin   = centroid.Min ()[min_axis];
+    const Float extent = centroid.Max ()[min_axis] - cmin;
+    const auto  last   = std::partition
+      (lights->begin () + begin, lights->begin () + end,
+       [=] (const std::pair <int, LightBounds>& l)
+       {
+         int b = kNumBuckets * ((l.second.bounds.Center ()[min_axis] - cmin)
+                                / extent);
+         b = Clamp (b, 0, kNumBuckets - 1);
+         return b <= min_split;
+       });
+    mid = last - lights->begin ();
+    if (mid == begin || mid == end) { mid = (begin + end) / 2; }
+  }
+
+  // The first child follows this node.
+  RecursiveBuild (lights, begin, mid, trail, depth + 1);
+  const int second = RecursiveBuild (lights, mid, end,
+                                     trail | (uint64_t (1) << depth),
+                                     depth + 1);
+
+  nodes_[node_idx].bounds  = all;
+  nodes_[node_idx].index   = second;
+  nodes_[node_idx].is_leaf = false;
+  return node_idx;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,186 @@
+/*!
+ * @file light_bvh.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _LIGHT_BVH_H_
+#define _LIGHT_BVH_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "../core/niepce.h"
+#include "../core/bounds3f.h"
+#include "../core/point3f.h"
+#include "../core/vector3f.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+//! ----------------------------------------------------------------------------
+//! @struct LightBounds
+//! @brief Spatial and directional bounds of emitters.
+//! @details The emission is bounded by the cone around the axis whose spread
+//!          is theta_o, plus theta_e that emission falls off outside of it.
+//! ----------------------------------------------------------------------------
+struct LightBounds
+{
+  Bounds3f bounds;
+  Vector3f axis        = Vector3f (0, 0, 1);
+  Float    cos_theta_o = 1;
+  Float    cos_theta_e = 1;
+  Float    power       = 0;
+  bool     two_sided   = false;
+
+  /*!
+   * @fn Float Importance (const Point3f&, const Vector3f&)
+   * @brief Estimate the contribution of the bounded lights to a point.
+   * @param[in] p
+   *    The position of the shading point.
+   * @param[in] n
+   *    The normal of the shading point. Zero vector disables the cosine
+   *    bound at the receiver.
+   * @return Conservative importance, zero if the lights never reach p.
+   * @exception none
+   * @details
+   */
+  auto Importance (const Point3f& p, const Vector3f& n) const noexcept -> Float;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Union (const LightBounds& lhs, const LightBounds& rhs) -> LightBounds;
+//! ----------------------------------------------------------------------------
+//! @class LightBvh
+//! @brief Light hierarchy to choose a light with respect to a shading point.
+//! @details Each node stores bounds, an orientation cone and the power of the
+//!          lights below it. A light is chosen by traversing the tree
+//!          stochastically in proportion to the importance of each child, so
+//!          that nearby lights facing to the point are chosen more often.
+//! ----------------------------------------------------------------------------
+class LightBvh
+{
+public:
+  //! The default class constructor.
+  LightBvh () = default;
+
+  //! The constructor takes lights of the scene.
+  LightBvh (const std::vector <std::shared_ptr <Light>>& lights);
+
+  //! The copy constructor of the class.
+  LightBvh (const LightBvh& bvh) = default;
+
+  //! The move constructor of the class.
+  LightBvh (LightBvh&& bvh) = default;
+
+  //! The default class destructor.
+  virtual ~LightBvh () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const LightBvh& bvh) -> LightBvh& = default;
+
+  //! The move assignment operator of the class.
+  auto operator = (LightBvh&& bvh) -> LightBvh& = default;
+
+public:
+  /*!
+   * @fn int Sample (const Point3f&, const Vector3f&, Float, Float*, Float*)
+   * @brief Choose a light for the shading point.
+   * @param[in] p
+   *    The position of the shading point.
+   * @param[in] n
+   *    The normal of the shading point.
+   * @param[in] sample
+   *    The uniform distributed sample on [0, 1).
+   * @param[out] pdf
+   *    The probability to choose the returned light.
+   * @param[out] remapped
+   *    The sample remapped to [0, 1) so that it can be reused.
+   * @return The index of the light, or -1 if no light reach the point.
+   * @exception none
+   * @details
+   */
+  auto Sample
+  (
+   const Point3f&  p,
+   const Vector3f& n,
+   Float           sample,
+   Float*          pdf,
+   Float*          remapped
+  )
+    const noexcept -> int;
+
+  /*!
+   * @fn Float Pdf (const Point3f&, const Vector3f&, int)
+   * @brief Return the probability that Sample () chooses the light.
+   * @param[in] p
+   * @param[in] n
+   * @param[in] idx
+   *    The index of the light.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Pdf (const Point3f& p, const Vector3f& n, int idx)
+    const noexcept -> Float;
+
+  /*!
+   * @fn std::size_t NumNodes ()
+   * @brief
+   * @return
+   * @exception none
+   * @details
+   */
+  auto NumNodes () const noexcept -> std::size_t;
+
+private:
+  struct Node
+  {
+    LightBounds bounds;
+    // Leaf     : index of the light.
+    // Interior : index of the second child. The first one follows the node.
+    int  index   = -1;
+    bool is_leaf = false;
+  };
+
+  /*!
+   * @fn int RecursiveBuild ()
+   * @brief
+   * @param[in] lights
+   *    Pairs of light index and its bounds.
+   * @param[in] begin
+   * @param[in] end
+   * @param[in] trail
+   *    Bits of the path from the root. 1 means the second child.
+   * @param[in] depth
+   * @return The index of the created node.
+   * @exception none
+   * @details
+   */
+  auto RecursiveBuild
+  (
+   std::vector <std::pair <int, LightBounds>>* lights,
+   int      begin,
+   int      end,
+   uint64_t trail,
+   int      depth
+  )
+    -> int;
+
+private:
+  std::vector <Node> nodes_;
+
+  // Key   : Index of light
+  // Value : Bits of the path from the root to the leaf.
+  std::unordered_map <int, uint64_t> trails_;
+}; // class LightBvh
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _LIGHT_BVH_H_
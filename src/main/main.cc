@@ -9,6 +9,7 @@
 #include "../core/image.h"
 #include "../core/imageio.h"
 #include "../core/stop_watch.h"
+#include "../core/profiler.h"
 #include "../texture/image_texture.h"
 #include "../core/utilities.h"
 #include "../bsdf/microfacet_reflection.h"
@@ -24,6 +25,7 @@
 #include "../camera/pinhole.h"
 #include "../texture/value_texture.h"
 #include "../scene/scene_importer.h"
+#include "../scene/mesh_loader.h"
 #include "../core/attributes.h"
 #include "../bsdf/bsdf_record.h"
 #include "../bsdf/bsdf.h"
@@ -42,15 +44,23 @@ auto Initialize () -> void
 {
   auto& stop_watch = Singleton <StopWatch>::Instance ();
   stop_watch.Start ();
+
+  // The total time of the profiler starts here.
+  Singleton <Profiler>::Instance ();
 }
 /*
 // ---------------------------------------------------------------------------
 */
-auto Finalize () -> void
+auto Finalize (const char* scene) -> void
 {
   auto& stop_watch = Singleton <StopWatch>::Instance ();
   auto time = stop_watch.Stop ();
   std::cout << time.ToString () << std::endl;
+
+  // The report of the stages, and its summary for tracking regressions.
+  auto& profiler = Singleton <Profiler>::Instance ();
+  profiler.Report (std::cout);
+  profiler.WriteJson ("profile.json", scene);
   SingletonFinalizer::Finalize ();
 }
 /*
@@ -62,17 +72,31 @@ auto Finalize () -> void
 */
 int main (int argc, char* argv[])
 {
+  // Convert the meshes into their caches, which the renders map later.
+  if (argc > 2 && std::string (argv[1]) == "--mesh-cache")
+  {
+    bool converted = true;
+    for (int i = 2; i < argc; ++i)
+    {
+      converted = niepce::ConvertMesh (argv[i]) && converted;
+    }
+    return converted ? 0 : 1;
+  }
+
   niepce::Initialize ();
+  std::unique_ptr <niepce::ProfileScope> import_scope
+    (new niepce::ProfileScope ("import"));
   niepce::SceneImporter importer (argv[1]);
   auto settings = importer.ExtractRenderSettings ();
   auto scene    = importer.ExtractScene ();
   auto camera   = importer.ExtractCamera ();
+  import_scope.reset ();
 
   std::cout << "Start rendering" << std::endl;
   niepce::PathTracer pt (settings, scene, camera);
   pt.Render ();
 
-  niepce::Finalize ();
+  niepce::Finalize (argv[1]);
 
   return 0;
 }
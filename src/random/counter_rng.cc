@@ -0,0 +1,170 @@
+/*!
+ * @file counter_rng.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "counter_rng.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+// The increment of SplitMix64, 2^64 / golden ratio.
+constexpr uint64_t kGamma = 0x9e3779b97f4a7c15;
+/*
+// ---------------------------------------------------------------------------
+*/
+// 32 bits hash of Wellons (lowbias32). It needs only 32 bits multiplies, so
+// that four of them run in a SSE register.
+inline auto Lowbias32 (uint32_t x) -> uint32_t
+{
+  x ^= x >> 16;
+  x *= 0x7feb352d;
+  x ^= x >> 15;
+  x *= 0x846ca68b;
+  x ^= x >> 16;
+  return x;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// The float in [1, 2) of the upper 23 bits as the mantissa, minus 1. It is
+// exactly below 1 without a division.
+inline auto ToFloat01 (uint32_t x) -> Float
+{
+  const uint32_t bits = (x >> 9) | 0x3f800000u;
+  float f;
+  std::memcpy (&f, &bits, sizeof (f));
+  return f - 1.0f;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+#ifdef NIEPCE_USE_SIMD
+inline auto Lowbias32 (__m128i x) -> __m128i
+{
+  x = _mm_xor_si128   (x, _mm_srli_epi32 (x, 16));
+  x = _mm_mullo_epi32 (x, _mm_set1_epi32 (0x7feb352d));
+  x = _mm_xor_si128   (x, _mm_srli_epi32 (x, 15));
+  x = _mm_mullo_epi32 (x, _mm_set1_epi32 (0x846ca68b));
+  x = _mm_xor_si128   (x, _mm_srli_epi32 (x, 16));
+  return x;
+}
+#endif // NIEPCE_USE_SIMD
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+auto MixBits64 (uint64_t v) noexcept -> uint64_t
+{
+  v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9;
+  v = (v ^ (v >> 27)) * 0x94d049bb133111eb;
+  return v ^ (v >> 31);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto HashKey (uint64_t key, uint64_t value) noexcept -> uint64_t
+{
+  return MixBits64 (key ^ MixBits64 (value + kGamma));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+CounterRng::CounterRng (uint64_t key) :
+  key_ (key)
+{}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto CounterRng::SetKey (uint64_t key, uint32_t counter) noexcept -> void
+{
+  key_         = key;
+  counter_     = counter;
+  block_valid_ = false;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto CounterRng::SetCounter (uint32_t counter) noexcept -> void
+{
+  counter_ = counter;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto CounterRng::Next () noexcept -> uint32_t
+{
+  return At (key_, counter_++);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto CounterRng::Next01 () noexcept -> Float
+{
+  // Generate the block which contains the counter.
+  const uint32_t offset = counter_ - block_counter_;
+  if (!block_valid_ || offset >= kBlockSize)
+  {
+    block_counter_ = counter_ & ~(kBlockSize - 1);
+    block_valid_   = true;
+    Fill01 (key_, block_counter_, block_.data ());
+  }
+  return block_[counter_++ - block_counter_];
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto CounterRng::At (uint64_t key, uint32_t counter) noexcept -> uint32_t
+{
+  // Two rounds keyed by each half of the key.
+  const auto k0 = static_cast <uint32_t> (key);
+  const auto k1 = static_cast <uint32_t> (key >> 32);
+  return Lowbias32 (Lowbias32 (counter + k0) ^ k1);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto CounterRng::Fill01 (uint64_t key, uint32_t counter, Float* values)
+  noexcept -> void
+{
+#ifdef NIEPCE_USE_SIMD
+  const auto k1  = _mm_set1_epi32 (static_cast <int> (key >> 32));
+  const auto one = _mm_set1_epi32 (0x3f800000);
+  const auto k0  = counter + static_cast <uint32_t> (key);
+  auto c = _mm_add_epi32 (_mm_set1_epi32 (k0), _mm_setr_epi32 (0, 1, 2, 3));
+  for (uint32_t i = 0; i < kBlockSize; i += 4)
+  {
+    const auto x = Lowbias32 (_mm_xor_si128 (Lowbias32 (c), k1));
+    const auto f = _mm_castsi128_ps
+      (_mm_or_si128 (_mm_srli_epi32 (x, 9), one));
+    _mm_store_ps (values + i, _mm_sub_ps (f, _mm_set1_ps (1.0f)));
+    c = _mm_add_epi32 (c, _mm_set1_epi32 (4));
+  }
+#else
+  for (uint32_t i = 0; i < kBlockSize; ++i)
+  {
+    values[i] = ToFloat01 (At (key, counter + i));
+  }
+#endif // NIEPCE_USE_SIMD
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
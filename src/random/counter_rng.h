@@ -0,0 +1,162 @@
+/*!
+ * @file counter_rng.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _COUNTER_RNG_H_
+#define _COUNTER_RNG_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "../core/niepce.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn uint64_t MixBits64 (uint64_t)
+ * @brief The finalizer of SplitMix64.
+ * @param[in] v
+ * @return
+ * @exception none
+ * @details Every bit of the input affects every bit of the output.
+ */
+auto MixBits64 (uint64_t v) noexcept -> uint64_t;
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn uint64_t HashKey (uint64_t, uint64_t)
+ * @brief Combine the key with the value.
+ * @param[in] key
+ * @param[in] value
+ * @return
+ * @exception none
+ * @details
+ */
+auto HashKey (uint64_t key, uint64_t value) noexcept -> uint64_t;
+//! ----------------------------------------------------------------------------
+//! @class CounterRng
+//! @brief Counter-based random number generator.
+//! @details The n-th number is the hash of the key and n, so that it does
+//!          not depend on what is drawn before. A key derived from the pixel
+//!          and the sample index gives the same stream regardless of the
+//!          thread or the tile which draws it. Floats are generated in
+//!          blocks of kBlockSize numbers at once, by SSE if available.
+//! ----------------------------------------------------------------------------
+class CounterRng
+{
+public:
+  //! The number of floats generated at once.
+  static constexpr uint32_t kBlockSize = 8;
+
+public:
+  //! The default class constructor.
+  CounterRng () = default;
+
+  //! The constructor takes the key of the stream.
+  CounterRng (uint64_t key);
+
+  //! The copy constructor of the class.
+  CounterRng (const CounterRng& rng) = default;
+
+  //! The move constructor of the class.
+  CounterRng (CounterRng&& rng) = default;
+
+  //! The default class destructor.
+  virtual ~CounterRng () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const CounterRng& rng) -> CounterRng& = default;
+
+  //! The move assignment operator of the class.
+  auto operator = (CounterRng&& rng) -> CounterRng& = default;
+
+public:
+  /*!
+   * @fn void SetKey (uint64_t, uint32_t)
+   * @brief Start the stream of the key from the counter.
+   * @param[in] key
+   * @param[in] counter
+   * @return
+   * @exception none
+   * @details
+   */
+  auto SetKey (uint64_t key, uint32_t counter = 0) noexcept -> void;
+
+  /*!
+   * @fn void SetCounter (uint32_t)
+   * @brief Jump to the number of the stream.
+   * @param[in] counter
+   * @return
+   * @exception none
+   * @details
+   */
+  auto SetCounter (uint32_t counter) noexcept -> void;
+
+  /*!
+   * @fn uint32_t Next ()
+   * @brief Return the integer in [0, 2^32).
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Next () noexcept -> uint32_t;
+
+  /*!
+   * @fn Float Next01 ()
+   * @brief Return the random number in [0, 1).
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Next01 () noexcept -> Float;
+
+  /*!
+   * @fn uint32_t At (uint64_t, uint32_t)
+   * @brief Return the number of the stream at the counter.
+   * @param[in] key
+   * @param[in] counter
+   * @return
+   * @exception none
+   * @details
+   */
+  static auto At (uint64_t key, uint32_t counter) noexcept -> uint32_t;
+
+  /*!
+   * @fn void Fill01 (uint64_t, uint32_t, Float*)
+   * @brief Write kBlockSize floats in [0, 1) of the stream from the counter.
+   * @param[in] key
+   * @param[in] counter
+   * @param[out] values
+   *    16 bytes aligned.
+   * @return
+   * @exception none
+   * @details values[i] is the float of At (key, counter + i).
+   */
+  static auto Fill01 (uint64_t key, uint32_t counter, Float* values)
+    noexcept -> void;
+
+private:
+  uint64_t key_     = 0;
+  uint32_t counter_ = 0;
+
+  // The floats of the block which starts from block_counter_.
+  ALIGN16 std::array <Float, kBlockSize> block_;
+  uint32_t block_counter_ = 0;
+  bool     block_valid_ = false;
+}; // class CounterRng
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _COUNTER_RNG_H_
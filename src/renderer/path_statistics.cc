@@ -0,0 +1,167 @@
+/*!
+ * @file path_statistics.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "path_statistics.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+// The resolution of the sums. It leaves room for 2^43 in total.
+constexpr double kFixedScale = 1 << 20;
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ToFixed (Float value) noexcept -> int64_t
+{
+  return std::llround (value * kFixedScale);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PathStatistics::Vertex
+(
+ unsigned int depth,
+ Float        throughput,
+ Float        contribution
+)
+  noexcept -> void
+{
+  Resize (depth);
+  if (depth > 0)
+  {
+    contributions_[depth_] += ToFixed (contribution - contribution_);
+  }
+  ++paths_[depth];
+  throughputs_[depth] += ToFixed (throughput);
+
+  depth_        = depth;
+  contribution_ = contribution;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PathStatistics::Terminate (Float contribution) noexcept -> void
+{
+  Resize (depth_);
+  contributions_[depth_] += ToFixed (contribution - contribution_);
+
+  depth_        = 0;
+  contribution_ = 0;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PathStatistics::Merge (const PathStatistics& statistics) noexcept -> void
+{
+  if (statistics.paths_.empty ()) { return; }
+  Resize (statistics.paths_.size () - 1);
+  for (std::size_t i = 0; i < statistics.paths_.size (); ++i)
+  {
+    paths_[i]         += statistics.paths_[i];
+    throughputs_[i]   += statistics.throughputs_[i];
+    contributions_[i] += statistics.contributions_[i];
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PathStatistics::SurvivalScales
+(
+ unsigned int min_depth,
+ unsigned int max_depth
+)
+  const noexcept -> std::vector <Float>
+{
+  // The scale never goes below this, so that every depth can survive.
+  static constexpr Float    kMinScale = 0.1;
+  // The number of paths to trust the counters of a depth.
+  static constexpr uint64_t kMinPaths = 4096;
+
+  std::vector <Float> scales (max_depth + 1, 1);
+  if (min_depth >= paths_.size () || paths_[min_depth] < kMinPaths)
+  {
+    return scales;
+  }
+
+  // Contribution expected from the unit throughput at each depth.
+  std::vector <double> expected (paths_.size (), 0);
+  int64_t remaining = 0;
+  for (int d = static_cast <int> (paths_.size ()) - 1; d >= 0; --d)
+  {
+    remaining += contributions_[d];
+    if (throughputs_[d] > 0)
+    {
+      expected[d] = static_cast <double> (remaining) / throughputs_[d];
+    }
+  }
+  if (expected[min_depth] == 0) { return scales; }
+
+  for (unsigned int d = min_depth; d < paths_.size () && d <= max_depth; ++d)
+  {
+    if (paths_[d] < kMinPaths) { break; }
+    scales[d] = std::max (static_cast <Float> (expected[d]
+                                               / expected[min_depth]),
+                          kMinScale);
+  }
+  return scales;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PathStatistics::NumPaths (unsigned int depth) const noexcept -> uint64_t
+{
+  return depth < paths_.size () ? paths_[depth] : 0;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PathStatistics::ToString () const noexcept -> std::string
+{
+  std::ostringstream oss;
+  oss << "Depth         Paths  Contribution\n";
+  double total = 0;
+  for (const auto& c : contributions_) { total += static_cast <double> (c); }
+  for (std::size_t d = 0; d < paths_.size (); ++d)
+  {
+    const auto ratio = total > 0 ? contributions_[d] / total * 100.0 : 0.0;
+    oss << std::setw (5)  << d
+        << std::setw (14) << paths_[d]
+        << std::setw (13) << std::fixed << std::setprecision (2) << ratio
+        << " %\n";
+  }
+  return oss.str ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PathStatistics::Resize (unsigned int depth) noexcept -> void
+{
+  if (depth < paths_.size ()) { return; }
+  paths_.resize         (depth + 1, 0);
+  throughputs_.resize   (depth + 1, 0);
+  contributions_.resize (depth + 1, 0);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,143 @@
+/*!
+ * @file path_statistics.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _PATH_STATISTICS_H_
+#define _PATH_STATISTICS_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "../core/niepce.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+//! ----------------------------------------------------------------------------
+//! @class PathStatistics
+//! @brief Per-depth counters of traced paths.
+//! @details It records how many paths reach each depth, their throughput and
+//!          the contribution added at the depth, so that the work spent on
+//!          deep bounces can be compared with what they add to the image.
+//!          The sums are kept in fixed point, so that merging gives the same
+//!          counters in any order and for any split of the paths.
+//!          It is not thread safe. Each tile owns one and merges it.
+//! ----------------------------------------------------------------------------
+class PathStatistics
+{
+public:
+  //! The default class constructor.
+  PathStatistics () = default;
+
+  //! The copy constructor of the class.
+  PathStatistics (const PathStatistics& statistics) = default;
+
+  //! The move constructor of the class.
+  PathStatistics (PathStatistics&& statistics) = default;
+
+  //! The default class destructor.
+  virtual ~PathStatistics () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const PathStatistics& statistics)
+    -> PathStatistics& = default;
+
+  //! The move assignment operator of the class.
+  auto operator = (PathStatistics&& statistics) -> PathStatistics& = default;
+
+public:
+  /*!
+   * @fn void Vertex (unsigned int, Float, Float)
+   * @brief Record that the path reached the depth.
+   * @param[in] depth
+   * @param[in] throughput
+   *    The luminance of the throughput of the path at the depth.
+   * @param[in] contribution
+   *    The luminance of the contribution accumulated so far.
+   * @return
+   * @exception none
+   * @details The contribution gained since the previous vertex is attributed
+   *          to the previous depth.
+   */
+  auto Vertex (unsigned int depth, Float throughput, Float contribution)
+    noexcept -> void;
+
+  /*!
+   * @fn void Terminate (Float)
+   * @brief Record the end of the path.
+   * @param[in] contribution
+   *    The luminance of the radiance of the path.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Terminate (Float contribution) noexcept -> void;
+
+  /*!
+   * @fn void Merge (const PathStatistics&)
+   * @brief Add the counters of the other statistics.
+   * @param[in] statistics
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Merge (const PathStatistics& statistics) noexcept -> void;
+
+  /*!
+   * @fn std::vector <Float> SurvivalScales (unsigned int, unsigned int)
+   * @brief Return the scale of the survival probability of each depth.
+   * @param[in] min_depth
+   *    The depth from which Russian roulette starts.
+   * @param[in] max_depth
+   * @return
+   * @exception none
+   * @details The scale is the contribution expected from a unit throughput
+   *          at the depth, relative to the one at min_depth. Depths which
+   *          have added little to the image for their throughput are
+   *          terminated more often. It is 1 until enough paths are recorded.
+   */
+  auto SurvivalScales (unsigned int min_depth, unsigned int max_depth)
+    const noexcept -> std::vector <Float>;
+
+  /*!
+   * @fn uint64_t NumPaths (unsigned int)
+   * @brief Return the number of paths which reached the depth.
+   * @param[in] depth
+   * @return
+   * @exception none
+   * @details
+   */
+  auto NumPaths (unsigned int depth) const noexcept -> uint64_t;
+
+  /*!
+   * @fn std::string ToString ()
+   * @brief Return the table of the counters of each depth.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto ToString () const noexcept -> std::string;
+
+private:
+  auto Resize (unsigned int depth) noexcept -> void;
+
+private:
+  std::vector <uint64_t> paths_;
+  std::vector <int64_t>  throughputs_;    // In units of 1 / kFixedScale.
+  std::vector <int64_t>  contributions_;  // In units of 1 / kFixedScale.
+
+  // The state of the path being traced.
+  unsigned int depth_        = 0;
+  Float        contribution_ = 0;
+}; // class PathStatistics
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _PATH_STATISTICS_H_
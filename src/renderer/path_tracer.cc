@@ -22,8 +22,12 @@
 #include "../light/area_light.h"
 #include "../core/stop_watch.h"
 #include "../light/infinite_light.h"
-#include "../sampler/hammersley.h"
-#include "../sampler/low_discrepancy_sequence.h"
+#include "../sampler/sampler.h"
+#include "../core/utilities.h"
+#include "../core/thread_pool.h"
+#include "../core/profiler.h"
+#include "../core/ray_counters.h"
+#include "../core/tracer.h"
 /*
 // ---------------------------------------------------------------------------
 */
@@ -32,6 +36,51 @@ namespace niepce
 /*
 // ---------------------------------------------------------------------------
 */
+namespace
+{
+// Dimensions of the sampler for the film and the lens.
+constexpr int kCameraDimensions = 4;
+// Dimensions of the sampler for the BSDF, the light, the infinite light and
+// Russian roulette at each depth.
+constexpr int kDepthDimensions  = 7;
+// The events kept by each thread for the trace. The oldest are overwritten
+// when a thread runs more tasks.
+constexpr std::size_t kTraceEventsPerThread = 1 << 16;
+// The interval of the progress line.
+constexpr std::chrono::milliseconds kProgressInterval (500);
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PrintProgress
+(
+ const RayCount& count,
+ uint64_t        num_samples,
+ double          seconds
+)
+  -> void
+{
+  const auto done  = static_cast <double> (count.camera_rays) / num_samples;
+  const auto per_s = seconds > 0 ? 1e-6 / seconds : 0.0;
+  std::cerr << std::fixed << std::setprecision (1)
+            << "\r" << std::setw (5) << done * 100.0 << " %  "
+            << std::setprecision (2)
+            << std::setw (8) << count.Rays () * per_s << " Mrays/s  "
+            << std::setw (8) << count.camera_rays * per_s << " Msamples/s  ";
+  if (done > 0)
+  {
+    std::cerr << "ETA " << std::setprecision (1)
+              << seconds * (1.0 - done) / done << " s";
+  }
+  std::cerr << "        " << std::flush;
+  std::cerr.unsetf (std::ios::floatfield);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
 PathTracer::PathTracer
 (
  const RenderSettings           &settings,
@@ -50,149 +99,452 @@ auto PathTracer::Render () -> void
   const int num_rounds  = settings_.GetItem (RenderSettings::Item::kNumRound);
   const int tile_width  = settings_.GetItem (RenderSettings::Item::kTileWidth);
   const int tile_height = settings_.GetItem (RenderSettings::Item::kTileHeight);
-  std::vector <FilmTile> tiles;
 
   const auto &resolution = camera_->FilmResolution ();
-  const auto &width  = resolution.Width ();
-  const auto &height = resolution.Height ();
+  const int width  = static_cast <int> (resolution.Width  ());
+  const int height = static_cast <int> (resolution.Height ());
+
+  const auto film = static_cast <FilmAccumulation>
+    (settings_.GetItem (RenderSettings::Item::kFilm));
+  const bool keep_film
+    = settings_.GetItem (RenderSettings::Item::kKeepFilm) != 0;
+  camera_->PrepareFilm (film, tile_width, tile_height, keep_film);
+
+  // The denoiser needs the whole film in memory.
+  const auto requested = settings_.GetItem (RenderSettings::Item::kAovs);
+  auto denoiser = static_cast <DenoiserType>
+    (settings_.GetItem (RenderSettings::Item::kDenoiser));
+  if (denoiser != DenoiserType::kNone && film == FilmAccumulation::kStream)
+  {
+    std::cerr << "The denoiser is disabled for the streamed film."
+              << std::endl;
+    denoiser = DenoiserType::kNone;
+  }
+  auto aovs = requested;
+  if (denoiser != DenoiserType::kNone)
+  {
+    aovs |= AovBit (Aov::kAlbedo) | AovBit (Aov::kNormal)
+          | AovBit (Aov::kDepth);
+  }
 
-  std::vector <std::shared_ptr <RandomSampler>> samplers;
-  for (int y = 0; y < height; y += tile_height)
+  // Choose the groups of AOVs which the samples record.
+  aov_groups_ = 0;
+  if (aovs != 0)
   {
-    for (int x = 0; x < width; x += tile_width)
-    {
-      const int last_x = x + tile_width  >= width  ? width  : x + tile_width;
-      const int last_y = y + tile_height >= height ? height : y + tile_height;
-      const Bounds2f tile (Point2f (x, y), Point2f (last_x, last_y));
-      tiles.push_back (FilmTile (y * height + x, tile));
-      samplers.push_back (std::make_shared <RandomSampler> (last_y + last_x));
-    }
+    aovs_.reset (new AovBuffer (width, height, aovs));
+    const auto first_hit = AovBit (Aov::kAlbedo) | AovBit (Aov::kNormal)
+                         | AovBit (Aov::kDepth)  | AovBit (Aov::kPrimitiveId)
+                         | AovBit (Aov::kMaterialId);
+    const auto split = AovBit (Aov::kDirect) | AovBit (Aov::kIndirect);
+    aov_groups_ = kAovRecord;
+    if (aovs & first_hit)           { aov_groups_ |= kAovFirstHit; }
+    if (aovs & split)               { aov_groups_ |= kAovSplit;    }
+    if (aovs & AovBit (Aov::kTime)) { aov_groups_ |= kAovTime;     }
+  }
+
+  // One long running task per thread takes tiles from the scheduler. The
+  // streamed film finishes a tile before starting others, so that few tiles
+  // are in memory.
+  const int threads = settings_.GetItem (RenderSettings::Item::kNumThread);
+  const int num_workers = threads > 0
+    ? threads : std::max (1u, std::thread::hardware_concurrency ());
+  TileScheduler scheduler (width, height, tile_width, tile_height,
+                           num_rounds, num_workers,
+                           film == FilmAccumulation::kStream);
+
+  // Only the tile accumulation keeps every tile. Others allocate the pixels
+  // of a tile while it is rendered, or never.
+  std::vector <FilmTile> tiles;
+  for (int i = 0; i < scheduler.NumTiles (); ++i)
+  {
+    tiles.push_back (FilmTile (i, scheduler.TileBounds (i)));
+    if (film != FilmAccumulation::kTile) { tiles.back ().ReleaseTileImage (); }
   }
+  tile_statistics_.assign (scheduler.NumTiles (),
+                           std::vector <PathStatistics> (num_rounds));
+
+  // Each task has its own sampler. Samples are derived from the pixel and
+  // the sample index, so that every task shares the seed.
+  const auto type = static_cast <SamplerType>
+    (settings_.GetItem (RenderSettings::Item::kSampler));
+  const auto &spp = settings_.GetItem (RenderSettings::Item::kNumSamples);
+  std::vector <std::unique_ptr <Sampler>> samplers (num_workers);
+
+  if (kCostHeatmap) { cost_heatmap_.reset (new CostHeatmap (width, height)); }
+
+  // Only the tile film keeps the number of rounds of each tile. Others
+  // divide the whole film by the number of samples of every round.
+  const auto time_limit = settings_.GetItem (RenderSettings::Item::kTimeLimit);
+  deadline_ = std::chrono::steady_clock::time_point::max ();
+  if (time_limit > 0 && film != FilmAccumulation::kTile)
+  {
+    std::cerr << "The time limit is disabled except for the tile film."
+              << std::endl;
+  }
+  else if (time_limit > 0)
+  {
+    deadline_ = std::chrono::steady_clock::now ()
+              + std::chrono::milliseconds (time_limit);
+  }
+
+  const bool trace = settings_.GetItem (RenderSettings::Item::kTrace) != 0;
+  if (trace) { Singleton <Tracer>::Instance ().Enable (kTraceEventsPerThread); }
 
   // Register tasks.
-  ThreadPool& tasks = Singleton <ThreadPool>::Instance ();
-  std::vector <std::future <void>> futures (tiles.size () * num_rounds);
-  for (int round = 1, idx = 0; round <= num_rounds; ++round)
   {
-    // Render each tile.
-    for (int i = 0; i < tiles.size (); ++i)
+    ProfileScope scope ("render");
+    ThreadPool& tasks = Singleton <ThreadPool>::Instance ();
+    std::vector <std::future <void>> futures (num_workers);
+    const auto start = std::chrono::steady_clock::now ();
+    const auto first = Singleton <RayCounters>::Instance ().Sum ();
+    for (int i = 0; i < num_workers; ++i)
     {
-      auto func = std::bind (&PathTracer::RenderTileBounds,
+      samplers[i] = CreateSampler (type, spp, 0);
+      auto func = std::bind (&PathTracer::RenderTiles,
                              this,
                              std::placeholders::_1,
                              std::placeholders::_2,
                              std::placeholders::_3);
-      futures[idx++] = tasks.Enqueue (func,
-                                      round,
-                                      &tiles[i],
-                                      samplers[i].get ());
+      futures[i] = tasks.Enqueue (func, &scheduler, &tiles,
+                                  samplers[i].get ());
+    }
+
+    // Show progressing while the tasks run.
+    const auto num_samples
+      = static_cast <uint64_t> (width) * height * spp * num_rounds;
+    const auto progress = [&] () -> RayCount
+    {
+      const auto count = Singleton <RayCounters>::Instance ().Sum () - first;
+      const auto seconds = std::chrono::duration <double>
+        (std::chrono::steady_clock::now () - start).count ();
+      PrintProgress (count, num_samples, seconds);
+      return count;
+    };
+    for (auto& f : futures)
+    {
+      while (f.wait_for (kProgressInterval) != std::future_status::ready)
+      {
+        progress ();
+      }
     }
+    const auto count = progress ();
+    std::cerr << std::endl;
+    std::cout << count.ToString (std::chrono::duration <double>
+                                 (std::chrono::steady_clock::now () - start)
+                                 .count ())
+              << std::flush;
   }
 
-  const auto &spp = settings_.GetItem (RenderSettings::Item::kNumSamples);
-  int round = 0;
-  for (int i = 0; i < futures.size (); ++i)
+  // Final process, save result.
+  if (film == FilmAccumulation::kAtomic)
+  {
+    camera_->ResolveFilm (spp * num_rounds, true);
+  }
+  if (aovs_)
+  {
+    aovs_->Resolve ();
+    if (denoiser != DenoiserType::kNone)
+    {
+      ProfileScope scope ("denoise");
+      camera_->DenoiseFilm (*aovs_);
+    }
+    aovs_->SaveAs ("output", requested);
+  }
+  camera_->FinalProcess (num_rounds);
+  if (kCostHeatmap) { cost_heatmap_->SaveAs ("output"); }
+  if (trace)
+  {
+    Singleton <Tracer>::Instance ().WriteChromeTrace ("trace.json");
+  }
+
+  std::cout << statistics_.ToString () << std::flush;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PathTracer::RenderTiles
+(
+ TileScheduler*          scheduler,
+ std::vector <FilmTile>* tiles,
+ Sampler*                sampler
+)
+  noexcept -> void
+{
+  const int spp = settings_.GetItem (RenderSettings::Item::kNumSamples);
+  const int num_rounds = settings_.GetItem (RenderSettings::Item::kNumRound);
+  const auto film = static_cast <FilmAccumulation>
+    (settings_.GetItem (RenderSettings::Item::kFilm));
+  const bool atomic = film == FilmAccumulation::kAtomic;
+  const bool stream = film == FilmAccumulation::kStream;
+  const auto render_tile_bounds = SelectRenderTileBounds (aov_groups_);
+
+  // The tasks run on the pool, so that the stage of each round is named
+  // under the render stage of the main thread.
+  std::vector <std::string> round_stages;
+  for (int i = 1; i <= num_rounds; ++i)
+  {
+    round_stages.push_back ("render/round " + std::to_string (i));
+  }
+
+  TileTask task;
+  while (scheduler->Next (&task))
   {
-    // Show progressing.
-    std::cerr << (float)i / futures.size () * 100.0 << "   %             \r";
+    // Leave the task when the time is up. The film keeps the rounds which
+    // the tiles have finished.
+    if (std::chrono::steady_clock::now () >= deadline_)
+    {
+      scheduler->Stop ();
+      break;
+    }
 
-    round = i / tiles.size () + 1;
+    auto& tile = (*tiles)[task.tile];
+    if (stream && task.round == 1)
+    {
+      // Halves of the tile may start at the same time.
+      std::lock_guard <std::mutex> lock (film_mutex_);
+      if (!tile.HasTileImage ()) { tile.AllocateTileImage (); }
+    }
+    {
+      ProfileScope scope (round_stages[task.round - 1]);
+      (this->*render_tile_bounds) (task, &tile, sampler);
+    }
 
-    // Waiting for rendering of a tile.
-    futures[i].wait ();
+    bool round_finished = false;
+    if (!scheduler->Finish (task, &round_finished)) { continue; }
 
-    // Save image
-    if (i % tiles.size () == 0 && round != 1)
+    // The streamed tile leaves memory after its last round.
+    if (stream && task.round == num_rounds)
     {
-      camera_->SaveSequence (round, spp * (round));
+      camera_->FlushFilmTile (tile, spp * num_rounds);
+      tile.ReleaseTileImage ();
     }
 
-    // Update film.
-    camera_->UpdateFilmTile (tiles[i % tiles.size ()], round);
-  }
+    // The tile has finished the round. Other tiles may be in other rounds,
+    // so that the film keeps the average of each tile.
+    {
+      std::lock_guard <std::mutex> lock (film_mutex_);
+      if (film == FilmAccumulation::kTile)
+      {
+        camera_->UpdateFilmTile (tile, spp * task.round);
+      }
+      if (round_finished && task.round < num_rounds)
+      {
+        if (atomic) { camera_->ResolveFilm (spp * task.round, false); }
+        camera_->SaveSequence (task.round);
+      }
+    }
 
-  // Final process, save result.
-  camera_->FinalProcess (round, spp * (round));
+    // The next round adds to the tile, so that it starts after the copy.
+    scheduler->QueueNextRound (task);
+  }
 }
 /*
 // ---------------------------------------------------------------------------
 */
+auto PathTracer::SelectRenderTileBounds (unsigned int groups)
+  noexcept -> RenderTileFunction
+{
+  switch (groups)
+  {
+    case kAovRecord :
+      return &PathTracer::RenderTileBounds <kAovRecord>;
+    case kAovRecord | kAovFirstHit :
+      return &PathTracer::RenderTileBounds <kAovRecord | kAovFirstHit>;
+    case kAovRecord | kAovSplit :
+      return &PathTracer::RenderTileBounds <kAovRecord | kAovSplit>;
+    case kAovRecord | kAovTime :
+      return &PathTracer::RenderTileBounds <kAovRecord | kAovTime>;
+    case kAovRecord | kAovFirstHit | kAovSplit :
+      return &PathTracer::RenderTileBounds
+        <kAovRecord | kAovFirstHit | kAovSplit>;
+    case kAovRecord | kAovFirstHit | kAovTime :
+      return &PathTracer::RenderTileBounds
+        <kAovRecord | kAovFirstHit | kAovTime>;
+    case kAovRecord | kAovSplit | kAovTime :
+      return &PathTracer::RenderTileBounds
+        <kAovRecord | kAovSplit | kAovTime>;
+    case kAovRecord | kAovFirstHit | kAovSplit | kAovTime :
+      return &PathTracer::RenderTileBounds
+        <kAovRecord | kAovFirstHit | kAovSplit | kAovTime>;
+    default :
+      return &PathTracer::RenderTileBounds <0>;
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+template <unsigned int kGroups>
 auto PathTracer::RenderTileBounds
 (
- int            round,
- FilmTile*      tile,
- RandomSampler* tile_sampler
+ const TileTask& task,
+ FilmTile*       tile,
+ Sampler*        tile_sampler
 )
   noexcept -> void
 {
-  // const int  spp = settings_.GetItem (RenderSettings::kNumSamples);
+  TraceScope trace ("tile", task.tile, task.round);
+
   const int spp = settings_.GetItem (RenderSettings::Item::kNumSamples);
-  const auto tile_bounds = tile->Bounds ();
-  const auto begin_y = static_cast <int> (tile_bounds.Min ().Y ());
-  const auto end_y   = static_cast <int> (tile_bounds.Max ().Y ());
-  const auto begin_x = static_cast <int> (tile_bounds.Min ().X ());
-  const auto end_x   = static_cast <int> (tile_bounds.Max ().X ());
+  const auto round   = task.round;
+  const auto begin_y = task.begin_y;
+  const auto end_y   = task.end_y;
+  const auto begin_x = task.begin_x;
+  const auto end_x   = task.end_x;
+  const auto tile_x  = static_cast <int> (tile->Min ().X ());
+  const auto tile_y  = static_cast <int> (tile->Min ().Y ());
+  const bool atomic  = static_cast <FilmAccumulation>
+    (settings_.GetItem (RenderSettings::Item::kFilm))
+    == FilmAccumulation::kAtomic;
+
+  // Take the survival scales learned by the previous rounds of the tile.
+  // They have finished before this round starts, so that the scales do not
+  // depend on the number of workers or on the order that tiles finish in.
+  const auto max_depth = settings_.GetItem (RenderSettings::Item::kPTMaxDepth);
+  const auto min_depth
+    = settings_.GetItem (RenderSettings::Item::kRouletteDepth);
+  std::vector <Float> survival_scales;
+  {
+    std::lock_guard <std::mutex> lock (statistics_mutex_);
+    PathStatistics learned;
+    for (int i = 0; i < round - 1; ++i)
+    {
+      learned.Merge (tile_statistics_[task.tile][i]);
+    }
+    survival_scales = learned.SurvivalScales (min_depth, max_depth);
+  }
+  PathStatistics statistics;
+  auto& counters = ThreadRayCounters ();
 
-  for (int s = round * spp; s < round * spp + spp; ++s)
+  for (int s = (round - 1) * spp; s < round * spp; ++s)
   {
     for (int y = begin_y; y < end_y; ++y)
     {
       for (int x = begin_x; x < end_x; ++x)
       {
-        // TODO : Use better sampling.
+        std::chrono::steady_clock::time_point start;
+        if ((kGroups & kAovTime) != 0 || kCostHeatmap)
+        {
+          start = std::chrono::steady_clock::now ();
+        }
+        if (kCostHeatmap) { ThreadPixelCost () = PixelCost (); }
+        tile_sampler->StartPixelSample (x, y, s);
+
         Ray ray;
         Float weight = 0;
-        const auto offset = Point2f ((Float)s / (round * spp),
-                                     RadicalInverse (2, s));
-        // const auto pfilm  = Point2f (x, y) + offset;
-        const auto pfilm  = Point2f (x, y) + tile_sampler->SamplePoint2f ();
+        const auto pfilm  = Point2f (x, y) + tile_sampler->Next2f ();
         while (weight == 0)
         {
-          const auto plens  = tile_sampler->SamplePoint2f ();
+          const auto plens  = tile_sampler->Next2f ();
           const auto cs     = CameraSample (pfilm, plens);
           weight = camera_->GenerateRay (cs, &ray);
         }
+        Increase (counters.camera_rays);
 
         Spectrum radiance;
-        auto hit = Radiance (ray, tile_sampler, &radiance);
-        if (hit)
+        AovSample aov;
+        auto hit = Radiance <kGroups & (kAovFirstHit | kAovSplit)>
+          (ray, tile_sampler, survival_scales, &radiance, &statistics, &aov);
+        statistics.Terminate (RgbToMonochrome (radiance));
+        if ((kGroups & kAovTime) != 0)
+        {
+          aov.time = std::chrono::duration <Float>
+            (std::chrono::steady_clock::now () - start).count ();
+        }
+        if (kCostHeatmap)
+        {
+          auto& cost = ThreadPixelCost ();
+          cost.nanoseconds = std::chrono::duration_cast
+            <std::chrono::nanoseconds>
+            (std::chrono::steady_clock::now () - start).count ();
+          cost_heatmap_->AddSample (x, y, cost);
+        }
+        if ((kGroups & kAovRecord) != 0)
         {
-          auto s = tile->At (x - begin_x, y - begin_y) + radiance;
-          tile->SetValueAt (x - begin_x, y - begin_y, s);
+          aovs_->AddSample (x, y, aov);
+        }
+        if (atomic)
+        {
+          // Every sample has the weight, even if it missed the scene.
+          camera_->AddSample (x, y, hit ? radiance : Spectrum (0));
+        }
+        else if (hit)
+        {
+          auto s = tile->At (x - tile_x, y - tile_y) + radiance;
+          tile->SetValueAt (x - tile_x, y - tile_y, s);
         }
       }
     }
   }
+
+  // The parts of a split task merge in any order, since the sums are exact.
+  std::lock_guard <std::mutex> lock (statistics_mutex_);
+  tile_statistics_[task.tile][round - 1].Merge (statistics);
+  statistics_.Merge (statistics);
 }
 /*
 // ---------------------------------------------------------------------------
 */
+template <unsigned int kGroups>
 auto PathTracer::Radiance
 (
- const Ray     &first_ray,
- RandomSampler *tile_sampler,
- Spectrum      *radiance
+ const Ray                 &first_ray,
+ Sampler                   *tile_sampler,
+ const std::vector <Float> &survival_scales,
+ Spectrum                  *radiance,
+ PathStatistics            *statistics,
+ AovSample                 *aov
 )
   -> bool
 {
   Spectrum contribution = Spectrum (0);
   Spectrum weight = Spectrum (1);
 
+  // Emission reached by more than one bounce, and the light sampled from
+  // the second or later vertices.
+  Spectrum indirect = Spectrum (0);
+
   Ray ray (first_ray);
 
   MemoryArena memory;
+  auto& counters = ThreadRayCounters ();
 
   const auto kMaxDepth = settings_.GetItem (RenderSettings::Item::kPTMaxDepth);
+  const auto mis = static_cast <MisHeuristic>
+    (settings_.GetItem (RenderSettings::Item::kMis));
+  const auto roulette = static_cast <RussianRoulette>
+    (settings_.GetItem (RenderSettings::Item::kRoulette));
+  const auto roulette_depth
+    = settings_.GetItem (RenderSettings::Item::kRouletteDepth);
+
+  // The last vertex and the pdf of BSDF sampling from it, to weight the path
+  // which reaches a light against the light sampling.
+  Intersection previous;
+  Float bsdf_pdf  = 0;
+  bool  specular  = true;
 
   // Render the tile.
   for (unsigned int depth = 0; depth < kMaxDepth; ++depth)
   {
+    statistics->Vertex (depth,
+                        RgbToMonochrome (weight),
+                        RgbToMonochrome (contribution));
+    if (kCostHeatmap) { ++ThreadPixelCost ().bounces; }
+
+    // Take the samples of this depth in the fixed order, so that each use
+    // has the same dimensions even if some of them are skipped.
+    tile_sampler->StartDimension (kCameraDimensions + depth * kDepthDimensions);
+    const auto bsdf_sample     = tile_sampler->Next2f ();
+    const auto light_sample    = tile_sampler->Next2f ();
+    const auto env_sample      = tile_sampler->Next2f ();
+    const auto roulette_sample = tile_sampler->Next1f ();
+
     // -------------------------------------------------------------------------
     // Intersection test
     // -------------------------------------------------------------------------
 
     // Intersect test.
     Intersection intersection;
+    if (depth > 0) { Increase (counters.extension_rays); }
     if (!scene_->IsIntersect (ray, &intersection))
     {
       // No intersection found.
@@ -205,13 +557,19 @@ auto PathTracer::Radiance
       // HACKME:
       intersection.SetOutgoing (-ray.Direction ());
 
-      // Sample infinite light.
+      // Sample infinite light. It is weighted against the light sampling
+      // unless the direction was chosen by specular reflection.
       const auto& inf_light = scene_->InfiniteLight ();
-      if (inf_light != nullptr)
+      if (inf_light != nullptr && (specular || mis != MisHeuristic::kNone))
       {
         Float pdf = 0;
         const auto s = inf_light->Evaluate (intersection, &pdf);
-        contribution = contribution + weight * s;
+        const auto w = specular ? 1 : PowerHeuristic (1, bsdf_pdf, 1, pdf);
+        contribution = contribution + weight * s * w;
+        if ((kGroups & kAovSplit) != 0)
+        {
+          if (depth >= 2) { indirect = indirect + weight * s * w; }
+        }
       }
       *radiance = contribution;
       break;
@@ -221,24 +579,59 @@ auto PathTracer::Radiance
     // contribution = Normalize ((Spectrum (1) + intersection.Normal()) * 0.5);
     // break;
 
-    // If ray hit with light.
-    // break soon.
+    if ((kGroups & kAovFirstHit) != 0)
+    {
+      if (depth == 0)
+      {
+        aov->normal = intersection.HasShadingNormal ()
+                    ? intersection.ShadingNormal ()
+                    : intersection.Normal ();
+        aov->depth  = intersection.Distance ();
+        aov->primitive_id
+          = scene_->PrimitiveIndex (intersection.Primitive ().get ());
+        aov->material_id
+          = scene_->MaterialIndex (intersection.Material ().get ());
+      }
+    }
+
+    // If ray hit with light, add the emission weighted against the light
+    // sampling at the last vertex.
     const auto& primitive = intersection.Primitive ();
-    if (primitive->HasLight ())
+    if (primitive->HasLight ()
+        && (specular || mis != MisHeuristic::kNone))
     {
-      // Hit light
-      contribution = contribution + weight
-                   * primitive->Light ()->Emission ();
-      break;
+      const auto& light = primitive->Light ();
+      Float w = 1;
+      if (!specular)
+      {
+        const auto light_pdf = LightPdf (previous, *light, ray.Direction ());
+        w = PowerHeuristic (1, bsdf_pdf, 1, light_pdf);
+      }
+      contribution = contribution + weight * light->Emission () * w;
+      if ((kGroups & kAovSplit) != 0)
+      {
+        if (depth >= 2)
+        {
+          indirect = indirect + weight * light->Emission () * w;
+        }
+      }
     }
 
     // Generate BSDF.
-    auto bsdf = intersection.Material ()->AllocateBsdfs (intersection, &memory);
     const auto& material = intersection.Material ();
+    if (material == nullptr) { break; }
+    auto bsdf = material->AllocateBsdfs (intersection, &memory);
     if (material->HasEmission ())
     {
       contribution = contribution + weight
                    * material->Emission (intersection);
+      if ((kGroups & kAovSplit) != 0)
+      {
+        if (depth >= 2)
+        {
+          indirect = indirect + weight * material->Emission (intersection);
+        }
+      }
     }
 
     // -------------------------------------------------------------------------
@@ -249,10 +642,20 @@ auto PathTracer::Radiance
     bsdf_record.SetSamplingTarget (niepce::Bxdf::Type::kAll);
     bsdf_record.SetOutgoing (-ray.Direction (), bsdf::Coordinate::kWorld);
 
-    const auto f = bsdf->Sample (&bsdf_record, tile_sampler->SamplePoint2f ());
+    const auto f = bsdf->Sample (&bsdf_record, bsdf_sample);
 
     if (bsdf_record.Pdf () == 0) { break; }
 
+    // The weight of the BSDF sample estimates the albedo.
+    if ((kGroups & kAovFirstHit) != 0)
+    {
+      if (depth == 0)
+      {
+        aov->albedo = bsdf_record.Bsdf () * bsdf_record.CosWeight ()
+                    / bsdf_record.Pdf ();
+      }
+    }
+
     // -------------------------------------------------------------------------
     // Next event estimation
     // -------------------------------------------------------------------------
@@ -260,12 +663,31 @@ auto PathTracer::Radiance
          & Bsdf::Type (Bsdf::Type::kSpecular)) != Bsdf::Type::kSpecular)
     {
       const auto value = DirectSampleOneLight (intersection,
-                                               tile_sampler->SamplePoint2f());
-      if (value != Spectrum::Zero ())
+                                               *bsdf,
+                                               -ray.Direction (),
+                                               light_sample);
+      contribution = contribution + weight * value;
+      if ((kGroups & kAovSplit) != 0)
       {
-        contribution = contribution + weight * bsdf_record.Bsdf () * value;
+        if (depth >= 1) { indirect = indirect + weight * value; }
+      }
+
+      if (scene_->InfiniteLight () != nullptr)
+      {
+        const auto env = DirectSampleInfiniteLight (intersection,
+                                                    *bsdf,
+                                                    -ray.Direction (),
+                                                    env_sample);
+        contribution = contribution + weight * env;
+        if ((kGroups & kAovSplit) != 0)
+        {
+          if (depth >= 1) { indirect = indirect + weight * env; }
+        }
       }
     }
+    previous = intersection;
+    bsdf_pdf = bsdf_record.Pdf ();
+    specular = (bsdf_record.SampledType () & Bsdf::Type::kSpecular) != 0;
 
     // Update the weight.
     weight = weight * bsdf_record.Bsdf () * bsdf_record.CosWeight ()
@@ -274,15 +696,18 @@ auto PathTracer::Radiance
     // -------------------------------------------------------------------------
     // Russian roulette
     // -------------------------------------------------------------------------
-    /*
-    Float q = std::fmax (contribution[0],
-                         std::fmax(contribution[1], contribution[2]));
-    if (kMaxDepth - 3 > depth)
+    // Decide whether the path reaches the next depth by its throughput.
+    if (roulette != RussianRoulette::kNone && depth + 1 >= roulette_depth)
     {
-      if (tile_sampler->SampleFloat () >= q) { break; }
+      Float q = RgbToMonochrome (weight);
+      if (roulette == RussianRoulette::kEfficiency)
+      {
+        q *= survival_scales[depth + 1];
+      }
+      q = std::min (q, static_cast <Float> (1));
+      if (roulette_sample >= q) { break; }
+      weight = weight / q;
     }
-    else { q = 1.0; }
-    */
 
     // -------------------------------------------------------------------------
     // Ready to trace the incident direction.
@@ -293,6 +718,11 @@ auto PathTracer::Radiance
   }
 
   *radiance = contribution;
+  if ((kGroups & kAovSplit) != 0)
+  {
+    aov->direct   = contribution - indirect;
+    aov->indirect = indirect;
+  }
   return true;
 }
 /*
@@ -301,32 +731,52 @@ auto PathTracer::Radiance
 auto PathTracer::DirectSampleOneLight
 (
  const Intersection& isect,
+ const Bsdf&         bsdf,
+ const Vector3f&     outgoing,
  const Point2f&      sample
 )
   const noexcept -> Spectrum
 {
-  // Choose one light in the scene.
-  const auto num_lights = scene_->NumLight ();
-  if (num_lights == 0)
+  // Choose one light by the strategy of the settings.
+  const auto strategy = static_cast <LightSampling>
+    (settings_.GetItem (RenderSettings::Item::kLightSampling));
+  Float light_pdf = 0;
+  Float remapped  = 0;
+  const auto idx = scene_->SampleLight (isect,
+                                        sample[0],
+                                        strategy,
+                                        &light_pdf,
+                                        &remapped);
+  if (idx < 0 || light_pdf == 0)
   {
     return Spectrum (0);
   }
-
-  auto idx = num_lights * sample[0];
-  if (idx >= scene_->NumLight ()) { idx = scene_->NumLight () - 1; }
   const auto &light = scene_->Light (idx);
 
-  // Sample a position on the light.
-  const auto target = light->SamplePosition (sample);
+  // Sample a position on the light. sample[0] is remapped since it was used.
+  const auto target = light->SamplePosition (Point2f (remapped, sample[1]));
 
   // Get intersection point.
   const auto &ori = isect.Position ();
 
   // Create shadow ray.
   const Ray shadow_ray (ori, (target - ori));
+  const auto &wi = shadow_ray.Direction ();
+
+  // Evaluate the BSDF for the direction.
+  BsdfRecord record (isect);
+  record.SetSamplingTarget (niepce::Bxdf::Type::kAll);
+  record.SetOutgoing (outgoing, bsdf::Coordinate::kWorld);
+  record.SetOutgoing (bsdf.WorldToLocal (outgoing), bsdf::Coordinate::kLocal);
+  record.SetIncident (wi, bsdf::Coordinate::kWorld);
+  record.SetIncident (bsdf.WorldToLocal (wi), bsdf::Coordinate::kLocal);
+
+  const auto f = bsdf.Evaluate (record);
+  if (f == Spectrum::Zero ()) { return Spectrum::Zero (); }
 
   // Find obstacle.
   Intersection tmp;
+  Increase (ThreadRayCounters ().shadow_rays);
   if (!scene_->IsIntersect (shadow_ray, &tmp))
   {
     // Unexpected case.
@@ -339,16 +789,84 @@ auto PathTracer::DirectSampleOneLight
   static constexpr auto kShadowRayEpsilon = 0.1;
   const auto len = (target - ori).Length ();
   const auto res = (tmp.Position () - ori).Length ();
-
-  if (std::fabs (len - res) < kShadowRayEpsilon)
+  if (std::fabs (len - res) >= kShadowRayEpsilon)
   {
-    const auto g = std::fabs (Dot (shadow_ray.Direction (), isect.Normal ()))
-                 * std::fabs (Dot (-shadow_ray.Direction(), tmp.Normal ()))
-                 / (target - ori).LengthSquared ();
-    return light->Emission () * g / light->Pdf ();
+    // Obstacle object was found.
+    return Spectrum::Zero ();
   }
-  // Obstacle object was found.
-  return Spectrum::Zero ();
+
+  // Convert the area density to the solid angle measure.
+  const auto cos_light = std::fabs (Dot (-wi, tmp.Normal ()));
+  if (cos_light == 0) { return Spectrum::Zero (); }
+  const auto pdf = light_pdf * light->Pdf () * (target - ori).LengthSquared ()
+                 / cos_light;
+
+  const auto cos_theta = bsdf::AbsCosTheta (bsdf.WorldToLocal (wi));
+  const auto mis = static_cast <MisHeuristic>
+    (settings_.GetItem (RenderSettings::Item::kMis));
+  const auto w = mis == MisHeuristic::kNone
+               ? 1 : PowerHeuristic (1, pdf, 1, bsdf.Pdf (record));
+  return f * light->Emission () * (cos_theta * w / pdf);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PathTracer::LightPdf
+(
+ const Intersection& isect,
+ const Light&        light,
+ const Vector3f&     wi
+)
+  const noexcept -> Float
+{
+  const auto strategy = static_cast <LightSampling>
+    (settings_.GetItem (RenderSettings::Item::kLightSampling));
+  const auto idx = scene_->LightIndex (&light);
+  return scene_->LightPdf (isect, idx, strategy) * light.Pdf (isect, wi);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto PathTracer::DirectSampleInfiniteLight
+(
+ const Intersection& isect,
+ const Bsdf&         bsdf,
+ const Vector3f&     outgoing,
+ const Point2f&      sample
+)
+  const noexcept -> Spectrum
+{
+  const auto& light = scene_->InfiniteLight ();
+
+  // Sample a direction in proportion to the radiance of the environment.
+  Vector3f wi;
+  Float light_pdf = 0;
+  const auto l = light->SampleDirection (sample, &wi, &light_pdf);
+  if (light_pdf == 0 || l == Spectrum::Zero ()) { return Spectrum::Zero (); }
+
+  // Evaluate the BSDF for the direction.
+  BsdfRecord record (isect);
+  record.SetSamplingTarget (niepce::Bxdf::Type::kAll);
+  record.SetOutgoing (outgoing, bsdf::Coordinate::kWorld);
+  record.SetOutgoing (bsdf.WorldToLocal (outgoing), bsdf::Coordinate::kLocal);
+  record.SetIncident (wi, bsdf::Coordinate::kWorld);
+  record.SetIncident (bsdf.WorldToLocal (wi), bsdf::Coordinate::kLocal);
+
+  const auto f = bsdf.Evaluate (record);
+  if (f == Spectrum::Zero ()) { return Spectrum::Zero (); }
+
+  // The environment is visible if the shadow ray escapes.
+  const Ray shadow_ray (isect.Position () + wi * 0.001, wi);
+  Intersection tmp;
+  Increase (ThreadRayCounters ().shadow_rays);
+  if (scene_->IsIntersect (shadow_ray, &tmp)) { return Spectrum::Zero (); }
+
+  const auto cos_theta = bsdf::AbsCosTheta (bsdf.WorldToLocal (wi));
+  const auto mis = static_cast <MisHeuristic>
+    (settings_.GetItem (RenderSettings::Item::kMis));
+  const auto w = mis == MisHeuristic::kNone
+               ? 1 : PowerHeuristic (1, light_pdf, 1, bsdf.Pdf (record));
+  return f * l * (cos_theta * w / light_pdf);
 }
 /*
 // ---------------------------------------------------------------------------
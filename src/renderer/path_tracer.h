@@ -11,15 +11,19 @@
 // ---------------------------------------------------------------------------
 */
 #include "renderer.h"
+#include "path_statistics.h"
 #include "../core/niepce.h"
 #include "../core/render_settings.h"
 #include "../core/thread_pool.h"
 #include "../core/vector3f.h"
 #include "../random/xorshift.h"
 #include "../scene/scene.h"
-#include "../sampler/random_sampler.h"
+#include "../sampler/sampler.h"
 #include "../camera/camera.h"
 #include "../core/film_tile.h"
+#include "../core/aov_buffer.h"
+#include "../core/cost_heatmap.h"
+#include "tile_scheduler.h"
 /*
 // ---------------------------------------------------------------------------
 */
@@ -71,19 +75,43 @@ public:
 
 private:
   /*!
-   * @fn void TraceRay (RandomSampler*)
-   * @brief 
-   * @param[in] 
-   * @param[out] 
-   * @return 
+   * @fn void RenderTiles (TileScheduler*, std::vector <FilmTile>*, Sampler*)
+   * @brief Render tasks of the scheduler until every round is finished.
+   * @param[in] scheduler
+   * @param[in] tiles
+   * @param[in] sampler
+   *    The sampler owned by this task.
+   * @return
    * @exception none
-   * @details
+   * @details It runs on each thread. A tile which has finished a round is
+   *          copied to the film. The streamed film flushes a tile to the disk
+   *          when it has finished the last round.
    */
+  auto RenderTiles
+  (
+   TileScheduler*          scheduler,
+   std::vector <FilmTile>* tiles,
+   Sampler*                sampler
+  )
+    noexcept -> void;
+
+  /*!
+   * @fn void RenderTileBounds (const TileTask&, FilmTile*, Sampler*)
+   * @brief Accumulate the samples of the round in the rectangle of the task.
+   * @param[in] task
+   * @param[out] tile
+   *    The tile which contains the rectangle.
+   * @param[in] tile_sampler
+   * @return
+   * @exception none
+   * @details kGroups is the bits of AovGroup recorded by the samples.
+   */
+  template <unsigned int kGroups>
   auto RenderTileBounds
   (
-   int             round,
+   const TileTask& task,
    FilmTile*       tile,
-   RandomSampler*  tile_sampler
+   Sampler*        tile_sampler
   )
     noexcept -> void;
 
@@ -91,47 +119,152 @@ private:
    * @fn Vector3f Contribution (const)
    * @brief 
    * @param[in] ray
+   * @param[in] sampler
+   * @param[in] survival_scales
+   *    The scale of the survival probability of each depth. It is used by
+   *    RussianRoulette::kEfficiency.
+   * @param[out] radiance
+   * @param[out] statistics
+   *    The counters of the depths reached by the path.
+   * @param[out] aov
+   *    The output variables of the groups of kGroups.
    * @return 
    * @exception none
-   * @details
+   * @details Only kAovFirstHit and kAovSplit of kGroups change the path.
    */
+  template <unsigned int kGroups>
   auto Radiance
   (
-   const Ray     &ray,
-   RandomSampler *sampler,
-   Spectrum      *radiance
+   const Ray                  &ray,
+   Sampler                    *sampler,
+   const std::vector <Float>  &survival_scales,
+   Spectrum                   *radiance,
+   PathStatistics             *statistics,
+   AovSample                  *aov
   )
     -> bool;
 
   /*!
-   * @fn Spectrum SampleInfiniteLight ()
-   * @brief 
-   * @param[in] 
-   * @param[out] 
-   * @return 
+   * @fn Spectrum DirectSampleInfiniteLight (const Intersection&, const Bsdf&, const Vector3f&, const Point2f&)
+   * @brief Sample the infinite light toward the intersection.
+   * @param[in] intersection
+   * @param[in] bsdf
+   *    The BSDF of the intersection.
+   * @param[in] outgoing
+   *    The outgoing direction in world coordinates.
+   * @param[in] sample
+   * @return The contribution including the BSDF and the cosine term.
    * @exception none
-   * @details 
+   * @details The pair of this is the escaped path of BSDF sampling weighted
+   *          by the same heuristic in Radiance (). It is weighted by the
+   *          power heuristic unless kMis is kNone.
    */
-  auto SampleInfiniteLight (Float* pdf) -> Spectrum;
+  auto DirectSampleInfiniteLight
+  (
+   const Intersection& intersection,
+   const Bsdf&         bsdf,
+   const Vector3f&     outgoing,
+   const Point2f&      sample
+  )
+    const noexcept -> Spectrum;
 
 private:
   /*!
-   * @fn Spectrum DirectSampleOneLight ()
-   * @brief 
-   * @return 
+   * @fn Spectrum DirectSampleOneLight (const Intersection&, const Bsdf&, const Vector3f&, const Point2f&)
+   * @brief Sample a position on one of the area lights.
+   * @param[in] intersection
+   * @param[in] bsdf
+   *    The BSDF of the intersection.
+   * @param[in] outgoing
+   *    The outgoing direction in world coordinates.
+   * @param[in] sample
+   * @return The contribution including the BSDF and the cosine term.
    * @exception none
-   * @details
+   * @details A light is chosen by the strategy of kLightSampling, and the
+   *          contribution is divided by the probability to choose it. It is
+   *          weighted against BSDF sampling unless kMis is kNone.
    */
   auto DirectSampleOneLight
   (
    const Intersection& intersection,
+   const Bsdf&         bsdf,
+   const Vector3f&     outgoing,
    const Point2f&      sample
   )
     const noexcept -> Spectrum;
 
+  /*!
+   * @fn Float LightPdf (const Intersection&, const Light&, const Vector3f&)
+   * @brief Return the density that DirectSampleOneLight () samples wi.
+   * @param[in] intersection
+   * @param[in] light
+   * @param[in] wi
+   *    The direction toward the light in world coordinates.
+   * @return The density in solid angle measure.
+   * @exception none
+   * @details
+   */
+  auto LightPdf
+  (
+   const Intersection& intersection,
+   const Light&        light,
+   const Vector3f&     wi
+  )
+    const noexcept -> Float;
+
+private:
+  // The groups of AOVs which change the work of a sample. RenderTileBounds ()
+  // and Radiance () are instantiated for each combination, so that disabled
+  // AOVs cost nothing in the loops.
+  enum AovGroup : unsigned int
+  {
+    kAovRecord   = 1 << 0,  // Any AOV is added to the buffer.
+    kAovFirstHit = 1 << 1,  // The albedo, the normal, the depth and the IDs.
+    kAovSplit    = 1 << 2,  // The direct and the indirect radiance.
+    kAovTime     = 1 << 3,  // The time of each pixel.
+  };
+
+  using RenderTileFunction
+    = void (PathTracer::*) (const TileTask&, FilmTile*, Sampler*) noexcept;
+
+  /*!
+   * @fn RenderTileFunction SelectRenderTileBounds (unsigned int)
+   * @brief Return the instance of RenderTileBounds () for the groups.
+   * @param[in] groups
+   *    The bits of AovGroup.
+   * @return
+   * @exception none
+   * @details
+   */
+  static auto SelectRenderTileBounds (unsigned int groups)
+    noexcept -> RenderTileFunction;
+
 private:
   std::shared_ptr <Scene>  scene_;
   std::shared_ptr <Camera> camera_;
+
+  // Counters of all tiles. Each tile merges its own after rendering.
+  PathStatistics statistics_;
+  std::mutex     statistics_mutex_;
+
+  // Counters of each round of each tile. A round learns the survival scales
+  // from the previous rounds of its tile only.
+  std::vector <std::vector <PathStatistics>> tile_statistics_;
+
+  // Guards the film shared by the tasks.
+  std::mutex film_mutex_;
+
+  // The output variables, or nullptr if none is enabled. The denoiser adds
+  // the guides which it reads.
+  std::unique_ptr <AovBuffer> aovs_;
+  unsigned int                aov_groups_ = 0;
+
+  // The cost of each pixel. It is allocated only if kCostHeatmap is true.
+  std::unique_ptr <CostHeatmap> cost_heatmap_;
+
+  // The workers stop taking tiles after it. It is the maximum if the render
+  // has no time limit.
+  std::chrono::steady_clock::time_point deadline_;
 }; // class PathTracer
 /*
 // ---------------------------------------------------------------------------
@@ -0,0 +1,207 @@
+/*!
+ * @file tile_scheduler.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "tile_scheduler.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+// Tasks are not split below this number of pixels on a side.
+constexpr int kMinSplitSize = 8;
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+auto HilbertIndexToPoint (uint32_t n, uint32_t index, uint32_t* x, uint32_t* y)
+  noexcept -> void
+{
+  uint32_t px = 0;
+  uint32_t py = 0;
+  for (uint32_t s = 1; s < n; s *= 2)
+  {
+    const uint32_t rx = 1 & (index / 2);
+    const uint32_t ry = 1 & (index ^ rx);
+    // Rotate the quadrant.
+    if (ry == 0)
+    {
+      if (rx == 1)
+      {
+        px = s - 1 - px;
+        py = s - 1 - py;
+      }
+      std::swap (px, py);
+    }
+    px += s * rx;
+    py += s * ry;
+    index /= 4;
+  }
+  *x = px;
+  *y = py;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TileScheduler::TileScheduler
+(
+ int  width,
+ int  height,
+ int  tile_width,
+ int  tile_height,
+ int  num_rounds,
+ int  num_workers,
+ bool depth_first
+) :
+  num_rounds_  (num_rounds),
+  num_workers_ (num_workers),
+  depth_first_ (depth_first)
+{
+  const int nx = (width  + tile_width  - 1) / tile_width;
+  const int ny = (height + tile_height - 1) / tile_height;
+  uint32_t n = 1;
+  while (n < static_cast <uint32_t> (std::max (nx, ny))) { n *= 2; }
+
+  // Walk the Hilbert curve of the power of 2 grid and skip outside tiles.
+  for (uint32_t i = 0; i < n * n; ++i)
+  {
+    uint32_t x, y;
+    HilbertIndexToPoint (n, i, &x, &y);
+    if (x >= static_cast <uint32_t> (nx) || y >= static_cast <uint32_t> (ny))
+    {
+      continue;
+    }
+    TileTask tile;
+    tile.tile    = static_cast <int> (tiles_.size ());
+    tile.round   = 1;
+    tile.begin_x = x * tile_width;
+    tile.begin_y = y * tile_height;
+    tile.end_x   = std::min (tile.begin_x + tile_width,  width);
+    tile.end_y   = std::min (tile.begin_y + tile_height, height);
+    tiles_.push_back (tile);
+  }
+
+  running_.resize (tiles_.size (), 1);
+  num_finished_.resize (num_rounds_ + 1, 0);
+  remaining_ = static_cast <int> (tiles_.size ()) * num_rounds_;
+  queue_.assign (tiles_.begin (), tiles_.end ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto TileScheduler::NumTiles () const noexcept -> int
+{
+  return static_cast <int> (tiles_.size ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto TileScheduler::TileBounds (int tile) const noexcept -> Bounds2f
+{
+  const auto& t = tiles_[tile];
+  return Bounds2f (Point2f (t.begin_x, t.begin_y), Point2f (t.end_x, t.end_y));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto TileScheduler::Next (TileTask* task) -> bool
+{
+  std::unique_lock <std::mutex> lock (mutex_);
+  condition_.wait (lock, [this] ()
+  {
+    return stopped_ || remaining_ == 0 || !queue_.empty ();
+  });
+  if (stopped_ || queue_.empty ()) { return false; }
+
+  *task = queue_.front ();
+  queue_.pop_front ();
+
+  // Split the task while some workers would have nothing to do. The other
+  // half goes to the front, so that the next idle worker takes it.
+  const int w = task->end_x - task->begin_x;
+  const int h = task->end_y - task->begin_y;
+  if (static_cast <int> (queue_.size ()) < num_workers_ - 1
+      && std::max (w, h) >= kMinSplitSize * 2)
+  {
+    auto half = *task;
+    if (w >= h)
+    {
+      task->end_x = half.begin_x = task->begin_x + w / 2;
+    }
+    else
+    {
+      task->end_y = half.begin_y = task->begin_y + h / 2;
+    }
+    ++running_[task->tile];
+    Push (half, true);
+  }
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto TileScheduler::Finish (const TileTask& task, bool* round_finished) -> bool
+{
+  std::unique_lock <std::mutex> lock (mutex_);
+  *round_finished = false;
+  if (--running_[task.tile] > 0) { return false; }
+
+  --remaining_;
+  *round_finished = ++num_finished_[task.round] == NumTiles ();
+  if (remaining_ == 0) { condition_.notify_all (); }
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto TileScheduler::QueueNextRound (const TileTask& task) -> void
+{
+  std::unique_lock <std::mutex> lock (mutex_);
+  if (task.round >= num_rounds_ || stopped_) { return; }
+
+  // Behind the other tiles unless depth first.
+  auto next  = tiles_[task.tile];
+  next.round = task.round + 1;
+  running_[task.tile] = 1;
+  Push (next, depth_first_);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto TileScheduler::Stop () -> void
+{
+  std::unique_lock <std::mutex> lock (mutex_);
+  stopped_ = true;
+  queue_.clear ();
+  condition_.notify_all ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto TileScheduler::Push (const TileTask& task, bool front) -> void
+{
+  if (front) { queue_.push_front (task); }
+  else       { queue_.push_back  (task); }
+  condition_.notify_one ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
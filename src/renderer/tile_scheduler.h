@@ -0,0 +1,194 @@
+/*!
+ * @file tile_scheduler.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _TILE_SCHEDULER_H_
+#define _TILE_SCHEDULER_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "../core/niepce.h"
+#include "../core/bounds2f.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @struct TileTask
+ * @brief The rectangle of a tile to render in a round.
+ * @details It is the whole tile, or a part of it split to balance the load.
+ */
+struct TileTask
+{
+  int tile;   //!< The index of the tile.
+  int round;  //!< The round, from 1.
+  int begin_x;
+  int begin_y;
+  int end_x;
+  int end_y;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn uint32_t HilbertIndexToPoint (uint32_t, uint32_t, uint32_t*, uint32_t*)
+ * @brief Return the point of the index on the Hilbert curve.
+ * @param[in] n
+ *    The width of the grid, power of 2.
+ * @param[in] index
+ * @param[out] x
+ * @param[out] y
+ * @return
+ * @exception none
+ * @details
+ */
+auto HilbertIndexToPoint (uint32_t n, uint32_t index, uint32_t* x, uint32_t* y)
+  noexcept -> void;
+//! ----------------------------------------------------------------------------
+//! @class TileScheduler
+//! @brief Hand out tiles of every round to the workers.
+//! @details Tiles are ordered along the Hilbert curve, so that tiles rendered
+//!          at the same time are close on the screen and share the cache.
+//!          The next round of a tile is queued as soon as the tile finishes,
+//!          instead of after every tile finishes the round. When fewer tasks
+//!          remain than workers, a task is split in half to keep every worker
+//!          busy. The rounds of a tile never run at the same time, because
+//!          they accumulate into the same FilmTile, and the next round waits
+//!          until the finished one is copied to the film. Depth first
+//!          scheduling runs the next round of a tile before other tiles, so
+//!          that only tiles in flight need their FilmTile.
+//!          It is thread safe.
+//! ----------------------------------------------------------------------------
+class TileScheduler
+{
+public:
+  //! The default class constructor.
+  TileScheduler () = delete;
+
+  //! The constructor takes the resolution, the tile size, the number of rounds
+  //! and the number of workers.
+  TileScheduler
+  (
+   int  width,
+   int  height,
+   int  tile_width,
+   int  tile_height,
+   int  num_rounds,
+   int  num_workers,
+   bool depth_first = false
+  );
+
+  //! The copy constructor of the class.
+  TileScheduler (const TileScheduler& scheduler) = delete;
+
+  //! The move constructor of the class.
+  TileScheduler (TileScheduler&& scheduler) = delete;
+
+  //! The default class destructor.
+  virtual ~TileScheduler () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const TileScheduler& scheduler) -> TileScheduler& = delete;
+
+  //! The move assignment operator of the class.
+  auto operator = (TileScheduler&& scheduler) -> TileScheduler& = delete;
+
+public:
+  /*!
+   * @fn int NumTiles ()
+   * @brief
+   * @return
+   * @exception none
+   * @details
+   */
+  auto NumTiles () const noexcept -> int;
+
+  /*!
+   * @fn Bounds2f TileBounds (int)
+   * @brief Return the pixels of the tile.
+   * @param[in] tile
+   *    The index of the tile in the Hilbert order.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto TileBounds (int tile) const noexcept -> Bounds2f;
+
+  /*!
+   * @fn bool Next (TileTask*)
+   * @brief Take the next task.
+   * @param[out] task
+   * @return False if every round of every tile is finished.
+   * @exception none
+   * @details It waits while the remaining rounds wait for running tasks.
+   */
+  auto Next (TileTask* task) -> bool;
+
+  /*!
+   * @fn bool Finish (const TileTask&, bool*)
+   * @brief Notify that the task is rendered.
+   * @param[in] task
+   * @param[out] round_finished
+   *    True if every tile has finished the round of the task.
+   * @return True if the tile has finished the round of the task.
+   * @exception none
+   * @details The next round of the tile is not queued until
+   *          QueueNextRound () is called, so that the caller may read the
+   *          tile before another worker adds samples to it.
+   */
+  auto Finish (const TileTask& task, bool* round_finished) -> bool;
+
+  /*!
+   * @fn void QueueNextRound (const TileTask&)
+   * @brief Queue the next round of the tile of the task.
+   * @param[in] task
+   *    The task for which Finish () returned true.
+   * @return
+   * @exception none
+   * @details Nothing is queued after the last round, or once stopped.
+   */
+  auto QueueNextRound (const TileTask& task) -> void;
+
+  /*!
+   * @fn void Stop ()
+   * @brief Stop giving tasks.
+   * @return
+   * @exception none
+   * @details Next returns false from now on, and the running tasks do not
+   *          queue the next rounds of their tiles. The tiles keep the rounds
+   *          they have finished.
+   */
+  auto Stop () -> void;
+
+private:
+  auto Push (const TileTask& task, bool front) -> void;
+
+private:
+  const int num_rounds_;
+  const int num_workers_;
+  const bool depth_first_;
+  std::vector <TileTask> tiles_;
+
+  std::mutex              mutex_;
+  std::condition_variable condition_;
+  std::deque <TileTask>   queue_;
+  std::vector <int>       running_;       // Running tasks of each tile.
+  std::vector <int>       num_finished_;  // Finished tiles of each round.
+  int                     remaining_;     // Rounds of tiles not finished.
+  bool                    stopped_ = false;
+}; // class TileScheduler
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _TILE_SCHEDULER_H_
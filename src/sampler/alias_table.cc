@@ -0,0 +1,136 @@
+/*!
+ * @file alias_table.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "alias_table.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+AliasTable::AliasTable (const std::vector <Float>& weights)
+{
+  Build (weights);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto AliasTable::Build (const std::vector <Float>& weights) -> void
+{
+  const auto n = weights.size ();
+  bins_.assign (n, Bin {1, 0, -1});
+  if (n == 0) { return ; }
+
+  // Normalize weights in double precision to avoid error on large tables.
+  double sum = 0;
+  for (const auto& w : weights) { sum += std::fmax (0.0, w); }
+
+  std::vector <double> p (n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    p[i] = sum > 0 ? std::fmax (0.0, weights[i]) / sum : 1.0 / n;
+    bins_[i].pdf = static_cast <Float> (p[i]);
+  }
+
+  // Split bins into under-full and over-full ones, scaled by n.
+  std::vector <std::pair <int, double>> under, over;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const auto scaled = p[i] * n;
+    if (scaled < 1.0) { under.push_back (std::make_pair (i, scaled)); }
+    else              { over.push_back  (std::make_pair (i, scaled)); }
+  }
+
+  // Fill each under-full bin with the excess of an over-full bin.
+  while (!under.empty () && !over.empty ())
+  {
+    const auto u = under.back (); under.pop_back ();
+    const auto o = over.back ();  over.pop_back ();
+
+    bins_[u.first].q     = static_cast <Float> (u.second);
+    bins_[u.first].alias = o.first;
+
+    const auto excess = o.second - (1.0 - u.second);
+    if (excess < 1.0) { under.push_back (std::make_pair (o.first, excess)); }
+    else              { over.push_back  (std::make_pair (o.first, excess)); }
+  }
+
+  // Remaining bins are full up to floating point error.
+  for (const auto& o : over)  { bins_[o.first].q = 1; bins_[o.first].alias = -1; }
+  for (const auto& u : under) { bins_[u.first].q = 1; bins_[u.first].alias = -1; }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto AliasTable::Sample (Float sample, Float* pdf, Float* remapped)
+  const noexcept -> int
+{
+  if (bins_.empty ())
+  {
+    *pdf = 0;
+    return -1;
+  }
+
+  // Choose a bin uniformly.
+  const auto n      = bins_.size ();
+  const auto offset = std::min (static_cast <std::size_t> (sample * n), n - 1);
+  const auto up     = std::fmin (sample * n - offset, 1.0 - kEpsilon);
+
+  // Accept the bin or take its alias.
+  const auto& bin = bins_[offset];
+  if (up < bin.q)
+  {
+    *pdf = bin.pdf;
+    if (remapped) { *remapped = std::fmin (up / bin.q, 1.0 - kEpsilon); }
+    return offset;
+  }
+
+  *pdf = bins_[bin.alias].pdf;
+  if (remapped)
+  {
+    *remapped = std::fmin ((up - bin.q) / (1.0 - bin.q), 1.0 - kEpsilon);
+  }
+  return bin.alias;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto AliasTable::Pdf (int idx) const noexcept -> Float
+{
+  if (idx < 0 || idx >= static_cast <int> (bins_.size ())) { return 0; }
+  return bins_[idx].pdf;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto AliasTable::Size () const noexcept -> std::size_t
+{
+  return bins_.size ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto AliasTable::ToString () const noexcept -> std::string
+{
+  std::ostringstream ss;
+  for (std::size_t i = 0; i < bins_.size (); ++i)
+  {
+    ss << "[" << i << "] pdf : " << bins_[i].pdf
+       << ", q : "     << bins_[i].q
+       << ", alias : " << bins_[i].alias << "\n";
+  }
+  return ss.str ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
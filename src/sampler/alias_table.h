@@ -0,0 +1,123 @@
+/*!
+ * @file alias_table.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _ALIAS_TABLE_H_
+#define _ALIAS_TABLE_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "../core/niepce.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+//! ----------------------------------------------------------------------------
+//! @class AliasTable
+//! @brief Discrete distribution that is sampled in constant time.
+//! @details The table is built by Vose's alias method. Each bin keeps the
+//!          probability to accept itself and the index of the alias to choose
+//!          otherwise.
+//! ----------------------------------------------------------------------------
+class AliasTable
+{
+public:
+  //! The default class constructor.
+  AliasTable () = default;
+
+  //! The constructor takes non-negative weights.
+  AliasTable (const std::vector <Float>& weights);
+
+  //! The copy constructor of the class.
+  AliasTable (const AliasTable& table) = default;
+
+  //! The move constructor of the class.
+  AliasTable (AliasTable&& table) = default;
+
+  //! The default class destructor.
+  virtual ~AliasTable () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const AliasTable& table) -> AliasTable& = default;
+
+  //! The move assignment operator of the class.
+  auto operator = (AliasTable&& table) -> AliasTable& = default;
+
+public:
+  /*!
+   * @fn void Build (const std::vector <Float>&)
+   * @brief Build the table from weights.
+   * @param[in] weights
+   *    Non-negative weights. They don't need to be normalized. If all of
+   *    weights are zero, the table falls back to the uniform distribution.
+   * @return void
+   * @exception none
+   * @details
+   */
+  auto Build (const std::vector <Float>& weights) -> void;
+
+  /*!
+   * @fn int Sample (Float, Float*, Float*)
+   * @brief Sample an index.
+   * @param[in] sample
+   *    The uniform distributed sample on [0, 1).
+   * @param[out] pdf
+   *    The probability to choose the returned index.
+   * @param[out] remapped
+   *    The sample remapped to [0, 1) so that it can be reused. (optional)
+   * @return Sampled index, or -1 if the table is empty.
+   * @exception none
+   * @details
+   */
+  auto Sample (Float sample, Float* pdf, Float* remapped = nullptr)
+    const noexcept -> int;
+
+  /*!
+   * @fn Float Pdf (int)
+   * @brief Return the probability to choose the index.
+   * @param[in] idx
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Pdf (int idx) const noexcept -> Float;
+
+  /*!
+   * @fn std::size_t Size ()
+   * @brief Return the number of bins.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Size () const noexcept -> std::size_t;
+
+  /*!
+   * @fn std::string ToString ()
+   * @brief Return the probability and alias of each bin for inspection.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto ToString () const noexcept -> std::string;
+
+private:
+  struct Bin
+  {
+    Float q;     // The probability to accept this bin.
+    Float pdf;   // The probability to choose this bin.
+    int   alias; // The bin chosen if this bin was rejected.
+  };
+  std::vector <Bin> bins_;
+}; // class AliasTable
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _ALIAS_TABLE_H_
@@ -0,0 +1,171 @@
+/*!
+ * @file blue_noise_generator.cc
+ * @brief Generate the blue noise mask at build time.
+ * @author Masashi Yoshida
+ * @date
+ * @details Void-and-cluster method by Ulichney. The mask is tileable, and the
+ *          output is a source file which defines kBlueNoiseMask.
+ */
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <vector>
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+constexpr int    kSize  = 64;
+constexpr int    kArea  = kSize * kSize;
+constexpr double kSigma = 1.9;
+/*
+// ---------------------------------------------------------------------------
+*/
+// Energy of the gaussian filter of points on the torus.
+class Energy
+{
+public:
+  Energy () : kernel_ (kArea), energy_ (kArea, 0)
+  {
+    for (int y = 0; y < kSize; ++y)
+    {
+      for (int x = 0; x < kSize; ++x)
+      {
+        const int dx = std::min (x, kSize - x);
+        const int dy = std::min (y, kSize - y);
+        kernel_[y * kSize + x]
+          = std::exp (-(dx * dx + dy * dy) / (2 * kSigma * kSigma));
+      }
+    }
+  }
+
+  auto Add (int index, double sign) -> void
+  {
+    const int px = index % kSize;
+    const int py = index / kSize;
+    for (int y = 0; y < kSize; ++y)
+    {
+      const int ky = ((y - py + kSize) % kSize) * kSize;
+      for (int x = 0; x < kSize; ++x)
+      {
+        energy_[y * kSize + x] += sign * kernel_[ky + (x - px + kSize) % kSize];
+      }
+    }
+  }
+
+  // The tightest cluster among the points, or the largest void among the
+  // others.
+  auto Find (const std::vector <bool>& points, bool cluster) const -> int
+  {
+    int    best  = -1;
+    double value = 0;
+    for (int i = 0; i < kArea; ++i)
+    {
+      if (points[i] != cluster) { continue; }
+      if (best < 0 || (cluster ? energy_[i] > value : energy_[i] < value))
+      {
+        best  = i;
+        value = energy_[i];
+      }
+    }
+    return best;
+  }
+
+private:
+  std::vector <double> kernel_;
+  std::vector <double> energy_;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+auto GenerateMask () -> std::vector <uint16_t>
+{
+  // Initial binary pattern. Points are placed by a fixed LCG, then moved
+  // from the tightest cluster to the largest void until it converges.
+  const int num_initial = kArea / 10;
+  std::vector <bool> points (kArea, false);
+  Energy energy;
+  uint32_t state = 1;
+  for (int n = 0; n < num_initial;)
+  {
+    state = state * 1664525u + 1013904223u;
+    const int i = (state >> 8) % kArea;
+    if (points[i]) { continue; }
+    points[i] = true;
+    energy.Add (i, 1);
+    ++n;
+  }
+  for (;;)
+  {
+    const int cluster = energy.Find (points, true);
+    points[cluster] = false;
+    energy.Add (cluster, -1);
+    const int hole = energy.Find (points, false);
+    points[hole] = true;
+    energy.Add (hole, 1);
+    if (hole == cluster) { break; }
+  }
+
+  std::vector <uint16_t> ranks (kArea, 0);
+
+  // Phase 1: remove the initial points from the tightest cluster.
+  {
+    auto p = points;
+    Energy e = energy;
+    for (int rank = num_initial - 1; rank >= 0; --rank)
+    {
+      const int cluster = e.Find (p, true);
+      p[cluster] = false;
+      e.Add (cluster, -1);
+      ranks[cluster] = static_cast <uint16_t> (rank);
+    }
+  }
+  // Phase 2 and 3: fill the largest void until every pixel is ranked.
+  for (int rank = num_initial; rank < kArea; ++rank)
+  {
+    const int hole = energy.Find (points, false);
+    points[hole] = true;
+    energy.Add (hole, 1);
+    ranks[hole] = static_cast <uint16_t> (rank);
+  }
+  return ranks;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+auto main (int argc, char* argv[]) -> int
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " output" << std::endl;
+    return 1;
+  }
+
+  std::ofstream ofs (argv[1]);
+  if (!ofs)
+  {
+    std::cerr << "Failed to open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  const auto ranks = GenerateMask ();
+  ofs << "// Generated by blue_noise_generator. Do not edit.\n"
+      << "#include <cstdint>\n"
+      << "namespace niepce\n{\n"
+      << "extern const uint16_t kBlueNoiseMask[" << kArea << "] =\n{\n";
+  for (int i = 0; i < kArea; ++i)
+  {
+    ofs << (i % 16 == 0 ? "  " : " ") << ranks[i] << ","
+        << (i % 16 == 15 ? "\n" : "");
+  }
+  ofs << "};\n}  // namespace niepce\n";
+  return 0;
+}
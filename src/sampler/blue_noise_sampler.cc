@@ -0,0 +1,82 @@
+/*!
+ * @file blue_noise_sampler.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "blue_noise_sampler.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+// The value of the mask at the pixel as 32 bits fixed point.
+auto MaskValue (int x, int y) -> uint32_t
+{
+  const auto rank = kBlueNoiseMask[(y & (kBlueNoiseSize - 1)) * kBlueNoiseSize
+                                   + (x & (kBlueNoiseSize - 1))];
+  // The center of the rank, (rank + 0.5) / 4096.
+  return (static_cast <uint32_t> (rank) << 20) | (1u << 19);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+BlueNoiseSampler::BlueNoiseSampler (int spp, uint32_t seed) :
+  SobolSampler (spp, seed)
+{}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto BlueNoiseSampler::StartPixelSample (int x, int y, uint64_t index)
+  -> void
+{
+  SobolSampler::StartPixelSample (x, y, index);
+  x_ = x;
+  y_ = y;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto BlueNoiseSampler::Clone (int seed) const -> std::unique_ptr <Sampler>
+{
+  return std::unique_ptr <Sampler> (new BlueNoiseSampler (*this));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto BlueNoiseSampler::Sample (int dimension) const
+  -> std::array <uint32_t, 2>
+{
+  if (dimension >= kNumDimensions) { return SobolSampler::Sample (dimension); }
+
+  // The same point set in every pixel, digitally shifted by the mask. Unlike
+  // a toroidal rotation, the shift keeps the samples of the pixel a net, so
+  // that the convergence of Sobol is kept for larger sample counts. Each
+  // dimension reads the mask at its own offset to be uncorrelated.
+  const auto seed   = HashSeed (seed_, dimension);
+  const auto offset = HashSeed (seed, 2);
+  auto s = ScrambledSample (seed);
+  s[0] ^= MaskValue (x_ + (offset & 63),         y_ + ((offset >> 6)  & 63));
+  s[1] ^= MaskValue (x_ + ((offset >> 12) & 63), y_ + ((offset >> 18) & 63));
+  return s;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
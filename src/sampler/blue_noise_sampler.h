@@ -0,0 +1,108 @@
+/*!
+ * @file blue_noise_sampler.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _BLUE_NOISE_SAMPLER_H_
+#define _BLUE_NOISE_SAMPLER_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "../core/niepce.h"
+#include "sobol_sampler.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+//! The width and height of the blue noise mask.
+constexpr int kBlueNoiseSize = 64;
+
+//! Ranks of the tileable blue noise mask, generated at build time by
+//! blue_noise_generator. Each rank in [0, 64 * 64) appears once.
+extern const uint16_t kBlueNoiseMask[kBlueNoiseSize * kBlueNoiseSize];
+//! ----------------------------------------------------------------------------
+//! @class BlueNoiseSampler
+//! @brief Sobol sampler whose error is distributed as blue noise on screen.
+//! @details The low dimensions use the same scrambled point set in every
+//!          pixel, and each pixel shifts it by the value of the blue noise
+//!          mask (dithered sampling of Georgiev and Fajardo, with XOR instead
+//!          of addition). Neighbouring pixels get offsets far apart from each
+//!          other, so that the error at low sample counts has no low
+//!          frequency. Higher dimensions are decorrelated by pixels as
+//!          SobolSampler does.
+//! ----------------------------------------------------------------------------
+class BlueNoiseSampler : public SobolSampler
+{
+public:
+  //! The number of dimensions shifted by the mask. They cover the camera and
+  //! the first bounce, which dominate the error of previews.
+  static constexpr int kNumDimensions = 12;
+
+public:
+  //! The default class constructor.
+  BlueNoiseSampler () = delete;
+
+  //! The constructor takes the number of samples and the seed.
+  BlueNoiseSampler (int spp, uint32_t seed);
+
+  //! The copy constructor of the class.
+  BlueNoiseSampler (const BlueNoiseSampler& sampler) = default;
+
+  //! The move constructor of the class.
+  BlueNoiseSampler (BlueNoiseSampler&& sampler) = default;
+
+  //! The default class destructor.
+  virtual ~BlueNoiseSampler () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const BlueNoiseSampler& sampler)
+    -> BlueNoiseSampler& = delete;
+
+  //! The move assignment operator of the class.
+  auto operator = (BlueNoiseSampler&& sampler) -> BlueNoiseSampler& = delete;
+
+public:
+  /*!
+   * @fn void StartPixelSample (int, int, uint64_t)
+   * @brief
+   * @param[in] x
+   * @param[in] y
+   * @param[in] index
+   * @return
+   * @exception none
+   * @details
+   */
+  auto StartPixelSample (int x, int y, uint64_t index) -> void override;
+
+  /*!
+   * @fn std::unique_ptr <Sampler> Clone (int)
+   * @brief
+   * @param[in] seed
+   *    It is not used, so that copies draw the same samples for each pixel.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Clone (int seed) const -> std::unique_ptr <Sampler> override;
+
+protected:
+  auto Sample (int dimension) const -> std::array <uint32_t, 2> override;
+
+private:
+  int x_ = 0;
+  int y_ = 0;
+}; // class BlueNoiseSampler
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _BLUE_NOISE_SAMPLER_H_
@@ -0,0 +1,144 @@
+/*!
+ * @file distribution.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "distribution.h"
+#include "../core/thread_pool.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+Distribution1D::Distribution1D (const Float* func, int n) :
+  func_ (func, func + n),
+  cdf_  (n + 1)
+{
+  // Integrate the step function.
+  cdf_[0] = 0;
+  for (int i = 1; i < n + 1; ++i)
+  {
+    cdf_[i] = cdf_[i - 1] + std::fabs (func_[i - 1]) / n;
+  }
+
+  // Normalize the CDF. Fall back to uniform if the function is zero.
+  integral_ = cdf_[n];
+  if (integral_ == 0)
+  {
+    for (int i = 1; i < n + 1; ++i) { cdf_[i] = static_cast <Float> (i) / n; }
+  }
+  else
+  {
+    for (int i = 1; i < n + 1; ++i) { cdf_[i] /= integral_; }
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Distribution1D::SampleContinuous (Float sample, Float* pdf, int* offset)
+  const noexcept -> Float
+{
+  const int n = Count ();
+  if (n == 0)
+  {
+    *pdf = 0;
+    return 0;
+  }
+
+  // Find the segment where cdf_[i] <= sample < cdf_[i + 1].
+  const auto it = std::upper_bound (cdf_.begin (), cdf_.end (), sample);
+  const int  i  = Clamp (static_cast <int> (it - cdf_.begin ()) - 1, 0, n - 1);
+  if (offset) { *offset = i; }
+
+  *pdf = integral_ > 0 ? func_[i] / integral_ : 1;
+
+  // Offset in the segment.
+  Float du = sample - cdf_[i];
+  if (cdf_[i + 1] - cdf_[i] > 0) { du /= cdf_[i + 1] - cdf_[i]; }
+  return std::fmin ((i + du) / n, 1.0f - kEpsilon);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Distribution1D::Integral () const noexcept -> Float
+{
+  return integral_;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Distribution1D::Function (int idx) const noexcept -> Float
+{
+  return func_[idx];
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Distribution1D::Count () const noexcept -> int
+{
+  return func_.size ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+Distribution2D::Distribution2D (const Float* func, int nu, int nv) :
+  conditional_ (nv)
+{
+  // Build the conditional distribution of each row.
+  ParallelFor (nv, [&] (int begin, int end)
+  {
+    for (int v = begin; v < end; ++v)
+    {
+      conditional_[v] = Distribution1D (&func[v * nu], nu);
+    }
+  });
+
+  // Build the marginal distribution from integrals of rows.
+  std::vector <Float> marginal (nv);
+  for (int v = 0; v < nv; ++v) { marginal[v] = conditional_[v].Integral (); }
+  marginal_ = Distribution1D (marginal.data (), nv);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Distribution2D::SampleContinuous (const Point2f& sample, Float* pdf)
+  const noexcept -> Point2f
+{
+  if (conditional_.empty ())
+  {
+    *pdf = 0;
+    return Point2f (0, 0);
+  }
+
+  Float pdfs[2];
+  int   v;
+  const Float d1 = marginal_.SampleContinuous (sample[1], &pdfs[1], &v);
+  const Float d0 = conditional_[v].SampleContinuous (sample[0], &pdfs[0]);
+  *pdf = pdfs[0] * pdfs[1];
+  return Point2f (d0, d1);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Distribution2D::Pdf (const Point2f& p) const noexcept -> Float
+{
+  if (conditional_.empty () || marginal_.Integral () == 0) { return 0; }
+
+  const int nu = conditional_[0].Count ();
+  const int nv = marginal_.Count ();
+  const int iu = Clamp (static_cast <int> (p[0] * nu), 0, nu - 1);
+  const int iv = Clamp (static_cast <int> (p[1] * nv), 0, nv - 1);
+  return conditional_[iv].Function (iu) / marginal_.Integral ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,165 @@
+/*!
+ * @file distribution.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _DISTRIBUTION_H_
+#define _DISTRIBUTION_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "../core/niepce.h"
+#include "../core/point2f.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+//! ----------------------------------------------------------------------------
+//! @class Distribution1D
+//! @brief Piecewise-constant 1D distribution over [0, 1).
+//! @details
+//! ----------------------------------------------------------------------------
+class Distribution1D
+{
+public:
+  //! The default class constructor.
+  Distribution1D () = default;
+
+  //! The constructor takes non-negative function values.
+  Distribution1D (const Float* func, int n);
+
+  //! The copy constructor of the class.
+  Distribution1D (const Distribution1D& dist) = default;
+
+  //! The move constructor of the class.
+  Distribution1D (Distribution1D&& dist) = default;
+
+  //! The default class destructor.
+  virtual ~Distribution1D () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const Distribution1D& dist) -> Distribution1D& = default;
+
+  //! The move assignment operator of the class.
+  auto operator = (Distribution1D&& dist) -> Distribution1D& = default;
+
+public:
+  /*!
+   * @fn Float SampleContinuous (Float, Float*, int*)
+   * @brief Sample a value on [0, 1).
+   * @param[in] sample
+   *    The uniform distributed sample on [0, 1).
+   * @param[out] pdf
+   *    The density of the returned value.
+   * @param[out] offset
+   *    The index of the segment of the returned value. (optional)
+   * @return
+   * @exception none
+   * @details
+   */
+  auto SampleContinuous (Float sample, Float* pdf, int* offset = nullptr)
+    const noexcept -> Float;
+
+  /*!
+   * @fn Float Integral ()
+   * @brief Return the integral of the function over [0, 1).
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Integral () const noexcept -> Float;
+
+  /*!
+   * @fn Float Function (int)
+   * @brief
+   * @param[in] idx
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Function (int idx) const noexcept -> Float;
+
+  /*!
+   * @fn int Count ()
+   * @brief Return the number of segments.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Count () const noexcept -> int;
+
+private:
+  std::vector <Float> func_;
+  std::vector <Float> cdf_;
+  Float integral_ = 0;
+}; // class Distribution1D
+//! ----------------------------------------------------------------------------
+//! @class Distribution2D
+//! @brief Piecewise-constant 2D distribution over [0, 1)^2.
+//! @details A marginal distribution chooses v, then the conditional
+//!          distribution of the row chooses u. Conditional distributions are
+//!          built in parallel on the thread pool.
+//! ----------------------------------------------------------------------------
+class Distribution2D
+{
+public:
+  //! The default class constructor.
+  Distribution2D () = default;
+
+  //! The constructor takes function values stored as rows of nu.
+  Distribution2D (const Float* func, int nu, int nv);
+
+  //! The copy constructor of the class.
+  Distribution2D (const Distribution2D& dist) = default;
+
+  //! The move constructor of the class.
+  Distribution2D (Distribution2D&& dist) = default;
+
+  //! The default class destructor.
+  virtual ~Distribution2D () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const Distribution2D& dist) -> Distribution2D& = default;
+
+  //! The move assignment operator of the class.
+  auto operator = (Distribution2D&& dist) -> Distribution2D& = default;
+
+public:
+  /*!
+   * @fn Point2f SampleContinuous (const Point2f&, Float*)
+   * @brief Sample a point on [0, 1)^2.
+   * @param[in] sample
+   * @param[out] pdf
+   *    The density of the returned point.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto SampleContinuous (const Point2f& sample, Float* pdf)
+    const noexcept -> Point2f;
+
+  /*!
+   * @fn Float Pdf (const Point2f&)
+   * @brief Return the density of the point.
+   * @param[in] p
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Pdf (const Point2f& p) const noexcept -> Float;
+
+private:
+  std::vector <Distribution1D> conditional_;
+  Distribution1D marginal_;
+}; // class Distribution2D
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _DISTRIBUTION_H_
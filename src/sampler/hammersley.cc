@@ -41,6 +41,13 @@ auto HammersleySampler::Next2f () -> Point2f
 /*
 // ---------------------------------------------------------------------------
 */
+auto HammersleySampler::Clone (int seed) const -> std::unique_ptr <Sampler>
+{
+  return std::unique_ptr <Sampler> (new HammersleySampler (*this));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 } // namespace niepce
 /*
 // ---------------------------------------------------------------------------
@@ -61,6 +61,17 @@ public:
    */
   auto Next2f () -> Point2f override;
 
+  /*!
+   * @fn std::unique_ptr <Sampler> Clone (int)
+   * @brief
+   * @param[in] seed
+   *    It is not used since the sequence is deterministic.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Clone (int seed) const -> std::unique_ptr <Sampler> override;
+
 private:
   int num_samples_;
   int n1_;
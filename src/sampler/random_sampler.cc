@@ -15,13 +15,23 @@ namespace niepce
 /*
 // ---------------------------------------------------------------------------
 */
+RandomSampler::RandomSampler () :
+  Sampler (1),
+  seed_   (0),
+  rng_    (0)
+{}
+/*
+// ---------------------------------------------------------------------------
+*/
 RandomSampler::RandomSampler (int seed) :
-  rng_ (seed)
+  Sampler (1),
+  seed_   (MixBits64 (seed)),
+  rng_    (seed_)
 {}
 /*
 // ---------------------------------------------------------------------------
 */
-auto RandomSampler::Clone (int seed) const noexcept -> std::unique_ptr <RandomSampler>
+auto RandomSampler::Clone (int seed) const -> std::unique_ptr <Sampler>
 {
   std::unique_ptr <RandomSampler> res (new RandomSampler (*this));
   res->SetSeed (seed);
@@ -30,8 +40,41 @@ auto RandomSampler::Clone (int seed) const noexcept -> std::unique_ptr <RandomSa
 /*
 // ---------------------------------------------------------------------------
 */
+auto RandomSampler::Next1f () -> Float
+{
+  return SampleFloat ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto RandomSampler::Next2f () -> Point2f
+{
+  return SamplePoint2f ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto RandomSampler::StartPixelSample (int x, int y, uint64_t index) -> void
+{
+  Sampler::StartPixelSample (x, y, index);
+  const auto pixel = (static_cast <uint64_t> (y) << 32)
+                   | static_cast <uint32_t> (x);
+  rng_.SetKey (HashKey (HashKey (seed_, pixel), index));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto RandomSampler::StartDimension (int dimension) -> void
+{
+  Sampler::StartDimension (dimension);
+  rng_.SetCounter (dimension);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 auto RandomSampler::SampleFloat () noexcept -> Float
 {
+  ++dimension_;
   return rng_.Next01 ();
 }
 /*
@@ -39,14 +82,17 @@ auto RandomSampler::SampleFloat () noexcept -> Float
 */
 auto RandomSampler::SamplePoint2f () noexcept -> Point2f
 {
-  return Point2f (rng_.Next01 (), rng_.Next01 ());
+  dimension_ += 2;
+  const auto x = rng_.Next01 ();
+  return Point2f (x, rng_.Next01 ());
 }
 /*
 // ---------------------------------------------------------------------------
 */
 auto RandomSampler::SetSeed (int seed) noexcept -> void
 {
-  rng_.SetSeed (seed);
+  seed_ = MixBits64 (seed);
+  rng_.SetKey (seed_);
 }
 /*
 // ---------------------------------------------------------------------------
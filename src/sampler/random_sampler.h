@@ -11,7 +11,8 @@
 // ---------------------------------------------------------------------------
 */
 #include "../core/niepce.h"
-#include "../random/xorshift.h"
+#include "../random/counter_rng.h"
+#include "sampler.h"
 /*
 // ---------------------------------------------------------------------------
 */
@@ -20,13 +21,16 @@ namespace niepce
 //! ----------------------------------------------------------------------------
 //! @class RandomSampler
 //! @brief
-//! @details
+//! @details Independent uniform samples. Each sample is the hash of the
+//!          seed, the pixel, the sample index and the dimension, so that the
+//!          image does not depend on the number of threads or the order of
+//!          tiles.
 //! ----------------------------------------------------------------------------
-class RandomSampler
+class RandomSampler : public Sampler
 {
 public:
   //! The default class constructor.
-  RandomSampler () = default;
+  RandomSampler ();
 
   //! The constructor takes a seed.
   RandomSampler (int seed);
@@ -56,7 +60,39 @@ public:
   //! @return 
   //! @exception none
   //! @details 
-  auto Clone (int seed) const noexcept -> std::unique_ptr <RandomSampler>;
+  auto Clone (int seed) const -> std::unique_ptr <Sampler> override;
+
+  //! @fn Float Next1f ()
+  //! @brief Same as SampleFloat ().
+  //! @return
+  //! @exception none
+  //! @details
+  auto Next1f () -> Float override;
+
+  //! @fn Point2f Next2f ()
+  //! @brief Same as SamplePoint2f ().
+  //! @return
+  //! @exception none
+  //! @details
+  auto Next2f () -> Point2f override;
+
+  //! @fn void StartPixelSample (int, int, uint64_t)
+  //! @brief Start the stream of the sample of the pixel.
+  //! @param[in] x
+  //! @param[in] y
+  //! @param[in] index
+  //! @return
+  //! @exception none
+  //! @details
+  auto StartPixelSample (int x, int y, uint64_t index) -> void override;
+
+  //! @fn void StartDimension (int)
+  //! @brief Jump to the dimension of the stream.
+  //! @param[in] dimension
+  //! @return
+  //! @exception none
+  //! @details
+  auto StartDimension (int dimension) -> void override;
 
   //! @fn Float SampleFloat ()
   //! @brief Return the float in [0, 1).
@@ -81,7 +117,8 @@ public:
   auto SetSeed (int seed) noexcept -> void;
 
 private:
-  XorShift rng_;
+  uint64_t   seed_;
+  CounterRng rng_;
 }; // class RandomSampler
 /*
 // ---------------------------------------------------------------------------
@@ -6,8 +6,10 @@
  * @details 
  */
 #include "sampler.h"
+#include "blue_noise_sampler.h"
+#include "random_sampler.h"
+#include "sobol_sampler.h"
 #include "../camera/camera_sample.h"
-#include "../core/imageio.h"
 /*
 // ---------------------------------------------------------------------------
 */
@@ -77,6 +79,36 @@ Sampler::Sampler (int spp) :
 /*
 // ---------------------------------------------------------------------------
 */
+auto Sampler::StartPixelSample (int x, int y, uint64_t index) -> void
+{
+  dimension_ = 0;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Sampler::StartDimension (int dimension) -> void
+{
+  dimension_ = dimension;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto CreateSampler (SamplerType type, int spp, int seed)
+  -> std::unique_ptr <Sampler>
+{
+  if (type == SamplerType::kRandom)
+  {
+    return std::unique_ptr <Sampler> (new RandomSampler (seed));
+  }
+  if (type == SamplerType::kBlueNoise)
+  {
+    return std::unique_ptr <Sampler> (new BlueNoiseSampler (spp, seed));
+  }
+  return std::unique_ptr <Sampler> (new SobolSampler (spp, seed));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 }  // namespace niepce
 /*
 // ---------------------------------------------------------------------------
@@ -15,6 +15,7 @@
 #include "../core/point3f.h"
 #include "../core/vector2f.h"
 #include "../core/vector3f.h"
+#include "../core/render_settings.h"
 /*
 // ---------------------------------------------------------------------------
 */
@@ -71,12 +72,64 @@ public:
    */
   virtual auto Next2f () -> Point2f = 0;
 
+  /*!
+   * @fn void StartPixelSample (int, int, uint64_t)
+   * @brief Start the sample of the pixel.
+   * @param[in] x
+   * @param[in] y
+   * @param[in] index
+   *    The index of the sample in the pixel.
+   * @return
+   * @exception none
+   * @details The following samples are taken from the first dimension.
+   */
+  virtual auto StartPixelSample (int x, int y, uint64_t index) -> void;
+
+  /*!
+   * @fn void StartDimension (int)
+   * @brief Take the following samples from the dimension.
+   * @param[in] dimension
+   * @return
+   * @exception none
+   * @details It keeps the dimensions of each use fixed even if some of
+   *          them are skipped in a path.
+   */
+  virtual auto StartDimension (int dimension) -> void;
+
+  /*!
+   * @fn std::unique_ptr <Sampler> Clone (int)
+   * @brief Return the copy of this sampler.
+   * @param[in] seed
+   * @return
+   * @exception none
+   * @details Each thread must use its own copy.
+   */
+  virtual auto Clone (int seed) const -> std::unique_ptr <Sampler> = 0;
+
 protected:
   const int spp_; // Sample per pixel
+  int dimension_ = 0;
 }; // class Sampler
 /*
 // ---------------------------------------------------------------------------
 */
+/*!
+ * @fn std::unique_ptr <Sampler> CreateSampler (SamplerType, int, int)
+ * @brief Create the sampler of the type.
+ * @param[in] type
+ * @param[in] spp
+ * @param[in] seed
+ *    Samplers of the same seed draw the same samples for each pixel, sample
+ *    index and dimension.
+ * @return
+ * @exception none
+ * @details
+ */
+auto CreateSampler (SamplerType type, int spp, int seed)
+  -> std::unique_ptr <Sampler>;
+/*
+// ---------------------------------------------------------------------------
+*/
 }  // namespace niepce
 /*
 // ---------------------------------------------------------------------------
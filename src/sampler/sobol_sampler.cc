@@ -0,0 +1,162 @@
+/*!
+ * @file sobol_sampler.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "sobol_sampler.h"
+#include "../core/point2f.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+// Direction numbers of the first two dimensions. The first one is the van der
+// Corput sequence, the second one follows the primitive polynomial x + 1.
+auto DirectionNumbers () -> const std::array <std::array <uint32_t, 32>, 2>&
+{
+  static const auto directions = []
+  {
+    std::array <std::array <uint32_t, 32>, 2> v;
+    uint32_t m = 1;
+    for (int i = 0; i < 32; ++i)
+    {
+      v[0][i] = 1u << (31 - i);
+      v[1][i] = m << (31 - i);
+      m = (m << 1) ^ m;
+    }
+    return v;
+  } ();
+  return directions;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Finalizer of MurmurHash3.
+auto MixBits (uint64_t v) -> uint64_t
+{
+  v ^= (v >> 31);
+  v *= 0x7fb5d329728ea185;
+  v ^= (v >> 27);
+  v *= 0x81dadef4bc2dd44d;
+  v ^= (v >> 33);
+  return v;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ToFloat (uint32_t x) -> Float
+{
+  // 2^-32
+  return std::fmin (x * 2.3283064365386963e-10, 1.0 - kEpsilon);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+auto HashSeed (uint32_t a, uint32_t b) -> uint32_t
+{
+  return static_cast <uint32_t>
+    (MixBits ((static_cast <uint64_t> (a) << 32) | b));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SobolSample (uint32_t index, int dimension) -> uint32_t
+{
+  const auto& v = DirectionNumbers ()[dimension];
+  uint32_t x = 0;
+  for (int i = 0; index != 0; index >>= 1, ++i)
+  {
+    if (index & 1) { x ^= v[i]; }
+  }
+  return x;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto NestedUniformScramble (uint32_t x, uint32_t seed) -> uint32_t
+{
+  x = ReverseBits32 (x);
+  x += seed;
+  x ^= x * 0x6c50b47c;
+  x ^= x * 0xb82f1e52;
+  x ^= x * 0xc7afe638;
+  x ^= x * 0x8d22f6e6;
+  return ReverseBits32 (x);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+SobolSampler::SobolSampler (int spp, uint32_t seed) :
+  Sampler (spp),
+  seed_   (seed)
+{}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SobolSampler::Next1f () -> Float
+{
+  return ToFloat (Sample (dimension_++)[0]);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SobolSampler::Next2f () -> Point2f
+{
+  const auto s = Sample (dimension_);
+  dimension_ += 2;
+  return Point2f (ToFloat (s[0]), ToFloat (s[1]));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SobolSampler::StartPixelSample (int x, int y, uint64_t index) -> void
+{
+  Sampler::StartPixelSample (x, y, index);
+  pixel_seed_ = HashSeed (HashSeed (seed_, x), y);
+  index_      = static_cast <uint32_t> (index);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SobolSampler::Clone (int seed) const -> std::unique_ptr <Sampler>
+{
+  return std::unique_ptr <Sampler> (new SobolSampler (*this));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SobolSampler::Sample (int dimension) const -> std::array <uint32_t, 2>
+{
+  return ScrambledSample (HashSeed (pixel_seed_, dimension));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SobolSampler::ScrambledSample (uint32_t seed) const
+  -> std::array <uint32_t, 2>
+{
+  const auto index = NestedUniformScramble (index_, seed);
+  return {{NestedUniformScramble (SobolSample (index, 0), HashSeed (seed, 0)),
+           NestedUniformScramble (SobolSample (index, 1), HashSeed (seed, 1))}};
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
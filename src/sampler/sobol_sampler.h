@@ -0,0 +1,172 @@
+/*!
+ * @file sobol_sampler.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _SOBOL_SAMPLER_H_
+#define _SOBOL_SAMPLER_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "../core/niepce.h"
+#include "sampler.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn uint32_t HashSeed (uint32_t, uint32_t)
+ * @brief Return the hash of the pair to derive seeds of scrambling.
+ * @param[in] a
+ * @param[in] b
+ * @return
+ * @exception none
+ * @details
+ */
+auto HashSeed (uint32_t a, uint32_t b) -> uint32_t;
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn uint32_t SobolSample (uint32_t, int)
+ * @brief Return the sample of the Sobol sequence as 32 bits fixed point.
+ * @param[in] index
+ * @param[in] dimension
+ *    0 or 1.
+ * @return
+ * @exception none
+ * @details
+ */
+auto SobolSample (uint32_t index, int dimension) -> uint32_t;
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn uint32_t NestedUniformScramble (uint32_t, uint32_t)
+ * @brief Owen scramble the bits of the value by the hash of the seed.
+ * @param[in] x
+ *    The value whose most significant bit is the first digit.
+ * @param[in] seed
+ * @return
+ * @exception none
+ * @details Laine-Karras style permutation, each bit is flipped by the hash of
+ *          the more significant bits.
+ */
+auto NestedUniformScramble (uint32_t x, uint32_t seed) -> uint32_t;
+//! ----------------------------------------------------------------------------
+//! @class SobolSampler
+//! @brief Owen-scrambled Sobol sampler padded by 2D.
+//! @details Each Next2f () takes the first two dimensions of the Sobol
+//!          sequence, which are a (0, 2)-sequence. The sample index is
+//!          shuffled and the values are scrambled by the hash of the pixel
+//!          and the dimension, so that every pair of dimensions is well
+//!          stratified in each pixel and independent of the other pairs.
+//! ----------------------------------------------------------------------------
+class SobolSampler : public Sampler
+{
+public:
+  //! The default class constructor.
+  SobolSampler () = delete;
+
+  //! The constructor takes the number of samples and the seed.
+  SobolSampler (int spp, uint32_t seed);
+
+  //! The copy constructor of the class.
+  SobolSampler (const SobolSampler& sampler) = default;
+
+  //! The move constructor of the class.
+  SobolSampler (SobolSampler&& sampler) = default;
+
+  //! The default class destructor.
+  virtual ~SobolSampler () = default;
+
+  //! The copy assignment operator of the class.
+  auto operator = (const SobolSampler& sampler) -> SobolSampler& = delete;
+
+  //! The move assignment operator of the class.
+  auto operator = (SobolSampler&& sampler) -> SobolSampler& = delete;
+
+public:
+  /*!
+   * @fn Float Next1f ()
+   * @brief
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Next1f () -> Float override;
+
+  /*!
+   * @fn Point2f Next2f ()
+   * @brief
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Next2f () -> Point2f override;
+
+  /*!
+   * @fn void StartPixelSample (int, int, uint64_t)
+   * @brief
+   * @param[in] x
+   * @param[in] y
+   * @param[in] index
+   * @return
+   * @exception none
+   * @details
+   */
+  auto StartPixelSample (int x, int y, uint64_t index) -> void override;
+
+  /*!
+   * @fn std::unique_ptr <Sampler> Clone (int)
+   * @brief
+   * @param[in] seed
+   *    It is not used, so that copies draw the same samples for each pixel.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Clone (int seed) const -> std::unique_ptr <Sampler> override;
+
+protected:
+  /*!
+   * @fn std::array <uint32_t, 2> Sample (int)
+   * @brief Return the sample of the pair of dimensions as fixed point.
+   * @param[in] dimension
+   * @return
+   * @exception none
+   * @details
+   */
+  virtual auto Sample (int dimension) const -> std::array <uint32_t, 2>;
+
+  /*!
+   * @fn std::array <uint32_t, 2> ScrambledSample (uint32_t)
+   * @brief Return the current sample scrambled by the seed.
+   * @param[in] seed
+   * @return
+   * @exception none
+   * @details
+   */
+  auto ScrambledSample (uint32_t seed) const -> std::array <uint32_t, 2>;
+
+protected:
+  const uint32_t seed_;
+
+private:
+  uint32_t pixel_seed_ = 0;
+  uint32_t index_      = 0;
+}; // class SobolSampler
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _SOBOL_SAMPLER_H_
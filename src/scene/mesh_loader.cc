@@ -0,0 +1,96 @@
+/*!
+ * @file mesh_loader.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "mesh_loader.h"
+#include "obj_reader.h"
+#include "ply_reader.h"
+#include "../core/profiler.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ReadMesh
+(
+ const std::string& filename,
+ MeshFormat         format,
+ IndexedMesh*       mesh
+)
+  -> bool
+{
+  if (format == MeshFormat::kPly) { return ReadPly (filename, mesh); }
+  return ReadObj (filename, mesh);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+auto LoadMesh
+(
+ const std::string& filename,
+ MeshFormat         format,
+ IndexedMesh*       mesh
+)
+  -> bool
+{
+  const auto cache = MeshCacheFilename (filename);
+  {
+    ProfileScope scope ("mesh_cache");
+    if (ReadMeshCache (cache, filename, mesh)) { return true; }
+  }
+
+  {
+    ProfileScope scope ("parse");
+    if (!ReadMesh (filename, format, mesh)) { return false; }
+  }
+
+  if (!WriteMeshCache (cache, filename, *mesh))
+  {
+    std::cerr << "Warning: Could not write the mesh cache " << cache
+              << std::endl;
+  }
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ConvertMesh (const std::string& filename) -> bool
+{
+  const auto extension = filename.substr (filename.find_last_of ('.') + 1);
+  const auto format = extension == "ply" ? MeshFormat::kPly : MeshFormat::kObj;
+
+  IndexedMesh mesh;
+  if (!ReadMesh (filename, format, &mesh)) { return false; }
+
+  const auto cache = MeshCacheFilename (filename);
+  if (!WriteMeshCache (cache, filename, mesh))
+  {
+    std::cerr << "Could not write the mesh cache " << cache << std::endl;
+    return false;
+  }
+  std::cout << filename << " -> " << cache << " ("
+            << mesh.num_triangles << " triangles)" << std::endl;
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
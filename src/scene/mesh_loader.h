@@ -0,0 +1,77 @@
+/*!
+ * @file mesh_loader.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _MESH_LOADER_H_
+#define _MESH_LOADER_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "../core/niepce.h"
+#include "../shape/mesh_cache.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @enum MeshFormat
+ * @brief The formats of the mesh files.
+ */
+enum class MeshFormat : uint8_t
+{
+  kObj,
+  kPly
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn bool LoadMesh (const std::string&, MeshFormat, IndexedMesh*)
+ * @brief Load a mesh file through its cache.
+ * @param[in] filename
+ *    The mesh file.
+ * @param[in] format
+ *    The format of the file.
+ * @param[out] mesh
+ *    The mesh of all the shapes in the file.
+ * @return False if the file is not loaded.
+ * @exception none
+ * @details The cache next to the file is mapped if it is up to date.
+ *          Otherwise the file is parsed and the cache is written for the
+ *          next time.
+ */
+auto LoadMesh
+(
+ const std::string& filename,
+ MeshFormat         format,
+ IndexedMesh*       mesh
+)
+  -> bool;
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn bool ConvertMesh (const std::string&)
+ * @brief Parse a mesh file and write its cache next to it.
+ * @param[in] filename
+ *    The mesh file.
+ * @return False if the file is not loaded or the cache is not written.
+ * @exception none
+ * @details The format is given by the extension, .ply or else OBJ.
+ */
+auto ConvertMesh (const std::string& filename) -> bool;
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _MESH_LOADER_H_
@@ -0,0 +1,715 @@
+/*!
+ * @file obj_reader.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "obj_reader.h"
+#include "../core/mapped_file.h"
+#include "../core/thread_pool.h"
+#include <cstring>
+/*
+// ---------------------------------------------------------------------------
+*/
+#define TINYOBJLOADER_IMPLEMENTATION
+// #define TINYOBJLOADER_USE_DOUBLE
+#include "../ext/tinyobjloader/tiny_obj_loader.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+// The attributes a face vertex refers to.
+enum Attribute
+{
+  kPosition,
+  kNormal,
+  kTexcoord,
+  kNumAttributes
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+// A vertex of a face. A bit of relative is set if the index of the
+// attribute was negative, i.e. relative to the end of its chunk so far.
+struct ObjVertex
+{
+  std::array <int, kNumAttributes> index;
+  int relative;
+};
+
+// A face of more than three vertices, which are in polygon_vertices of the
+// chunk. It comes after the first `before` triangles of the chunk.
+struct ObjPolygon
+{
+  std::size_t before;
+  std::size_t first;
+  std::size_t count;
+  std::size_t num_triangles;
+};
+
+// The arrays parsed from a chunk of lines. The relative indices are resolved
+// with the counts of the chunk, and the fixups list the indices which need
+// the counts of the preceding chunks to be added.
+struct ObjChunk
+{
+  std::vector <Point3f>         positions;
+  std::vector <Vector3f>        normals;
+  std::vector <Point2f>         texcoords;
+  std::vector <TriangleIndices> triangles;
+  std::vector <ObjVertex>       polygon_vertices;
+  std::vector <ObjPolygon>      polygons;
+  std::vector <TriangleIndices> polygon_triangles;
+  std::vector <std::size_t>     triangle_fixups[kNumAttributes];
+  std::vector <std::size_t>     polygon_fixups[kNumAttributes];
+  bool                          failed = false;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+inline auto IsSpace (char c) -> bool { return c == ' ' || c == '\t'; }
+inline auto IsDigit (char c) -> bool
+{
+  return static_cast <unsigned int> (c - '0') < 10u;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+inline auto SkipSpaces (const char* p, const char* end) -> const char*
+{
+  while (p < end && IsSpace (*p)) { ++p; }
+  return p;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Find the end of a token, which is a space, a tab or a carriage return.
+inline auto FindTokenEnd (const char* p, const char* end) -> const char*
+{
+  while (p < end && !IsSpace (*p) && *p != '\r') { ++p; }
+  return p;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// tryParseDouble of tinyobjloader on [s, s_end). The arithmetic must stay the
+// same, so that the floats are identical to the ones it gives.
+auto ParseDouble (const char* s, const char* s_end, double* result) -> bool
+{
+  if (s >= s_end) { return false; }
+
+  double mantissa = 0.0;
+  int    exponent = 0;
+  char   sign     = '+';
+  char   exp_sign = '+';
+  const char* curr = s;
+  int read = 0;
+
+  if (*curr == '+' || *curr == '-') { sign = *curr++; }
+  else if (!IsDigit (*curr)) { return false; }
+
+  // The integer part.
+  while (curr != s_end && IsDigit (*curr))
+  {
+    mantissa *= 10;
+    mantissa += static_cast <int> (*curr - '0');
+    ++curr;
+    ++read;
+  }
+  if (read == 0) { return false; }
+
+  if (curr != s_end && (*curr == '.' || *curr == 'e' || *curr == 'E'))
+  {
+    // The decimal part.
+    if (*curr == '.')
+    {
+      static const double pow_lut[] =
+      {
+        1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0.0000001,
+      };
+      const int lut_entries = sizeof pow_lut / sizeof pow_lut[0];
+
+      ++curr;
+      read = 1;
+      while (curr != s_end && IsDigit (*curr))
+      {
+        mantissa += static_cast <int> (*curr - '0') *
+          (read < lut_entries ? pow_lut[read] : std::pow (10.0, -read));
+        ++read;
+        ++curr;
+      }
+    }
+
+    // The exponent part.
+    if (curr != s_end && (*curr == 'e' || *curr == 'E'))
+    {
+      ++curr;
+      if (curr != s_end && (*curr == '+' || *curr == '-'))
+      {
+        exp_sign = *curr++;
+      }
+      else if (curr == s_end || !IsDigit (*curr)) { return false; }
+
+      read = 0;
+      while (curr != s_end && IsDigit (*curr))
+      {
+        exponent *= 10;
+        exponent += static_cast <int> (*curr - '0');
+        ++curr;
+        ++read;
+      }
+      exponent *= (exp_sign == '+' ? 1 : -1);
+      if (read == 0) { return false; }
+    }
+  }
+
+  *result = (sign == '+' ? 1 : -1) *
+    (exponent ? std::ldexp (mantissa * std::pow (5.0, exponent), exponent)
+              : mantissa);
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Parse the next number of a line, or return the default value.
+inline auto ParseReal (const char** token, const char* end, double value)
+  -> Float
+{
+  const char* begin = SkipSpaces (*token, end);
+  const char* last  = FindTokenEnd (begin, end);
+  ParseDouble (begin, last, &value);
+  *token = last;
+  return static_cast <Float> (value);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// atoi on [*token, end), then skip to the next separator of the indices.
+inline auto ParseIndex (const char** token, const char* end) -> int
+{
+  const char* p = SkipSpaces (*token, end);
+  bool negative = false;
+  if (p < end && (*p == '+' || *p == '-')) { negative = (*p++ == '-'); }
+
+  int value = 0;
+  while (p < end && IsDigit (*p)) { value = value * 10 + (*p++ - '0'); }
+
+  p = *token;
+  while (p < end && *p != '/' && !IsSpace (*p) && *p != '\r') { ++p; }
+  *token = p;
+  return negative ? -value : value;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Make an index zero based. A negative one is relative to the count so far,
+// which is marked to add the counts of the preceding chunks later.
+inline auto FixIndex (int idx, std::size_t n, Attribute a, ObjVertex* vertex)
+  -> bool
+{
+  if (idx > 0) { vertex->index[a] = idx - 1; return true; }
+  if (idx == 0) { return false; }
+  vertex->index[a]  = static_cast <int> (n) + idx;
+  vertex->relative |= 1 << a;
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// parseTriple of tinyobjloader: i, i/j/k, i//k, i/j
+auto ParseTriple
+(
+ const char**    token,
+ const char*     end,
+ const ObjChunk& chunk,
+ ObjVertex*      vertex
+)
+  -> bool
+{
+  vertex->index    = {-1, -1, -1};
+  vertex->relative = 0;
+
+  const auto np = chunk.positions.size ();
+  const auto nn = chunk.normals.size ();
+  const auto nt = chunk.texcoords.size ();
+
+  if (!FixIndex (ParseIndex (token, end), np, kPosition, vertex))
+  {
+    return false;
+  }
+  if (*token == end || **token != '/') { return true; }
+  ++*token;
+
+  // i//k
+  if (*token != end && **token == '/')
+  {
+    ++*token;
+    return FixIndex (ParseIndex (token, end), nn, kNormal, vertex);
+  }
+
+  // i/j/k or i/j
+  if (!FixIndex (ParseIndex (token, end), nt, kTexcoord, vertex))
+  {
+    return false;
+  }
+  if (*token == end || **token != '/') { return true; }
+  ++*token;
+  return FixIndex (ParseIndex (token, end), nn, kNormal, vertex);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+inline auto Indices (TriangleIndices* triangle, int a) -> std::array <int, 3>&
+{
+  if (a == kPosition) { return triangle->position; }
+  if (a == kNormal)   { return triangle->normal; }
+  return triangle->texcoord;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ParseFace
+(
+ const char*              token,
+ const char*              end,
+ std::vector <ObjVertex>* face,
+ ObjChunk*                chunk
+)
+  -> bool
+{
+  face->clear ();
+  token = SkipSpaces (token, end);
+  while (token < end)
+  {
+    ObjVertex vertex;
+    if (!ParseTriple (&token, end, *chunk, &vertex)) { return false; }
+    face->push_back (vertex);
+    while (token < end && (IsSpace (*token) || *token == '\r')) { ++token; }
+  }
+
+  // A face must have three or more vertices.
+  if (face->size () == 3)
+  {
+    TriangleIndices triangle;
+    const auto t = chunk->triangles.size ();
+    for (int c = 0; c < 3; ++c)
+    {
+      const auto& vertex = (*face)[c];
+      for (int a = 0; a < kNumAttributes; ++a)
+      {
+        Indices (&triangle, a)[c] = vertex.index[a];
+        if (vertex.relative & (1 << a))
+        {
+          chunk->triangle_fixups[a].push_back (t * 3 + c);
+        }
+      }
+    }
+    chunk->triangles.push_back (triangle);
+  }
+  else if (face->size () > 3)
+  {
+    const auto first = chunk->polygon_vertices.size ();
+    for (std::size_t k = 0; k < face->size (); ++k)
+    {
+      for (int a = 0; a < kNumAttributes; ++a)
+      {
+        if ((*face)[k].relative & (1 << a))
+        {
+          chunk->polygon_fixups[a].push_back (first + k);
+        }
+      }
+      chunk->polygon_vertices.push_back ((*face)[k]);
+    }
+    chunk->polygons.push_back
+      ({chunk->triangles.size (), first, face->size (), 0});
+  }
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// The loop of LoadObj of tinyobjloader over the lines of [begin, end), where
+// groups, objects, materials, smoothing groups and tags are ignored.
+auto ParseChunk (const char* begin, const char* end, ObjChunk* chunk) -> void
+{
+  std::vector <ObjVertex> face;
+  for (const char* line = begin; line < end;)
+  {
+    const char* line_end = line;
+    while (line_end < end && *line_end != '\n' && *line_end != '\r')
+    {
+      ++line_end;
+    }
+
+    const char* token = SkipSpaces (line, line_end);
+    const auto  size  = line_end - token;
+    if (size >= 2 && token[0] == 'v' && IsSpace (token[1]))
+    {
+      token += 2;
+      const auto x = ParseReal (&token, line_end, 0.0);
+      const auto y = ParseReal (&token, line_end, 0.0);
+      const auto z = ParseReal (&token, line_end, 0.0);
+      chunk->positions.emplace_back (x, y, z);
+    }
+    else if (size >= 3 && token[0] == 'v' && token[1] == 'n'
+             && IsSpace (token[2]))
+    {
+      token += 3;
+      const auto x = ParseReal (&token, line_end, 0.0);
+      const auto y = ParseReal (&token, line_end, 0.0);
+      const auto z = ParseReal (&token, line_end, 0.0);
+      chunk->normals.emplace_back (x, y, z);
+    }
+    else if (size >= 3 && token[0] == 'v' && token[1] == 't'
+             && IsSpace (token[2]))
+    {
+      token += 3;
+      const auto u = ParseReal (&token, line_end, 0.0);
+      const auto v = ParseReal (&token, line_end, 0.0);
+      chunk->texcoords.emplace_back (u, v);
+    }
+    else if (size >= 2 && token[0] == 'f' && IsSpace (token[1]))
+    {
+      if (!ParseFace (token + 2, line_end, &face, chunk))
+      {
+        chunk->failed = true;
+        return ;
+      }
+    }
+
+    line = line_end + 1;
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Whether the index refers to one of the count elements. Only the position
+// is required, and the others may be -1.
+inline auto IsInRange (int index, std::size_t count, int attribute) -> bool
+{
+  if (index == -1) { return attribute != kPosition; }
+  return index >= 0 && static_cast <std::size_t> (index) < count;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Whether every index of the faces of the chunk refers to the merged arrays.
+auto IsInRange
+(
+ const ObjChunk&                                 chunk,
+ const std::array <std::size_t, kNumAttributes>& counts
+)
+  -> bool
+{
+  for (auto triangle : chunk.triangles)
+  {
+    for (int a = 0; a < kNumAttributes; ++a)
+    {
+      for (const auto index : Indices (&triangle, a))
+      {
+        if (!IsInRange (index, counts[a], a)) { return false; }
+      }
+    }
+  }
+  for (const auto& vertex : chunk.polygon_vertices)
+  {
+    for (int a = 0; a < kNumAttributes; ++a)
+    {
+      if (!IsInRange (vertex.index[a], counts[a], a)) { return false; }
+    }
+  }
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Triangulate the polygons of the chunks as tinyobjloader does. It needs the
+// positions of the whole mesh.
+auto TriangulatePolygons
+(
+ const std::vector <Point3f>& positions,
+ std::vector <ObjChunk>*      chunks
+)
+  -> void
+{
+  std::vector <tinyobj::real_t> v;
+  v.reserve (positions.size () * 3);
+  for (const auto& p : positions)
+  {
+    v.push_back (p.X ());
+    v.push_back (p.Y ());
+    v.push_back (p.Z ());
+  }
+
+  const std::vector <tinyobj::tag_t> tags;
+  for (auto& chunk : *chunks)
+  {
+    for (auto& polygon : chunk.polygons)
+    {
+      tinyobj::face_t face;
+      for (std::size_t k = 0; k < polygon.count; ++k)
+      {
+        const auto& index = chunk.polygon_vertices[polygon.first + k].index;
+        face.vertex_indices.emplace_back
+          (index[kPosition], index[kTexcoord], index[kNormal]);
+      }
+
+      tinyobj::shape_t shape;
+      tinyobj::exportFaceGroupToShape
+        (&shape, std::vector <tinyobj::face_t> (1, face), tags, -1, "",
+         true, v);
+
+      const auto& indices = shape.mesh.indices;
+      for (std::size_t i = 0; i + 2 < indices.size (); i += 3)
+      {
+        TriangleIndices triangle;
+        for (int c = 0; c < 3; ++c)
+        {
+          triangle.position[c] = indices[i + c].vertex_index;
+          triangle.normal[c]   = indices[i + c].normal_index;
+          triangle.texcoord[c] = indices[i + c].texcoord_index;
+        }
+        chunk.polygon_triangles.push_back (triangle);
+      }
+      polygon.num_triangles = indices.size () / 3;
+    }
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ReadObj
+(
+ const std::string& filename,
+ IndexedMesh*       mesh,
+ std::size_t        min_chunk_size
+)
+  -> bool
+{
+  const MappedFile file (filename.c_str ());
+  if (!file.IsOpen ())
+  {
+    std::cerr << "Cannot open file [" << filename << "]" << std::endl;
+    return false;
+  }
+
+  // Split the file after line feeds.
+  const char* data = file.Data ();
+  const auto  size = file.Size ();
+  const auto  num_threads
+    = static_cast <std::size_t> (std::max (1u, std::thread::hardware_concurrency ()));
+  const auto  num_splits
+    = std::max <std::size_t> (1, std::min (num_threads * 4, size / min_chunk_size));
+
+  std::vector <const char*> bounds (1, data);
+  for (std::size_t i = 1; i < num_splits; ++i)
+  {
+    const char* p = std::max (data + size * i / num_splits, bounds.back ());
+    const void* lf = std::memchr (p, '\n', data + size - p);
+    if (lf == nullptr) { break; }
+    bounds.push_back (static_cast <const char*> (lf) + 1);
+  }
+  bounds.push_back (data + size);
+
+  const int num_chunks = static_cast <int> (bounds.size () - 1);
+  std::vector <ObjChunk> chunks (num_chunks);
+  ParallelFor (num_chunks, [&] (int begin, int end)
+  {
+    for (int i = begin; i < end; ++i)
+    {
+      ParseChunk (bounds[i], bounds[i + 1], &chunks[i]);
+    }
+  });
+
+  // The offsets of the chunks in the merged arrays.
+  std::vector <std::array <std::size_t, kNumAttributes>> bases (num_chunks);
+  std::array <std::size_t, kNumAttributes> counts = {0, 0, 0};
+  bool has_polygons = false;
+  for (int i = 0; i < num_chunks; ++i)
+  {
+    if (chunks[i].failed)
+    {
+      std::cerr << filename << ": Failed parse `f' line"
+                << "(e.g. zero value for face index)." << std::endl;
+      return false;
+    }
+    bases[i] = counts;
+    counts[kPosition] += chunks[i].positions.size ();
+    counts[kNormal]   += chunks[i].normals.size ();
+    counts[kTexcoord] += chunks[i].texcoords.size ();
+    has_polygons = has_polygons || !chunks[i].polygons.empty ();
+  }
+
+  // Concatenate the vertex attributes, and add the offsets to the relative
+  // indices. Then check the indices, so that the triangles never refer out
+  // of the arrays. A relative index must not resolve to -1, which means no
+  // attribute.
+  std::vector <char> out_of_range (num_chunks, 0);
+  const auto arrays = std::make_shared <MeshArrays> ();
+  arrays->positions.resize (counts[kPosition]);
+  arrays->normals.resize   (counts[kNormal]);
+  arrays->texcoords.resize (counts[kTexcoord]);
+  ParallelFor (num_chunks, [&] (int begin, int end)
+  {
+    for (int i = begin; i < end; ++i)
+    {
+      auto& chunk = chunks[i];
+      const auto& base = bases[i];
+      std::copy (chunk.positions.begin (), chunk.positions.end (),
+                 arrays->positions.begin () + base[kPosition]);
+      std::copy (chunk.normals.begin (), chunk.normals.end (),
+                 arrays->normals.begin () + base[kNormal]);
+      std::copy (chunk.texcoords.begin (), chunk.texcoords.end (),
+                 arrays->texcoords.begin () + base[kTexcoord]);
+
+      for (int a = 0; a < kNumAttributes; ++a)
+      {
+        const auto offset = static_cast <int> (base[a]);
+        for (const auto slot : chunk.triangle_fixups[a])
+        {
+          auto& index = Indices (&chunk.triangles[slot / 3], a)[slot % 3];
+          index += offset;
+          if (index < 0) { out_of_range[i] = 1; }
+        }
+        for (const auto slot : chunk.polygon_fixups[a])
+        {
+          auto& index = chunk.polygon_vertices[slot].index[a];
+          index += offset;
+          if (index < 0) { out_of_range[i] = 1; }
+        }
+      }
+      if (!IsInRange (chunk, counts)) { out_of_range[i] = 1; }
+    }
+  });
+  for (int i = 0; i < num_chunks; ++i)
+  {
+    if (out_of_range[i])
+    {
+      std::cerr << filename << ": A face index is out of range." << std::endl;
+      return false;
+    }
+  }
+
+  if (has_polygons) { TriangulatePolygons (arrays->positions, &chunks); }
+
+  // Concatenate the triangles, where those of the polygons are put in the
+  // order of the faces.
+  std::vector <std::size_t> triangle_bases (num_chunks + 1, 0);
+  for (int i = 0; i < num_chunks; ++i)
+  {
+    triangle_bases[i + 1] = triangle_bases[i]
+                            + chunks[i].triangles.size ()
+                            + chunks[i].polygon_triangles.size ();
+  }
+  arrays->triangles.resize (triangle_bases.back ());
+  ParallelFor (num_chunks, [&] (int begin, int end)
+  {
+    for (int i = begin; i < end; ++i)
+    {
+      const auto& chunk = chunks[i];
+      auto out = arrays->triangles.begin () + triangle_bases[i];
+      auto triangles = chunk.triangles.begin ();
+      auto polygon_triangles = chunk.polygon_triangles.begin ();
+      std::size_t copied = 0;
+      for (const auto& polygon : chunk.polygons)
+      {
+        out = std::copy (triangles + copied, triangles + polygon.before, out);
+        out = std::copy (polygon_triangles,
+                         polygon_triangles + polygon.num_triangles,
+                         out);
+        polygon_triangles += polygon.num_triangles;
+        copied = polygon.before;
+      }
+      std::copy (triangles + copied, chunk.triangles.end (), out);
+    }
+  });
+
+  *mesh = CreateIndexedMesh (arrays);
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ReadObjWithTinyObj (const std::string& filename, IndexedMesh* mesh)
+  -> bool
+{
+  tinyobj::attrib_t attrib;
+  std::vector<tinyobj::shape_t> shapes;
+  std::vector<tinyobj::material_t> materials;
+
+  // Load .obj
+  std::string err;
+  bool ret = tinyobj::LoadObj (&attrib,
+                               &shapes,
+                               &materials,
+                               &err,
+                               filename.c_str());
+  // Error check.
+  if (!err.empty() || !ret) { std::cerr << err << std::endl; return false; }
+
+  const auto arrays = std::make_shared <MeshArrays> ();
+  const auto& v = attrib.vertices;
+  for (std::size_t i = 0; i + 2 < v.size (); i += 3)
+  {
+    arrays->positions.emplace_back (v[i], v[i + 1], v[i + 2]);
+  }
+  const auto& n = attrib.normals;
+  for (std::size_t i = 0; i + 2 < n.size (); i += 3)
+  {
+    arrays->normals.emplace_back (n[i], n[i + 1], n[i + 2]);
+  }
+  const auto& t = attrib.texcoords;
+  for (std::size_t i = 0; i + 1 < t.size (); i += 2)
+  {
+    arrays->texcoords.emplace_back (t[i], t[i + 1]);
+  }
+
+  // Loop over shapes.
+  for (const auto& s : shapes)
+  {
+    size_t index_offset = 0;
+    for (size_t f = 0; f < s.mesh.num_face_vertices.size(); f++)
+    {
+      int fv = s.mesh.num_face_vertices[f];
+      if (fv != 3)
+      {
+        std::cerr << filename << ": Triangle is only supported." << std::endl;
+        return false;
+      }
+
+      TriangleIndices indices;
+      for (int i = 0; i < 3; ++i)
+      {
+        const auto& index = s.mesh.indices[index_offset + i];
+        indices.position[i] = index.vertex_index;
+        indices.normal[i]   = index.normal_index;
+        indices.texcoord[i] = index.texcoord_index;
+      }
+      arrays->triangles.push_back (indices);
+      index_offset += fv;
+    }
+  }
+
+  *mesh = CreateIndexedMesh (arrays);
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,71 @@
+/*!
+ * @file obj_reader.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _OBJ_READER_H_
+#define _OBJ_READER_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "../core/niepce.h"
+#include "../shape/mesh_cache.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn bool ReadObj (const std::string&, IndexedMesh*, std::size_t)
+ * @brief Parse an OBJ file on the thread pool.
+ * @param[in] filename
+ *    The OBJ file.
+ * @param[out] mesh
+ *    The mesh of all the shapes in the file.
+ * @param[in] min_chunk_size
+ *    The smallest chunk worth a task, in bytes.
+ * @return False if the file is not loaded.
+ * @exception none
+ * @details The mapped file is split on line boundaries into chunks which
+ *          are parsed in parallel, and their arrays are concatenated. The
+ *          numbers are parsed with the same arithmetic as tinyobjloader,
+ *          and polygons are triangulated by it, so that the mesh is the
+ *          same as ReadObjWithTinyObj gives. Only the vertices, the normals,
+ *          the texcoords and the faces are read; materials are not.
+ */
+auto ReadObj
+(
+ const std::string& filename,
+ IndexedMesh*       mesh,
+ std::size_t        min_chunk_size = 1 << 20
+)
+  -> bool;
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn bool ReadObjWithTinyObj (const std::string&, IndexedMesh*)
+ * @brief Parse an OBJ file with tinyobjloader on this thread.
+ * @param[in] filename
+ *    The OBJ file.
+ * @param[out] mesh
+ *    The mesh of all the shapes in the file.
+ * @return False if the file is not loaded.
+ * @exception none
+ * @details It is the reference which ReadObj is validated against.
+ */
+auto ReadObjWithTinyObj (const std::string& filename, IndexedMesh* mesh)
+  -> bool;
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _OBJ_READER_H_
@@ -0,0 +1,569 @@
+/*!
+ * @file ply_reader.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "ply_reader.h"
+#include <cstdio>
+#include <cstring>
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+enum class PlyType : uint8_t
+{
+  kInt8,
+  kUint8,
+  kInt16,
+  kUint16,
+  kInt32,
+  kUint32,
+  kFloat32,
+  kFloat64,
+  kUnknown
+};
+
+struct PlyProperty
+{
+  std::string name;
+  PlyType     type       = PlyType::kUnknown; //!< The value, or the items.
+  PlyType     count_type = PlyType::kUnknown; //!< The count of a list.
+  bool        is_list    = false;
+};
+
+struct PlyElement
+{
+  std::string               name;
+  uint64_t                  count = 0;
+  std::vector <PlyProperty> properties;
+};
+
+// The size of the reads from the file.
+const std::size_t kBlockSize = 1 << 24;
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ParseType (const std::string& name) -> PlyType
+{
+  if (name == "char"   || name == "int8")    { return PlyType::kInt8;    }
+  if (name == "uchar"  || name == "uint8")   { return PlyType::kUint8;   }
+  if (name == "short"  || name == "int16")   { return PlyType::kInt16;   }
+  if (name == "ushort" || name == "uint16")  { return PlyType::kUint16;  }
+  if (name == "int"    || name == "int32")   { return PlyType::kInt32;   }
+  if (name == "uint"   || name == "uint32")  { return PlyType::kUint32;  }
+  if (name == "float"  || name == "float32") { return PlyType::kFloat32; }
+  if (name == "double" || name == "float64") { return PlyType::kFloat64; }
+  return PlyType::kUnknown;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto TypeSize (PlyType type) -> std::size_t
+{
+  switch (type)
+  {
+    case PlyType::kInt8:
+    case PlyType::kUint8:   return 1;
+    case PlyType::kInt16:
+    case PlyType::kUint16:  return 2;
+    case PlyType::kInt32:
+    case PlyType::kUint32:
+    case PlyType::kFloat32: return 4;
+    case PlyType::kFloat64: return 8;
+    default:                return 0;
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Decode a value, whose bytes are swapped if the file is of the other endian.
+template <typename T>
+inline auto Load (const char* p, bool swap) -> T
+{
+  char bytes[sizeof (T)];
+  std::memcpy (bytes, p, sizeof (T));
+  if (swap) { std::reverse (bytes, bytes + sizeof (T)); }
+  T value;
+  std::memcpy (&value, bytes, sizeof (T));
+  return value;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+inline auto LoadReal (PlyType type, const char* p, bool swap) -> double
+{
+  switch (type)
+  {
+    case PlyType::kInt8:    return Load <int8_t>   (p, swap);
+    case PlyType::kUint8:   return Load <uint8_t>  (p, swap);
+    case PlyType::kInt16:   return Load <int16_t>  (p, swap);
+    case PlyType::kUint16:  return Load <uint16_t> (p, swap);
+    case PlyType::kInt32:   return Load <int32_t>  (p, swap);
+    case PlyType::kUint32:  return Load <uint32_t> (p, swap);
+    case PlyType::kFloat32: return Load <float>    (p, swap);
+    case PlyType::kFloat64: return Load <double>   (p, swap);
+    default:                return 0;
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+inline auto LoadInteger (PlyType type, const char* p, bool swap) -> int64_t
+{
+  switch (type)
+  {
+    case PlyType::kInt8:   return Load <int8_t>   (p, swap);
+    case PlyType::kUint8:  return Load <uint8_t>  (p, swap);
+    case PlyType::kInt16:  return Load <int16_t>  (p, swap);
+    case PlyType::kUint16: return Load <uint16_t> (p, swap);
+    case PlyType::kInt32:  return Load <int32_t>  (p, swap);
+    case PlyType::kUint32: return Load <uint32_t> (p, swap);
+    default: return static_cast <int64_t> (LoadReal (type, p, swap));
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto IsLittleEndian () -> bool
+{
+  const uint16_t one = 1;
+  char first;
+  std::memcpy (&first, &one, 1);
+  return first == 1;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Read the file in large blocks, and hand out contiguous bytes of them.
+class BlockReader
+{
+public:
+  explicit BlockReader (std::FILE* file) : file_ (file), buffer_ (kBlockSize)
+  {}
+
+  //! Return the next n bytes, which are valid until the next call, or
+  //! nullptr if the file ends before them.
+  auto Read (std::size_t n) -> const char*
+  {
+    if (end_ - begin_ < n)
+    {
+      if (n > buffer_.size ()) { return nullptr; }
+      std::memmove (buffer_.data (), buffer_.data () + begin_, end_ - begin_);
+      end_  -= begin_;
+      begin_ = 0;
+      end_  += std::fread (buffer_.data () + end_, 1, buffer_.size () - end_,
+                           file_);
+      if (end_ < n) { return nullptr; }
+    }
+    const char* p = buffer_.data () + begin_;
+    begin_ += n;
+    return p;
+  }
+
+  //! Return the number of elements of the size in a block.
+  auto Capacity (std::size_t size) const -> std::size_t
+  {
+    return buffer_.size () / size;
+  }
+
+private:
+  std::FILE*         file_;
+  std::vector <char> buffer_;
+  std::size_t        begin_ = 0;
+  std::size_t        end_   = 0;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ReadLine (std::FILE* file, std::string* line) -> bool
+{
+  line->clear ();
+  for (int c = std::fgetc (file); c != EOF; c = std::fgetc (file))
+  {
+    if (c == '\n') { return true; }
+    if (c != '\r') { line->push_back (static_cast <char> (c)); }
+  }
+  return !line->empty ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Return the index of the first property of the names, or -1.
+auto FindProperty
+(
+ const PlyElement&                   element,
+ std::initializer_list <const char*> names
+)
+  -> int
+{
+  const auto& properties = element.properties;
+  for (const auto name : names)
+  {
+    for (std::size_t i = 0; i < properties.size (); ++i)
+    {
+      if (properties[i].name == name) { return static_cast <int> (i); }
+    }
+  }
+  return -1;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// The byte offsets of the properties in an element without lists.
+auto Offsets (const PlyElement& element, std::size_t* stride)
+  -> std::vector <std::size_t>
+{
+  std::vector <std::size_t> offsets;
+  *stride = 0;
+  for (const auto& property : element.properties)
+  {
+    offsets.push_back (*stride);
+    *stride += TypeSize (property.type);
+  }
+  return offsets;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto HasList (const PlyElement& element) -> bool
+{
+  for (const auto& property : element.properties)
+  {
+    if (property.is_list) { return true; }
+  }
+  return false;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ReadVertices
+(
+ const PlyElement& element,
+ bool              swap,
+ BlockReader*      reader,
+ MeshArrays*       arrays
+)
+  -> bool
+{
+  if (HasList (element)) { return false; }
+
+  const int p[3] = {FindProperty (element, {"x"}),
+                    FindProperty (element, {"y"}),
+                    FindProperty (element, {"z"})};
+  const int n[3] = {FindProperty (element, {"nx"}),
+                    FindProperty (element, {"ny"}),
+                    FindProperty (element, {"nz"})};
+  const int t[2] =
+  {
+    FindProperty (element, {"u", "s", "texture_u", "texture_s"}),
+    FindProperty (element, {"v", "t", "texture_v", "texture_t"})
+  };
+  if (p[0] < 0 || p[1] < 0 || p[2] < 0) { return false; }
+  const bool has_normals   = n[0] >= 0 && n[1] >= 0 && n[2] >= 0;
+  const bool has_texcoords = t[0] >= 0 && t[1] >= 0;
+
+  const auto& properties = element.properties;
+  std::size_t stride = 0;
+  const auto offsets = Offsets (element, &stride);
+  const auto value = [&] (const char* data, int i) -> Float
+  {
+    return static_cast <Float>
+      (LoadReal (properties[i].type, data + offsets[i], swap));
+  };
+
+  arrays->positions.resize (element.count);
+  if (has_normals)   { arrays->normals.resize (element.count); }
+  if (has_texcoords) { arrays->texcoords.resize (element.count); }
+
+  const auto batch = reader->Capacity (stride);
+  for (uint64_t first = 0; first < element.count; first += batch)
+  {
+    const auto count = std::min <uint64_t> (batch, element.count - first);
+    const char* data = reader->Read (count * stride);
+    if (data == nullptr) { return false; }
+
+    for (uint64_t i = 0; i < count; ++i, data += stride)
+    {
+      const auto v = first + i;
+      arrays->positions[v] = Point3f
+        (value (data, p[0]), value (data, p[1]), value (data, p[2]));
+      if (has_normals)
+      {
+        arrays->normals[v] = Vector3f
+          (value (data, n[0]), value (data, n[1]), value (data, n[2]));
+      }
+      if (has_texcoords)
+      {
+        arrays->texcoords[v] = Point2f (value (data, t[0]), value (data, t[1]));
+      }
+    }
+  }
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Read the faces, or skip the element if indices is -1.
+auto ReadFaces
+(
+ const PlyElement& element,
+ int               indices,
+ bool              swap,
+ BlockReader*      reader,
+ MeshArrays*       arrays
+)
+  -> bool
+{
+  if (indices >= 0) { arrays->triangles.reserve (element.count); }
+
+  for (uint64_t f = 0; f < element.count; ++f)
+  {
+    for (std::size_t i = 0; i < element.properties.size (); ++i)
+    {
+      const auto& property = element.properties[i];
+      const auto  size     = TypeSize (property.type);
+      if (!property.is_list)
+      {
+        if (reader->Read (size) == nullptr) { return false; }
+        continue;
+      }
+
+      const char* data = reader->Read (TypeSize (property.count_type));
+      if (data == nullptr) { return false; }
+      const auto count = LoadInteger (property.count_type, data, swap);
+      if (count < 0) { return false; }
+
+      data = reader->Read (count * size);
+      if (data == nullptr) { return false; }
+      if (static_cast <int> (i) != indices) { continue; }
+
+      // Triangulate as a fan.
+      const auto index = [&] (int64_t k) -> int
+      {
+        return static_cast <int> (LoadInteger (property.type,
+                                               data + k * size,
+                                               swap));
+      };
+      const int first = count >= 3 ? index (0) : 0;
+      for (int64_t k = 1; k + 1 < count; ++k)
+      {
+        TriangleIndices triangle;
+        triangle.position = {first, index (k), index (k + 1)};
+        triangle.normal   = {-1, -1, -1};
+        triangle.texcoord = {-1, -1, -1};
+        arrays->triangles.push_back (triangle);
+      }
+    }
+  }
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SkipElement (const PlyElement& element, bool swap, BlockReader* reader)
+  -> bool
+{
+  if (HasList (element))
+  {
+    return ReadFaces (element, -1, swap, reader, nullptr);
+  }
+
+  std::size_t stride = 0;
+  Offsets (element, &stride);
+  if (stride == 0) { return true; }
+
+  const auto batch = reader->Capacity (stride);
+  for (uint64_t first = 0; first < element.count; first += batch)
+  {
+    const auto count = std::min <uint64_t> (batch, element.count - first);
+    if (reader->Read (count * stride) == nullptr) { return false; }
+  }
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ReadHeader
+(
+ std::FILE*                 file,
+ bool*                      little_endian,
+ std::vector <PlyElement>*  elements,
+ std::string*               error
+)
+  -> bool
+{
+  std::string line;
+  if (!ReadLine (file, &line) || line != "ply")
+  {
+    *error = "Not a PLY file.";
+    return false;
+  }
+
+  while (ReadLine (file, &line))
+  {
+    std::istringstream iss (line);
+    std::string keyword;
+    iss >> keyword;
+    if (keyword == "end_header") { return true; }
+
+    if (keyword == "format")
+    {
+      std::string format;
+      iss >> format;
+      if (format == "binary_little_endian")   { *little_endian = true;  }
+      else if (format == "binary_big_endian") { *little_endian = false; }
+      else
+      {
+        *error = "The format " + format + " is not supported.";
+        return false;
+      }
+    }
+    else if (keyword == "element")
+    {
+      PlyElement element;
+      iss >> element.name >> element.count;
+      elements->push_back (element);
+    }
+    else if (keyword == "property")
+    {
+      if (elements->empty ())
+      {
+        *error = "A property is out of an element.";
+        return false;
+      }
+
+      PlyProperty property;
+      std::string type;
+      iss >> type;
+      if (type == "list")
+      {
+        std::string count_type;
+        iss >> count_type >> type;
+        property.is_list    = true;
+        property.count_type = ParseType (count_type);
+        if (property.count_type == PlyType::kUnknown)
+        {
+          *error = "The type " + count_type + " is unknown.";
+          return false;
+        }
+      }
+      iss >> property.name;
+      property.type = ParseType (type);
+      if (property.type == PlyType::kUnknown)
+      {
+        *error = "The type " + type + " is unknown.";
+        return false;
+      }
+      elements->back ().properties.push_back (property);
+    }
+    // comment, obj_info and unknown lines are ignored.
+  }
+
+  *error = "The header does not end.";
+  return false;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ReadPly (const std::string& filename, IndexedMesh* mesh) -> bool
+{
+  const std::unique_ptr <std::FILE, int (*) (std::FILE*)>
+    file (std::fopen (filename.c_str (), "rb"), &std::fclose);
+  if (!file)
+  {
+    std::cerr << "Cannot open file [" << filename << "]" << std::endl;
+    return false;
+  }
+
+  bool little_endian = true;
+  std::vector <PlyElement> elements;
+  std::string error;
+  if (!ReadHeader (file.get (), &little_endian, &elements, &error))
+  {
+    std::cerr << filename << ": " << error << std::endl;
+    return false;
+  }
+  const bool swap = little_endian != IsLittleEndian ();
+
+  const auto arrays = std::make_shared <MeshArrays> ();
+  BlockReader reader (file.get ());
+  bool has_vertices = false;
+  for (const auto& element : elements)
+  {
+    if (element.name == "vertex")
+    {
+      if (!ReadVertices (element, swap, &reader, arrays.get ()))
+      {
+        std::cerr << filename << ": Failed to read the vertices." << std::endl;
+        return false;
+      }
+      has_vertices = true;
+    }
+    else if (element.name == "face")
+    {
+      const auto indices
+        = FindProperty (element, {"vertex_indices", "vertex_index"});
+      if (indices < 0 || !element.properties[indices].is_list
+          || !ReadFaces (element, indices, swap, &reader, arrays.get ()))
+      {
+        std::cerr << filename << ": Failed to read the faces." << std::endl;
+        return false;
+      }
+    }
+    else if (!SkipElement (element, swap, &reader))
+    {
+      std::cerr << filename << ": Failed to read " << element.name
+                << "." << std::endl;
+      return false;
+    }
+  }
+  if (!has_vertices)
+  {
+    std::cerr << filename << ": No vertex element." << std::endl;
+    return false;
+  }
+
+  // The attributes of the vertices share the indices of the positions.
+  const auto num_vertices = static_cast <int64_t> (arrays->positions.size ());
+  const bool has_normals   = !arrays->normals.empty ();
+  const bool has_texcoords = !arrays->texcoords.empty ();
+  for (auto& triangle : arrays->triangles)
+  {
+    for (const auto index : triangle.position)
+    {
+      if (index < 0 || index >= num_vertices)
+      {
+        std::cerr << filename << ": The vertex index " << index
+                  << " is out of range." << std::endl;
+        return false;
+      }
+    }
+    if (has_normals)   { triangle.normal   = triangle.position; }
+    if (has_texcoords) { triangle.texcoord = triangle.position; }
+  }
+
+  *mesh = CreateIndexedMesh (arrays);
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
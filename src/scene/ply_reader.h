@@ -0,0 +1,47 @@
+/*!
+ * @file ply_reader.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _PLY_READER_H_
+#define _PLY_READER_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "../core/niepce.h"
+#include "../shape/mesh_cache.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn bool ReadPly (const std::string&, IndexedMesh*)
+ * @brief Read a binary PLY file.
+ * @param[in] filename
+ *    The PLY file, either little or big endian.
+ * @param[out] mesh
+ *    The mesh of the vertex and the face elements.
+ * @return False if the file is not loaded.
+ * @exception none
+ * @details The file is read in large sequential blocks and the elements are
+ *          decoded into arrays allocated once from the counts of the header.
+ *          The vertices have x, y, z and optionally nx, ny, nz and u, v (or
+ *          s, t), and the faces have vertex_indices (or vertex_index).
+ *          Polygons are triangulated as fans. Other elements and properties
+ *          are skipped. ASCII files are not supported.
+ */
+auto ReadPly (const std::string& filename, IndexedMesh* mesh) -> bool;
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _PLY_READER_H_
@@ -15,6 +15,10 @@
 #include "../accelerator/aggregation.h"
 #include "../primitive/primitive.h"
 #include "../sampler/random_sampler.h"
+#include "../light/light.h"
+#include "../core/utilities.h"
+#include "../core/intersection.h"
+#include "../core/profiler.h"
 /*
 // ---------------------------------------------------------------------------
 */
@@ -33,7 +37,31 @@ Scene::Scene
   lights_     (lights),
   original_   (primitives),
   infinite_light_ (inf_light)
-{}
+{
+  // Build the distribution to choose a light by its power.
+  std::vector <Float> powers (lights_.size ());
+  for (std::size_t i = 0; i < lights_.size (); ++i)
+  {
+    powers[i] = RgbToMonochrome (lights_[i]->Power ());
+    light_indices_.emplace (lights_[i].get (), i);
+  }
+  light_distribution_.Build (powers);
+
+  for (std::size_t i = 0; i < original_.size (); ++i)
+  {
+    const auto& primitive = original_[i];
+    primitive_indices_.emplace (primitive.get (), i);
+    if (primitive->HasMaterial ())
+    {
+      material_indices_.emplace (primitive->Material ().get (),
+                                 material_indices_.size ());
+    }
+  }
+
+  // Build the hierarchy to choose a light by its importance to a point.
+  ProfileScope scope ("light_bvh");
+  light_bvh_ = LightBvh (lights_);
+}
 /*
 // ---------------------------------------------------------------------------
 */
@@ -44,24 +72,42 @@ auto Scene::IsIntersect
 )
   const noexcept -> bool
 {
-  /*
+  return primitives_.IsIntersect (ray, intersection);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Scene::IsIntersectBruteForce
+(
+ const Ray& ray,
+ Intersection* intersection
+)
+  const noexcept -> bool
+{
   bool hit = false;
   Intersection tmp;
   for (const auto& p : original_)
   {
-    if (p->IsIntersect (ray, &tmp))
+    if (p->IsIntersect (ray, &tmp) &&
+        tmp.Distance () > kEpsilon &&
+        tmp.Distance () < intersection->Distance ())
     {
-      if (tmp.Distance () < intersection->Distance ())
-      {
-        hit = true;
-        *intersection = tmp;
-        intersection->SetPrimitive (p);
-      }
+      hit = true;
+      *intersection = tmp;
+      intersection->SetPrimitive (p);
     }
   }
   return hit;
-  */
-  return primitives_.IsIntersect (ray, intersection);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Scene::Bounds () const noexcept -> Bounds3f
+{
+  if (original_.empty ()) { return Bounds3f (); }
+  Bounds3f bounds = original_[0]->Shape ()->Bounds ();
+  for (const auto& p : original_) { bounds.Merge (p->Shape ()->Bounds ()); }
+  return bounds;
 }
 /*
 // ---------------------------------------------------------------------------
@@ -78,6 +124,17 @@ auto Scene::InfiniteLight ()
 /*
 // ---------------------------------------------------------------------------
 */
+auto Scene::SetInfiniteLight
+(
+ const std::shared_ptr <niepce::InfiniteLight>& inf_light
+)
+  noexcept -> void
+{
+  infinite_light_ = inf_light;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 auto Scene::Light (unsigned int idx)
   const noexcept -> std::shared_ptr <niepce::Light>
 {
@@ -94,6 +151,110 @@ auto Scene::NumLight () const noexcept -> unsigned int
 /*
 // ---------------------------------------------------------------------------
 */
+auto Scene::LightIndex (const niepce::Light* light) const noexcept -> int
+{
+  const auto it = light_indices_.find (light);
+  if (it == light_indices_.end ()) { return -1; }
+  return it->second;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Scene::PrimitiveIndex (const Primitive* primitive) const noexcept -> int
+{
+  const auto it = primitive_indices_.find (primitive);
+  if (it == primitive_indices_.end ()) { return -1; }
+  return it->second;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Scene::MaterialIndex (const niepce::Material* material)
+  const noexcept -> int
+{
+  const auto it = material_indices_.find (material);
+  if (it == material_indices_.end ()) { return -1; }
+  return it->second;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Scene::LightDistribution () const noexcept -> const AliasTable&
+{
+  return light_distribution_;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Scene::SampleLight
+(
+ const Intersection& isect,
+ Float               sample,
+ LightSampling       strategy,
+ Float*              pdf,
+ Float*              remapped
+)
+  const noexcept -> int
+{
+  *pdf = 0;
+  if (lights_.empty ()) { return -1; }
+
+  switch (strategy)
+  {
+    case LightSampling::kUniform:
+    {
+      const int n   = lights_.size ();
+      const int idx = std::min (static_cast <int> (sample * n), n - 1);
+      *pdf      = 1.0 / n;
+      *remapped = std::fmin (sample * n - idx, 1.0 - kEpsilon);
+      return idx;
+    }
+    case LightSampling::kBvh:
+    {
+      return light_bvh_.Sample (isect.Position (),
+                                isect.Normal (),
+                                sample,
+                                pdf,
+                                remapped);
+    }
+    default:
+    {
+      return light_distribution_.Sample (sample, pdf, remapped);
+    }
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Scene::LightPdf
+(
+ const Intersection& isect,
+ int                 idx,
+ LightSampling       strategy
+)
+  const noexcept -> Float
+{
+  if (idx < 0 || idx >= static_cast <int> (lights_.size ())) { return 0; }
+
+  switch (strategy)
+  {
+    case LightSampling::kUniform:
+    {
+      return 1.0 / lights_.size ();
+    }
+    case LightSampling::kBvh:
+    {
+      return light_bvh_.Pdf (isect.Position (), isect.Normal (), idx);
+    }
+    default:
+    {
+      return light_distribution_.Pdf (idx);
+    }
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 auto CreateScene
 (
  const std::vector <std::shared_ptr <Primitive>>& primitives,
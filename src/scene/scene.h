@@ -11,8 +11,12 @@
 // ---------------------------------------------------------------------------
 */
 #include "../core/niepce.h"
+#include "../core/bounds3f.h"
 #include "../accelerator/bvh.h"
 #include "../accelerator/aggregation.h"
+#include "../core/render_settings.h"
+#include "../light/light_bvh.h"
+#include "../sampler/alias_table.h"
 /*
 // ---------------------------------------------------------------------------
 */
@@ -69,6 +73,29 @@ public:
   )
   const noexcept -> bool;
 
+  /*!
+   * @fn bool IsIntersectBruteForce (const Ray&, Intersection*)
+   * @brief Find the nearest hit by testing every primitive.
+   * @param[in] ray
+   * @param[out] intersection
+   * @return True if the ray hits a primitive.
+   * @exception none
+   * @details It accepts the same hits as the leaves of the BVH, so that it
+   *          is the reference of IsIntersect for the validation of the
+   *          accelerator. It is too slow to render.
+   */
+  auto IsIntersectBruteForce (const Ray& ray, Intersection* intersection)
+    const noexcept -> bool;
+
+  /*!
+   * @fn Bounds3f Bounds ()
+   * @brief Return the bounds of every primitive.
+   * @return
+   * @exception none
+   * @details
+   */
+  auto Bounds () const noexcept -> Bounds3f;
+
   /*!
    * @fn std Light (int)
    * @brief 
@@ -90,6 +117,92 @@ public:
    */
   auto NumLight () const noexcept -> unsigned int;
 
+  /*!
+   * @fn int LightIndex (const Light*)
+   * @brief Return the index of the light in the scene.
+   * @param[in] light
+   * @return The index, or -1 if the light is not in the scene.
+   * @exception none
+   * @details
+   */
+  auto LightIndex (const niepce::Light* light) const noexcept -> int;
+
+  /*!
+   * @fn int PrimitiveIndex (const Primitive*)
+   * @brief Return the index of the primitive in the scene.
+   * @param[in] primitive
+   * @return The index, or -1 if the primitive is not in the scene.
+   * @exception none
+   * @details
+   */
+  auto PrimitiveIndex (const Primitive* primitive) const noexcept -> int;
+
+  /*!
+   * @fn int MaterialIndex (const Material*)
+   * @brief Return the index of the material in the scene.
+   * @param[in] material
+   * @return The index, or -1 if no primitive has the material.
+   * @exception none
+   * @details Materials are numbered in the order of the first primitive
+   *          which has each.
+   */
+  auto MaterialIndex (const niepce::Material* material) const noexcept -> int;
+
+  /*!
+   * @fn const AliasTable& LightDistribution ()
+   * @brief Return the distribution to choose a light.
+   * @return
+   * @exception none
+   * @details Each light is chosen in proportion to its emitted power. The
+   *          index of the distribution corresponds to Light (idx).
+   */
+  auto LightDistribution () const noexcept -> const AliasTable&;
+
+  /*!
+   * @fn int SampleLight (const Intersection&, Float, LightSampling, Float*, Float*)
+   * @brief Choose a light to illuminate the intersection.
+   * @param[in] isect
+   *    The shading point.
+   * @param[in] sample
+   *    The uniform distributed sample on [0, 1).
+   * @param[in] strategy
+   *    The strategy to choose a light.
+   * @param[out] pdf
+   *    The probability to choose the returned light.
+   * @param[out] remapped
+   *    The sample remapped to [0, 1) so that it can be reused.
+   * @return The index of the light, or -1 if no light was chosen.
+   * @exception none
+   * @details
+   */
+  auto SampleLight
+  (
+   const Intersection& isect,
+   Float               sample,
+   LightSampling       strategy,
+   Float*              pdf,
+   Float*              remapped
+  )
+    const noexcept -> int;
+
+  /*!
+   * @fn Float LightPdf (const Intersection&, int, LightSampling)
+   * @brief Return the probability that SampleLight () chooses the light.
+   * @param[in] isect
+   * @param[in] idx
+   * @param[in] strategy
+   * @return
+   * @exception none
+   * @details
+   */
+  auto LightPdf
+  (
+   const Intersection& isect,
+   int                 idx,
+   LightSampling       strategy
+  )
+    const noexcept -> Float;
+
   /*!
    * @fn std InfiniteLight ()
    * @brief 
@@ -100,10 +213,33 @@ public:
    */
   auto InfiniteLight () const noexcept -> std::shared_ptr <InfiniteLight>;
 
+  /*!
+   * @fn void SetInfiniteLight (const std::shared_ptr <InfiniteLight>&)
+   * @brief Replace the infinite light.
+   * @param[in] inf_light
+   * @return
+   * @exception none
+   * @details The importer sets it after the BVH was built, so that loading
+   *          the environment map does not delay the build. It must not be
+   *          called while the scene is rendered.
+   */
+  auto SetInfiniteLight (const std::shared_ptr <niepce::InfiniteLight>& inf_light)
+    noexcept -> void;
+
 
 private:
   Bvh primitives_;
   std::vector <std::shared_ptr <niepce::Light>> lights_;
+  AliasTable light_distribution_;
+  LightBvh   light_bvh_;
+
+  // Key   : Address of light
+  // Value : Index of light
+  std::unordered_map <const niepce::Light*, int> light_indices_;
+
+  // The IDs of the output variables.
+  std::unordered_map <const Primitive*, int>        primitive_indices_;
+  std::unordered_map <const niepce::Material*, int> material_indices_;
 
   std::shared_ptr <niepce::InfiniteLight> infinite_light_;
 
@@ -6,6 +6,10 @@
  * @details 
  */
 #include "scene_importer.h"
+#include "../core/aov_buffer.h"
+#include "../core/imageio.h"
+#include "../core/profiler.h"
+#include "../core/thread_pool.h"
 #include "../core/vector3f.h"
 #include "../core/film.h"
 #include "../core/transform.h"
@@ -22,14 +26,51 @@
 /*
 // ---------------------------------------------------------------------------
 */
-#define TINYOBJLOADER_IMPLEMENTATION
-// #define TINYOBJLOADER_USE_DOUBLE
-#include "../ext/tinyobjloader/tiny_obj_loader.h"
+namespace niepce
+{
 /*
 // ---------------------------------------------------------------------------
 */
-namespace niepce
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @struct ShapeElement
+ * @brief A shape whose primitives are created once its mesh is loaded.
+ * @details
+ */
+struct ShapeElement
 {
+  niepce::ShapeType                type;
+  Attributes                       attributes;
+  std::shared_future <IndexedMesh> mesh;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn std::future <R> LoadAsync (const std::function <R ()>&)
+ * @brief Load an asset on the thread pool.
+ * @param[in] load
+ * @return The result of the load.
+ * @exception none
+ * @details
+ */
+template <typename R>
+auto LoadAsync (const std::function <R ()>& load) -> std::future <R>
+{
+  return Singleton <ThreadPool>::Instance ().Enqueue ([load] () -> R
+  {
+    ProfileScope scope ("import/load");
+    return load ();
+  });
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
 /*
 // ---------------------------------------------------------------------------
 */
@@ -43,7 +84,10 @@ SceneImporter::SceneImporter (const char* filename)
 auto SceneImporter::Import (const char *filename) -> void
 {
   GetFileDirectory (filename, &filepath_);
-  xml_.LoadFile (filename);
+  {
+    ProfileScope scope ("xml");
+    xml_.LoadFile (filename);
+  }
   root_ = xml_.RootElement ();
 
   if (!root_)
@@ -52,6 +96,16 @@ auto SceneImporter::Import (const char *filename) -> void
     return ;
   }
 
+  // The assets are loaded on the thread pool while the elements are walked.
+  std::vector <std::future <void>>              textures;
+  std::future <std::shared_ptr <InfiniteLight>> inf_light;
+  std::future <std::shared_ptr <Camera>>        camera;
+  std::vector <ShapeElement>                    shapes;
+
+  // Key   : Mesh file
+  // Value : The mesh, which is loaded once for all the shapes of the file.
+  std::map <std::string, std::shared_future <IndexedMesh>> meshes;
+
   // Loop for each element.
   for (auto element = root_->FirstChildElement ();
        element != nullptr;
@@ -63,7 +117,10 @@ auto SceneImporter::Import (const char *filename) -> void
       auto type = element->Attribute ("type");
       attributes.AddString ("type", type);
       ParseRecursive (element, &attributes);
-      camera_ = CreateCamera (attributes);
+      camera = LoadAsync <std::shared_ptr <Camera>> ([attributes] ()
+      {
+        return CreateCamera (attributes);
+      });
       continue;
     }
     if (IsElementType (element, "light"))
@@ -75,7 +132,10 @@ auto SceneImporter::Import (const char *filename) -> void
 
       if (type == niepce::LightType::kInfiniteLight)
       {
-        inf_lights_ = CreateInfiniteLight (attributes);
+        inf_light = LoadAsync <std::shared_ptr <InfiniteLight>> ([attributes] ()
+        {
+          return CreateInfiniteLight (attributes);
+        });
         continue;
       }
       if (type == niepce::LightType::kAreaLight)
@@ -101,8 +161,16 @@ auto SceneImporter::Import (const char *filename) -> void
       }
       if (type == niepce::TextureType::kImageSpectrum)
       {
-        auto tex = CreateImageTexture <Spectrum> (attributes);
+        // Materials refer to the texture before its image is loaded.
+        const auto file = attributes.FindString ("filename");
+        std::shared_ptr <ImageIO <Spectrum>> image
+          (new ImageIO <Spectrum> (file.c_str (), 0, 0));
+        auto tex = std::make_shared <ImageTexture <Spectrum>> (image);
         spectrum_textures_.emplace (id, tex);
+        textures.push_back (LoadAsync <void> ([image, file] ()
+        {
+          image->Load (file.c_str ());
+        }));
         continue;
       }
       if (type == niepce::TextureType::kValueFloat)
@@ -131,22 +199,34 @@ auto SceneImporter::Import (const char *filename) -> void
       const auto id = element->Attribute("id");
       attributes.AddString ("id", id);
       ParseRecursive (element, &attributes);
-      if (type == niepce::ShapeType::kTriangleMesh)
+
+      ShapeElement shape;
+      shape.type       = type;
+      shape.attributes = attributes;
+      if (type == niepce::ShapeType::kTriangleMesh ||
+          type == niepce::ShapeType::kPlyMesh)
       {
-        LoadObj (attributes);
+        const auto file   = attributes.FindString ("filename");
+        const auto format = type == niepce::ShapeType::kPlyMesh
+                          ? MeshFormat::kPly : MeshFormat::kObj;
+        auto& mesh = meshes[file];
+        if (!mesh.valid ())
+        {
+          mesh = LoadAsync <IndexedMesh> ([file, format] () -> IndexedMesh
+          {
+            ProfileScope scope ("mesh");
+            IndexedMesh indexed;
+            LoadMesh (file, format, &indexed);
+            return indexed;
+          }).share ();
+        }
+        shape.mesh = mesh;
+        shapes.push_back (shape);
         continue;
       }
       if (type == niepce::ShapeType::kSphere)
       {
-        const auto radius = attributes.FindFloat ("radius");
-        const auto t      = attributes.FindTransform ("transform");
-
-        const auto sphere = CreateSphere (t, radius);
-
-        const auto id = attributes.FindString ("material");
-        const auto mat    = this->Material (id);
-        if (mat == nullptr) { std::cerr << "shape sphere error" << std::endl;}
-        primitives_.push_back (CreatePrimitive (sphere, mat, nullptr));
+        shapes.push_back (shape);
         continue;
       }
       std::cerr << "Shape element was ignored." << std::endl;
@@ -165,11 +245,75 @@ auto SceneImporter::Import (const char *filename) -> void
                          attributes.FindInt ("tile_width"));
       settings_.AddItem (RenderSettings::Item::kTileHeight,
                          attributes.FindInt ("tile_height"));
+      const auto sampling
+        = LightSampling (attributes.FindString ("light_sampling"));
+      settings_.AddItem (RenderSettings::Item::kLightSampling,
+                         static_cast <unsigned int> (sampling));
+      const auto mis = MisHeuristic (attributes.FindString ("mis"));
+      settings_.AddItem (RenderSettings::Item::kMis,
+                         static_cast <unsigned int> (mis));
+      const auto roulette = RussianRoulette (attributes.FindString ("roulette"));
+      settings_.AddItem (RenderSettings::Item::kRoulette,
+                         static_cast <unsigned int> (roulette));
+      settings_.AddItem (RenderSettings::Item::kRouletteDepth,
+                         attributes.FindInt ("roulette_depth"));
+      const auto sampler = SamplerType (attributes.FindString ("sampler"));
+      settings_.AddItem (RenderSettings::Item::kSampler,
+                         static_cast <unsigned int> (sampler));
+      const auto film = FilmAccumulation (attributes.FindString ("film"));
+      settings_.AddItem (RenderSettings::Item::kFilm,
+                         static_cast <unsigned int> (film));
+      const auto denoiser = DenoiserType (attributes.FindString ("denoiser"));
+      settings_.AddItem (RenderSettings::Item::kDenoiser,
+                         static_cast <unsigned int> (denoiser));
+      settings_.AddItem (RenderSettings::Item::kAovs,
+                         Aovs (attributes.FindString ("aovs")));
+      settings_.AddItem (RenderSettings::Item::kTrace,
+                         attributes.FindBool ("trace"));
+      settings_.AddItem (RenderSettings::Item::kTimeLimit,
+                         attributes.FindInt ("time_limit"));
+      settings_.AddItem (RenderSettings::Item::kNumThread,
+                         attributes.FindInt ("threads"));
+      settings_.AddItem (RenderSettings::Item::kKeepFilm,
+                         attributes.FindBool ("keep_film"));
+    }
+  }
+
+  // Create the primitives in the order of the elements, so that the scene
+  // does not depend on the order that the loads finish in. This thread only
+  // waits, so that the BVH is built as soon as the meshes are loaded.
+  {
+    ProfileScope scope ("primitives");
+    for (const auto& shape : shapes)
+    {
+      if (shape.type == niepce::ShapeType::kSphere)
+      {
+        const auto radius = shape.attributes.FindFloat ("radius");
+        const auto t      = shape.attributes.FindTransform ("transform");
+
+        const auto sphere = CreateSphere (t, radius);
+
+        const auto id  = shape.attributes.FindString ("material");
+        const auto mat = this->Material (id);
+        if (mat == nullptr) { std::cerr << "shape sphere error" << std::endl;}
+        primitives_.push_back (CreatePrimitive (sphere, mat, nullptr));
+        continue;
+      }
+      CreateTriangleMesh (shape.attributes, shape.mesh.get ());
     }
   }
 
-  // Construct a scene.
-  scene_.reset (CreateScene (primitives_, lights_, inf_lights_));
+  // Construct a scene while the textures, the environment map and the camera
+  // may still be loaded.
+  scene_.reset (CreateScene (primitives_, lights_, nullptr));
+
+  for (auto& texture : textures) { texture.get (); }
+  if (inf_light.valid ())
+  {
+    inf_lights_ = inf_light.get ();
+    scene_->SetInfiniteLight (inf_lights_);
+  }
+  if (camera.valid ()) { camera_ = camera.get (); }
 }
 /*
 // ---------------------------------------------------------------------------
@@ -484,7 +628,8 @@ auto SceneImporter::ParseSpectrum (tinyxml2::XMLElement* element)
 auto SceneImporter::ParseTransform (tinyxml2::XMLElement* element)
   const noexcept -> std::pair <std::string, Transform>
 {
-  Vector3f translate, rotate, scale;
+  // Scale is one if not given.
+  Vector3f translate, rotate, scale (1, 1, 1);
   for (auto e = element->FirstChildElement (); e != nullptr;
        e = e->NextSiblingElement())
   {
@@ -529,78 +674,33 @@ auto SceneImporter::IsElementType
 /*
 // ---------------------------------------------------------------------------
 */
-auto SceneImporter::LoadObj (const Attributes& attributes) -> void
+auto SceneImporter::CreateTriangleMesh
+(
+ const Attributes&  attributes,
+ const IndexedMesh& indexed
+)
+  -> void
 {
-  const std::string filename = attributes.FindString ("filename");
-
-  tinyobj::attrib_t attrib;
-  std::vector<tinyobj::shape_t> shapes;
-  std::vector<tinyobj::material_t> materials;
-
-  // Load .obj
-  std::string err;
-  bool ret = tinyobj::LoadObj (&attrib,
-                               &shapes,
-                               &materials,
-                               &err,
-                               filename.c_str());
-  // Error check.
-  if (!err.empty() || !ret) { std::cerr << err << std::endl; return ; }
-
-  // Construct mesh.
-  const std::shared_ptr <TriangleMesh> mesh (CreateMesh (attrib.vertices,
-                                                         attrib.normals,
-                                                         attrib.texcoords));
-
-  std::vector <std::array <int, 3>> p_idxs;
-  std::vector <std::array <int, 3>> n_idxs;
-  std::vector <std::array <int, 3>> t_idxs;
-
-  // Loop over shapes.
-  for (const auto& s : shapes)
-  {
-    size_t index_offset = 0;
-    for (size_t f = 0; f < s.mesh.num_face_vertices.size(); f++)
-    {
-      int fv = s.mesh.num_face_vertices[f];
-      if (fv != 3) {/* Triangle is only supported.*/ return ; }
-
-      // Get triangle position indices.
-      std::array <int, 3> p = {s.mesh.indices[index_offset + 0].vertex_index,
-                               s.mesh.indices[index_offset + 1].vertex_index,
-                               s.mesh.indices[index_offset + 2].vertex_index};
-      // Get triangle normal indices.
-      std::array <int, 3> n = {s.mesh.indices[index_offset + 0].normal_index,
-                               s.mesh.indices[index_offset + 1].normal_index,
-                               s.mesh.indices[index_offset + 2].normal_index};
-      // Get texture coordinate indices.
-      std::array <int, 3> t = {s.mesh.indices[index_offset + 0].texcoord_index,
-                               s.mesh.indices[index_offset + 1].texcoord_index,
-                               s.mesh.indices[index_offset + 2].texcoord_index};
-      // Push indices.
-      p_idxs.push_back (p);
-      n_idxs.push_back (n);
-      t_idxs.push_back (t);
-      index_offset += fv;
-    }
-  }
+  if (!indexed.mesh) { return ; }
+  const auto& mesh = indexed.mesh;
 
   // Get shape ID.
   auto sid = attributes.FindString ("id");
 
   // Construct triangle face.
-  const int  size = p_idxs.size ();
+  const auto size = indexed.num_triangles;
   const auto mat_id   = attributes.FindString ("material");
   const auto light_id = attributes.FindString ("light");
   const auto mat   = Material (mat_id);
 
-  for (int i = 0; i < size; ++i)
+  for (std::size_t i = 0; i < size; ++i)
   {
     // Create triangle.
+    const auto& indices = indexed.triangles[i];
     std::shared_ptr <Shape> shape (CreateTriangle (mesh,
-                                                   p_idxs[i],
-                                                   n_idxs[i],
-                                                   t_idxs[i]));
+                                                   indices.position,
+                                                   indices.normal,
+                                                   indices.texcoord));
     shapes_.emplace (sid, shape);
 
     // Construct area light if present.
@@ -652,10 +752,97 @@ auto SceneImporter::LightType (const std::string& type) const noexcept
 /*
 // ---------------------------------------------------------------------------
 */
+auto SceneImporter::LightSampling (const std::string& type)
+  const noexcept -> niepce::LightSampling
+{
+  if (type == "uniform") { return niepce::LightSampling::kUniform; }
+  if (type == "bvh")     { return niepce::LightSampling::kBvh;     }
+  return niepce::LightSampling::kPower;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SceneImporter::MisHeuristic (const std::string& type)
+  const noexcept -> niepce::MisHeuristic
+{
+  if (type == "none") { return niepce::MisHeuristic::kNone; }
+  return niepce::MisHeuristic::kPower;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SceneImporter::RussianRoulette (const std::string& type)
+  const noexcept -> niepce::RussianRoulette
+{
+  if (type == "throughput") { return niepce::RussianRoulette::kThroughput; }
+  if (type == "efficiency") { return niepce::RussianRoulette::kEfficiency; }
+  return niepce::RussianRoulette::kNone;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SceneImporter::SamplerType (const std::string& type)
+  const noexcept -> niepce::SamplerType
+{
+  if (type == "random")     { return niepce::SamplerType::kRandom;    }
+  if (type == "blue_noise") { return niepce::SamplerType::kBlueNoise; }
+  return niepce::SamplerType::kSobol;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SceneImporter::FilmAccumulation (const std::string& type)
+  const noexcept -> niepce::FilmAccumulation
+{
+  if (type == "atomic") { return niepce::FilmAccumulation::kAtomic; }
+  if (type == "stream") { return niepce::FilmAccumulation::kStream; }
+  return niepce::FilmAccumulation::kTile;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SceneImporter::DenoiserType (const std::string& type)
+  const noexcept -> niepce::DenoiserType
+{
+  if (type == "bilateral") { return niepce::DenoiserType::kBilateral; }
+  return niepce::DenoiserType::kNone;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto SceneImporter::Aovs (const std::string& names) const noexcept
+  -> unsigned int
+{
+  // The names are separated by spaces or commas.
+  std::string copy (names);
+  std::replace (copy.begin (), copy.end (), ',', ' ');
+  std::istringstream sin (copy);
+
+  unsigned int aovs = 0;
+  std::string name;
+  while (sin >> name)
+  {
+    bool found = false;
+    for (int i = 0; i < static_cast <int> (Aov::kNumAovs); ++i)
+    {
+      if (name == AovName (static_cast <Aov> (i)))
+      {
+        aovs |= AovBit (static_cast <Aov> (i));
+        found = true;
+      }
+    }
+    if (!found) { std::cerr << "Unknown AOV " << name << std::endl; }
+  }
+  return aovs;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 auto SceneImporter::ShapeType (const std::string &str)
   const noexcept -> niepce::ShapeType
 {
   if (str == "obj")    { return niepce::ShapeType::kTriangleMesh; }
+  if (str == "ply")    { return niepce::ShapeType::kPlyMesh;      }
   if (str == "sphere") { return niepce::ShapeType::kSphere;       }
   return niepce::ShapeType::kUnknown;
 }
@@ -17,6 +17,7 @@
 #include "../core/material_attributes.h"
 #include "../material/material.h"
 #include "../texture/texture.h"
+#include "mesh_loader.h"
 #include "scene.h"
 /*
 // ---------------------------------------------------------------------------
@@ -79,7 +80,10 @@ public:
    * @param[in] filename
    * @return 
    * @exception none
-   * @details 
+   * @details The textures, the environment maps, the meshes and the camera
+   *          are loaded on the thread pool while the elements are walked.
+   *          The BVH is built as soon as the meshes are loaded, and the
+   *          other loads finish meanwhile.
    */
   auto Import (const char* filename) -> void;
 
@@ -213,19 +217,40 @@ private:
     const noexcept -> MaterialType;
 
   /*!
-   * @fn void LoadObj (const char*)
-   * @brief 
-   * @param[in] filename
-   *    
+   * @fn void CreateTriangleMesh (const Attributes&, const IndexedMesh&)
+   * @brief Create the triangles of a shape.
+   * @param[in] attributes
+   *    The attributes of the shape.
+   * @param[in] indexed
+   *    The mesh loaded from the file of the shape. Nothing is created if it
+   *    failed to load.
    * @return 
    * @exception none
    * @details
    */
-  auto LoadObj (const Attributes& attributes) -> void;
+  auto CreateTriangleMesh
+  (
+   const Attributes&  attributes,
+   const IndexedMesh& indexed
+  )
+    -> void;
 
   auto TextureType (const std::string& type) const noexcept -> niepce::TextureType;
   auto LightType (const std::string& type) const noexcept -> niepce::LightType;
   auto ShapeType (const std::string &type) const noexcept -> niepce::ShapeType;
+  auto LightSampling (const std::string& type)
+    const noexcept -> niepce::LightSampling;
+  auto MisHeuristic (const std::string& type)
+    const noexcept -> niepce::MisHeuristic;
+  auto RussianRoulette (const std::string& type)
+    const noexcept -> niepce::RussianRoulette;
+  auto SamplerType (const std::string& type)
+    const noexcept -> niepce::SamplerType;
+  auto FilmAccumulation (const std::string& type)
+    const noexcept -> niepce::FilmAccumulation;
+  auto DenoiserType (const std::string& type)
+    const noexcept -> niepce::DenoiserType;
+  auto Aovs (const std::string& names) const noexcept -> unsigned int;
 
   /*!
    * @fn ElementType DetectElementType (tinyxml2)
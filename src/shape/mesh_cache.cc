@@ -0,0 +1,276 @@
+/*!
+ * @file mesh_cache.cc
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "mesh_cache.h"
+#include "../core/mapped_file.h"
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+// The sections of the cache, each of which begins at a multiple of
+// kAlignment, so that the arrays are aligned as the classes require.
+enum Section
+{
+  kPositions,
+  kNormals,
+  kTexcoords,
+  kTriangles,
+  kNumSections
+};
+
+const char     kMagic[8]  = {'N', 'I', 'E', 'P', 'C', 'E', 'M', 'C'};
+const uint32_t kVersion   = 1;
+const uint32_t kEndian    = 0x01020304;
+const uint64_t kAlignment = 64;
+
+// The arrays are written as they are in memory.
+static_assert (sizeof (TriangleIndices) == 36, "TriangleIndices is packed");
+static_assert (std::is_trivially_copyable <Point3f>::value
+               && std::is_trivially_copyable <Vector3f>::value
+               && std::is_trivially_copyable <Point2f>::value,
+               "The vertex attributes are copied as bytes");
+
+const uint64_t kElementSizes[kNumSections] =
+{
+  sizeof (Point3f),
+  sizeof (Vector3f),
+  sizeof (Point2f),
+  sizeof (TriangleIndices)
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+struct Header
+{
+  char     magic[8];
+  uint32_t version;
+  uint32_t endian;
+  uint64_t element_sizes[kNumSections];
+  uint64_t source_size;
+  int64_t  source_mtime;
+  uint64_t counts[kNumSections];
+  uint64_t offsets[kNumSections];
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Align (uint64_t offset) -> uint64_t
+{
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// The size and the modified time of the source, which tell whether the
+// cache is older than it.
+auto SourceStamp (const std::string& source, uint64_t* size, int64_t* mtime)
+  -> bool
+{
+  struct stat st;
+  if (stat (source.c_str (), &st) != 0) { return false; }
+  *size  = static_cast <uint64_t> (st.st_size);
+  *mtime = static_cast <int64_t>  (st.st_mtime);
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Whether the index refers to one of the count elements. An optional
+// attribute may be -1.
+auto IsValidIndex (int index, uint64_t count, bool optional) -> bool
+{
+  if (index == -1) { return optional; }
+  return index >= 0 && static_cast <uint64_t> (index) < count;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+auto CreateIndexedMesh (const std::shared_ptr <MeshArrays>& arrays)
+  -> IndexedMesh
+{
+  IndexedMesh mesh;
+  mesh.mesh = std::make_shared <TriangleMesh>
+    (arrays->positions.data (), arrays->positions.size (),
+     arrays->normals.data (),   arrays->normals.size (),
+     arrays->texcoords.data (), arrays->texcoords.size (),
+     arrays);
+  mesh.triangles     = arrays->triangles.data ();
+  mesh.num_triangles = arrays->triangles.size ();
+  return mesh;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto MeshCacheFilename (const std::string& source) -> std::string
+{
+  return source + ".nmesh";
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ReadMeshCache
+(
+ const std::string& filename,
+ const std::string& source,
+ IndexedMesh*       mesh
+)
+  -> bool
+{
+  uint64_t size  = 0;
+  int64_t  mtime = 0;
+  if (!SourceStamp (source, &size, &mtime)) { return false; }
+
+  const auto file = std::make_shared <MappedFile> (filename.c_str ());
+  if (!file->IsOpen () || file->Size () < sizeof (Header)) { return false; }
+
+  Header header;
+  std::memcpy (&header, file->Data (), sizeof (Header));
+  if (std::memcmp (header.magic, kMagic, sizeof (kMagic)) != 0
+      || header.version != kVersion
+      || header.endian  != kEndian
+      || header.source_size  != size
+      || header.source_mtime != mtime)
+  {
+    return false;
+  }
+  for (int i = 0; i < kNumSections; ++i)
+  {
+    if (header.element_sizes[i] != kElementSizes[i]
+        || header.offsets[i] % kAlignment != 0
+        || header.offsets[i] > file->Size ()
+        || header.counts[i] > (file->Size () - header.offsets[i])
+                              / kElementSizes[i])
+    {
+      return false;
+    }
+  }
+
+  const auto data = file->Data ();
+  const auto section = [&] (Section s) { return data + header.offsets[s]; };
+  mesh->mesh = std::make_shared <TriangleMesh>
+    (reinterpret_cast <const Point3f*>  (section (kPositions)),
+     header.counts[kPositions],
+     reinterpret_cast <const Vector3f*> (section (kNormals)),
+     header.counts[kNormals],
+     reinterpret_cast <const Point2f*>  (section (kTexcoords)),
+     header.counts[kTexcoords],
+     file);
+  mesh->triangles
+    = reinterpret_cast <const TriangleIndices*> (section (kTriangles));
+  mesh->num_triangles = header.counts[kTriangles];
+
+  // The triangles index the arrays without checks, so that a cache broken
+  // after it was written must not reach them.
+  for (std::size_t i = 0; i < mesh->num_triangles; ++i)
+  {
+    const auto& triangle = mesh->triangles[i];
+    for (int j = 0; j < 3; ++j)
+    {
+      if (!IsValidIndex (triangle.position[j], header.counts[kPositions],
+                         false)
+          || !IsValidIndex (triangle.normal[j], header.counts[kNormals],
+                            true)
+          || !IsValidIndex (triangle.texcoord[j], header.counts[kTexcoords],
+                            true))
+      {
+        *mesh = IndexedMesh ();
+        return false;
+      }
+    }
+  }
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto WriteMeshCache
+(
+ const std::string& filename,
+ const std::string& source,
+ const IndexedMesh& mesh
+)
+  -> bool
+{
+  Header header;
+  std::memset (&header, 0, sizeof (Header));
+  std::memcpy (header.magic, kMagic, sizeof (kMagic));
+  header.version = kVersion;
+  header.endian  = kEndian;
+  if (!SourceStamp (source, &header.source_size, &header.source_mtime))
+  {
+    return false;
+  }
+
+  const char* arrays[kNumSections] =
+  {
+    reinterpret_cast <const char*> (mesh.mesh->Positions ()),
+    reinterpret_cast <const char*> (mesh.mesh->Normals ()),
+    reinterpret_cast <const char*> (mesh.mesh->Texcoords ()),
+    reinterpret_cast <const char*> (mesh.triangles)
+  };
+  header.counts[kPositions] = mesh.mesh->NumPositions ();
+  header.counts[kNormals]   = mesh.mesh->NumNormals ();
+  header.counts[kTexcoords] = mesh.mesh->NumTexcoords ();
+  header.counts[kTriangles] = mesh.num_triangles;
+
+  uint64_t offset = Align (sizeof (Header));
+  for (int i = 0; i < kNumSections; ++i)
+  {
+    header.element_sizes[i] = kElementSizes[i];
+    header.offsets[i]       = offset;
+    offset = Align (offset + header.counts[i] * kElementSizes[i]);
+  }
+
+  // Processes which render the same scene may write the cache at once.
+  const std::string temporary
+    = filename + "." + std::to_string (getpid ()) + ".tmp";
+  std::ofstream ofs (temporary, std::ios::binary);
+  ofs.write (reinterpret_cast <const char*> (&header), sizeof (Header));
+
+  uint64_t written = sizeof (Header);
+  const char padding[kAlignment] = {};
+  for (int i = 0; i < kNumSections; ++i)
+  {
+    ofs.write (padding, header.offsets[i] - written);
+    const auto bytes = header.counts[i] * kElementSizes[i];
+    if (bytes > 0) { ofs.write (arrays[i], bytes); }
+    written = header.offsets[i] + bytes;
+  }
+  ofs.close ();
+  if (!ofs) { std::remove (temporary.c_str ()); return false; }
+
+  if (std::rename (temporary.c_str (), filename.c_str ()) != 0)
+  {
+    std::remove (temporary.c_str ());
+    return false;
+  }
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
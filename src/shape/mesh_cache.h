@@ -0,0 +1,147 @@
+/*!
+ * @file mesh_cache.h
+ * @brief
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _MESH_CACHE_H_
+#define _MESH_CACHE_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "../core/niepce.h"
+#include "triangle.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @struct TriangleIndices
+ * @brief The indices of the vertex attributes of a triangle.
+ * @details An index is -1 if the triangle has no such attribute.
+ */
+struct TriangleIndices
+{
+  std::array <int, 3> position;
+  std::array <int, 3> normal;
+  std::array <int, 3> texcoord;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @struct IndexedMesh
+ * @brief A mesh and its triangles.
+ * @details The triangles live in the storage of the mesh, so that they are
+ *          valid as long as the mesh is.
+ */
+struct IndexedMesh
+{
+  std::shared_ptr <TriangleMesh> mesh;
+  const TriangleIndices*         triangles     = nullptr;
+  std::size_t                    num_triangles = 0;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @struct MeshArrays
+ * @brief The storage of a mesh read from a file.
+ * @details
+ */
+struct MeshArrays
+{
+  std::vector <Point3f>         positions;
+  std::vector <Vector3f>        normals;
+  std::vector <Point2f>         texcoords;
+  std::vector <TriangleIndices> triangles;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn IndexedMesh CreateIndexedMesh (const std::shared_ptr <MeshArrays>&)
+ * @brief Return the mesh which refers to the arrays and shares them.
+ * @param[in] arrays
+ *    The arrays, which must not be resized afterwards.
+ * @return
+ * @exception none
+ * @details
+ */
+auto CreateIndexedMesh (const std::shared_ptr <MeshArrays>& arrays)
+  -> IndexedMesh;
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn std::string MeshCacheFilename (const std::string&)
+ * @brief Return the name of the cache of a mesh file, which is next to it.
+ * @param[in] source
+ *    The mesh file, e.g. an OBJ.
+ * @return
+ * @exception none
+ * @details
+ */
+auto MeshCacheFilename (const std::string& source) -> std::string;
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn bool ReadMeshCache (const std::string&, const std::string&, IndexedMesh*)
+ * @brief Map the cache of a mesh file.
+ * @param[in] filename
+ *    The cache.
+ * @param[in] source
+ *    The mesh file the cache was made from.
+ * @param[out] mesh
+ *    The mesh, whose arrays are in the mapped cache.
+ * @return False if the cache is missing, broken, or older than the source.
+ * @exception none
+ * @details Nothing is copied or parsed. The indices of the triangles are
+ *          checked once against the arrays. The pages of the vertices are
+ *          read as the triangles touch them.
+ */
+auto ReadMeshCache
+(
+ const std::string& filename,
+ const std::string& source,
+ IndexedMesh*       mesh
+)
+  -> bool;
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn bool WriteMeshCache (const std::string&, const std::string&, const IndexedMesh&)
+ * @brief Write the cache of a mesh file.
+ * @param[in] filename
+ *    The cache.
+ * @param[in] source
+ *    The mesh file the cache is made from.
+ * @param[in] mesh
+ *    The mesh loaded from the source.
+ * @return False if the cache is not written.
+ * @exception none
+ * @details The cache is written to a temporary file of the process and
+ *          renamed, so that a reader never sees a partial cache.
+ */
+auto WriteMeshCache
+(
+ const std::string& filename,
+ const std::string& source,
+ const IndexedMesh& mesh
+)
+  -> bool;
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _MESH_CACHE_H_
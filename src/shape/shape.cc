@@ -7,6 +7,7 @@
  */
 #include "shape.h"
 #include "../core/bounds3f.h"
+#include "../core/vector3f.h"
 /*
 // ---------------------------------------------------------------------------
 */
@@ -29,6 +30,15 @@ Shape::Shape (const Transform &local_to_world) :
 /*
 // ---------------------------------------------------------------------------
 */
+auto Shape::NormalBounds (Vector3f* axis, Float* cos_theta)
+  const noexcept -> void
+{
+  *axis      = Vector3f (0, 0, 1);
+  *cos_theta = -1;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 } // namespace niepce
 /*
 // ---------------------------------------------------------------------------
@@ -26,6 +26,7 @@ namespace niepce
 enum class ShapeType : uint8_t
 {
  kTriangleMesh,
+ kPlyMesh,
  kSphere,
  kUnknown
 };
@@ -102,6 +103,20 @@ public:
    */
   virtual auto SurfaceArea () const noexcept -> Float = 0;
 
+  /*!
+   * @fn void NormalBounds (Vector3f*, Float*)
+   * @brief Return the cone that bounds the surface normals of this shape.
+   * @param[out] axis
+   *    The axis of the cone.
+   * @param[out] cos_theta
+   *    The cosine of the spread angle of the cone.
+   * @return void
+   * @exception none
+   * @details By default, the cone covers the entire sphere.
+   */
+  virtual auto NormalBounds (Vector3f* axis, Float* cos_theta)
+    const noexcept -> void;
+
 protected:
   const Float kIntersectionEpsilon = 1e-9;
   const Transform world_to_local_;
@@ -16,6 +16,25 @@ namespace niepce
 {
 /*
 // ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+// The storage of a mesh which owns its arrays.
+struct MeshArrays
+{
+  std::vector <Point3f>  positions;
+  std::vector <Vector3f> normals;
+  std::vector <Point2f>  texcoords;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
 // Definition of TriangleMesh
 // ---------------------------------------------------------------------------
 */
@@ -24,34 +43,74 @@ TriangleMesh::TriangleMesh
  const std::vector <Point3f>&  positions,
  const std::vector <Vector3f>& normals,
  const std::vector <Point2f>&  texcoords
+)
+{
+  const auto arrays = std::make_shared <MeshArrays> ();
+  arrays->positions = positions;
+  arrays->normals   = normals;
+  arrays->texcoords = texcoords;
+
+  storage_       = arrays;
+  positions_     = arrays->positions.data ();
+  normals_       = arrays->normals.data ();
+  texcoords_     = arrays->texcoords.data ();
+  num_positions_ = positions.size ();
+  num_normals_   = normals.size ();
+  num_texcoords_ = texcoords.size ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TriangleMesh::TriangleMesh
+(
+ const Point3f*                      positions,
+ std::size_t                         num_positions,
+ const Vector3f*                     normals,
+ std::size_t                         num_normals,
+ const Point2f*                      texcoords,
+ std::size_t                         num_texcoords,
+ const std::shared_ptr <const void>& storage
 ) :
-  positions_ (positions),
-  normals_   (normals),
-  texcoords_ (texcoords)
+  storage_       (storage),
+  positions_     (positions),
+  normals_       (normals),
+  texcoords_     (texcoords),
+  num_positions_ (num_positions),
+  num_normals_   (num_normals),
+  num_texcoords_ (num_texcoords)
 {}
 /*
 // ---------------------------------------------------------------------------
 */
 auto TriangleMesh::Position (int idx) const -> const Point3f&
 {
-  try { return positions_.at (idx); }
-  catch (const std::exception& e) { throw e; }
+  if (idx < 0 || static_cast <std::size_t> (idx) >= num_positions_)
+  {
+    throw std::out_of_range ("TriangleMesh::Position");
+  }
+  return positions_[idx];
 }
 /*
 // ---------------------------------------------------------------------------
 */
 auto TriangleMesh::Normal (int idx) const -> const Vector3f&
 {
-  try { return normals_.at (idx); }
-  catch (const std::exception& e) { throw e; }
+  if (idx < 0 || static_cast <std::size_t> (idx) >= num_normals_)
+  {
+    throw std::out_of_range ("TriangleMesh::Normal");
+  }
+  return normals_[idx];
 }
 /*
 // ---------------------------------------------------------------------------
 */
 auto TriangleMesh::Texcoord (int idx) const -> const Point2f&
 {
-  try { return texcoords_.at (idx); }
-  catch (const std::exception& e) { throw e; }
+  if (idx < 0 || static_cast <std::size_t> (idx) >= num_texcoords_)
+  {
+    throw std::out_of_range ("TriangleMesh::Texcoord");
+  }
+  return texcoords_[idx];
 }
 /*
 // ---------------------------------------------------------------------------
@@ -245,6 +304,18 @@ auto Triangle::SurfaceArea () const noexcept -> Float
 /*
 // ---------------------------------------------------------------------------
 */
+auto Triangle::NormalBounds (Vector3f* axis, Float* cos_theta)
+  const noexcept -> void
+{
+  const auto& p1 = Position (0);
+  const auto& p2 = Position (1);
+  const auto& p3 = Position (2);
+  *axis      = Normalize (Cross (p2 - p1, p3 - p1));
+  *cos_theta = 1;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
 auto Triangle::HasNormals () const noexcept -> bool
 {
   if (normal_indices_[0] == -1 ||
@@ -38,6 +38,19 @@ public:
    const std::vector <Point2f>&  texcoords
   );
 
+  //! The constructor refers to the arrays in the storage without copies,
+  //! e.g. a mapped file, which lives as long as the mesh.
+  TriangleMesh
+  (
+   const Point3f*                      positions,
+   std::size_t                         num_positions,
+   const Vector3f*                     normals,
+   std::size_t                         num_normals,
+   const Point2f*                      texcoords,
+   std::size_t                         num_texcoords,
+   const std::shared_ptr <const void>& storage
+  );
+
   //! The copy constructor of the class.
   TriangleMesh (const TriangleMesh& mesh) = default;
 
@@ -87,11 +100,23 @@ public:
    */
   auto Texcoord (int idx) const -> const Point2f&;
 
+  //! Return the arrays and the number of their elements.
+  auto Positions    () const noexcept -> const Point3f*  { return positions_; }
+  auto Normals      () const noexcept -> const Vector3f* { return normals_; }
+  auto Texcoords    () const noexcept -> const Point2f*  { return texcoords_; }
+  auto NumPositions () const noexcept -> std::size_t { return num_positions_; }
+  auto NumNormals   () const noexcept -> std::size_t { return num_normals_; }
+  auto NumTexcoords () const noexcept -> std::size_t { return num_texcoords_; }
 
 private:
-  std::vector <Point3f>  positions_;
-  std::vector <Vector3f> normals_;
-  std::vector <Point2f>  texcoords_;
+  // The arrays are in the storage, which is shared by the copies.
+  std::shared_ptr <const void> storage_;
+  const Point3f*  positions_     = nullptr;
+  const Vector3f* normals_       = nullptr;
+  const Point2f*  texcoords_     = nullptr;
+  std::size_t     num_positions_ = 0;
+  std::size_t     num_normals_   = 0;
+  std::size_t     num_texcoords_ = 0;
 }; // class TriangleMesh
 //! ----------------------------------------------------------------------------
 //! @class Triangle
@@ -164,6 +189,19 @@ public:
    */
   auto SurfaceArea () const noexcept -> Float override final;
 
+  /*!
+   * @fn void NormalBounds (Vector3f*, Float*)
+   * @brief Return the geometric normal as the axis of a degenerate cone.
+   * @param[out] axis
+   * @param[out] cos_theta
+   * @return void
+   * @exception none
+   * @details Only the front side is bounded. Lights that emit from the
+   *          back side too mark their bounds two-sided.
+   */
+  auto NormalBounds (Vector3f* axis, Float* cos_theta)
+    const noexcept -> void override final;
+
 private:
   /*!
    * @fn bool HasTexcoords ()
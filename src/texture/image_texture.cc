@@ -29,6 +29,13 @@ ImageTexture<T>::ImageTexture (const char* filename) :
 // ---------------------------------------------------------------------------
 */
 template <typename T>
+ImageTexture<T>::ImageTexture (const std::shared_ptr <ImageIO <T>>& image) :
+  image_ (image)
+{}
+/*
+// ---------------------------------------------------------------------------
+*/
+template <typename T>
 auto ImageTexture<T>::Evaluate (const Intersection &isect) const noexcept -> T
 {
   if (image_)
@@ -34,6 +34,9 @@ public:
   //! The constructor takes filename.
   ImageTexture (const char* filename);
 
+  //! The constructor shares the image, which may be loaded afterwards.
+  ImageTexture (const std::shared_ptr <ImageIO <T>>& image);
+
   //! The copy constructor of the class.
   ImageTexture (const ImageTexture& texture) = default;
 
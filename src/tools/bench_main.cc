@@ -0,0 +1,401 @@
+/*!
+ * @file bench_main.cc
+ * @brief Microbenchmarks of the kernels of the renderer.
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ *   Usage : niepce_bench [--benchmark_filter=<regex>]
+ *
+ *   Each benchmark is repeated and only the mean, the median and the
+ *   deviation are reported. Compare the medians of two builds, e.g. by
+ *   tools/compare.py of Google Benchmark, to find regressions of a few
+ *   percent. The inputs are generated from fixed seeds, so that every run
+ *   measures the same work.
+ */
+#include "../accelerator/bvh.h"
+#include "../bsdf/bsdf.h"
+#include "../bsdf/bsdf_record.h"
+#include "../core/bounds3f.h"
+#include "../core/film.h"
+#include "../core/imageio.h"
+#include "../core/intersection.h"
+#include "../core/material_attributes.h"
+#include "../core/memory.h"
+#include "../core/ray_counters.h"
+#include "../core/transform.h"
+#include "../material/material.h"
+#include "../primitive/primitive.h"
+#include "../random/xorshift.h"
+#include "../sampler/low_discrepancy_sequence.h"
+#include "../sampler/random_sampler.h"
+#include "../shape/sphere.h"
+#include "../shape/triangle.h"
+#include "../texture/value_texture.h"
+#include <benchmark/benchmark.h>
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+// The rays cycled by the intersection benchmarks. A power of two, so that
+// the index is masked.
+constexpr std::size_t kNumRays = 1 << 12;
+/*
+// ---------------------------------------------------------------------------
+*/
+// Repeat each benchmark, so that the median is stable against the noise of
+// the machine.
+auto Repeat (benchmark::internal::Benchmark* bench) -> void
+{
+  bench->Repetitions (5)->ReportAggregatesOnly (true);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Rays down to the z = 0 plane, from the points above [min, max]^2. They are
+// tilted a little, since the slabs of a bounding box do not reject the rays
+// parallel to them.
+auto DownwardRays (Float min, Float max, Float z) -> std::vector <Ray>
+{
+  XorShift rng (1);
+  std::vector <Ray> rays;
+  for (std::size_t i = 0; i < kNumRays; ++i)
+  {
+    const Float x  = min + (max - min) * rng.Next01 ();
+    const Float y  = min + (max - min) * rng.Next01 ();
+    const Float dx = 0.1 * (rng.Next01 () - 0.5);
+    const Float dy = 0.1 * (rng.Next01 () - 0.5);
+    rays.push_back (Ray (Point3f (x, y, z), Normalize (Vector3f (dx, dy, -1))));
+  }
+  return rays;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// A height field of 2 * n * n triangles over [0, 1]^2.
+auto HeightField (int n) -> std::vector <std::shared_ptr <Primitive>>
+{
+  XorShift rng (1);
+  std::vector <Float> positions;
+  for (int y = 0; y <= n; ++y)
+  {
+    for (int x = 0; x <= n; ++x)
+    {
+      positions.push_back (static_cast <Float> (x) / n);
+      positions.push_back (static_cast <Float> (y) / n);
+      positions.push_back (0.1 * rng.Next01 ());
+    }
+  }
+  const std::shared_ptr <TriangleMesh> mesh (CreateMesh (positions, {}, {}));
+
+  const std::array <int, 3> none = {-1, -1, -1};
+  std::vector <std::shared_ptr <Primitive>> primitives;
+  for (int y = 0; y < n; ++y)
+  {
+    for (int x = 0; x < n; ++x)
+    {
+      const int i = y * (n + 1) + x;
+      const std::array <std::array <int, 3>, 2> faces =
+      {{
+        {i, i + 1, i + n + 2},
+        {i, i + n + 2, i + n + 1}
+      }};
+      for (const auto& face : faces)
+      {
+        const std::shared_ptr <Shape> shape (CreateTriangle (mesh, face,
+                                                             none, none));
+        primitives.push_back (CreatePrimitive (shape, nullptr, nullptr));
+      }
+    }
+  }
+  return primitives;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Build the BVH of each resolution once, since a benchmark function runs
+// several times.
+auto HeightFieldBvh (int n) -> const Bvh&
+{
+  static std::map <int, std::unique_ptr <Bvh>> bvhs;
+  auto& bvh = bvhs[n];
+  if (!bvh) { bvh.reset (new Bvh (HeightField (n))); }
+  return *bvh;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto CreateBenchMaterial (MaterialType type) -> std::shared_ptr <Material>
+{
+  MaterialAttributes attributes;
+  attributes.SetMaterialType (type);
+  const auto spectrum = [&] (MaterialAttributes::Type t, Float value)
+  {
+    attributes.AddSpectrumTexture (t, CreateValueTexture (Spectrum (value)));
+  };
+  const auto scalar = [&] (MaterialAttributes::Type t, Float value)
+  {
+    attributes.AddFloatTexture (t, CreateValueTexture (value));
+  };
+  spectrum (MaterialAttributes::Type::kEmission,          0.0);
+  spectrum (MaterialAttributes::Type::kReflectance,       0.5);
+  spectrum (MaterialAttributes::Type::kSpecular,          0.5);
+  spectrum (MaterialAttributes::Type::kAbsorption,        3.0);
+  scalar   (MaterialAttributes::Type::kRoughness,         0.3);
+  scalar   (MaterialAttributes::Type::kRoughnessU,        0.3);
+  scalar   (MaterialAttributes::Type::kRoughnessV,        0.3);
+  scalar   (MaterialAttributes::Type::kIndexOfRefraction, 1.5);
+  return CreateMaterial (attributes);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto BenchTriangleIsIntersect (benchmark::State& state) -> void
+{
+  const std::vector <Float> positions = {0, 0, 0,  1, 0, 0,  0, 1, 0};
+  const std::shared_ptr <TriangleMesh> mesh (CreateMesh (positions, {}, {}));
+  const std::unique_ptr <Triangle> triangle
+    (CreateTriangle (mesh, {{0, 1, 2}}, {{-1, -1, -1}}, {{-1, -1, -1}}));
+  const auto rays = DownwardRays (-0.25, 1.25, 1);
+
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    Intersection intersection;
+    const auto& ray = rays[i++ & (kNumRays - 1)];
+    benchmark::DoNotOptimize (triangle->IsIntersect (ray, &intersection));
+  }
+  state.SetItemsProcessed (state.iterations ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto BenchSphereIsIntersect (benchmark::State& state) -> void
+{
+  const auto sphere = CreateSphere (Translate (Vector3f (0, 0, 0)), 1);
+  const auto rays = DownwardRays (-1.5, 1.5, 3);
+
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    Intersection intersection;
+    const auto& ray = rays[i++ & (kNumRays - 1)];
+    benchmark::DoNotOptimize (sphere->IsIntersect (ray, &intersection));
+  }
+  state.SetItemsProcessed (state.iterations ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto BenchBounds3fIsIntersect (benchmark::State& state) -> void
+{
+  const Bounds3f bounds (Point3f (0, 0, -1), Point3f (1, 1, 0));
+  const auto rays = DownwardRays (-0.25, 1.25, 1);
+
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    const auto& ray = rays[i++ & (kNumRays - 1)];
+    benchmark::DoNotOptimize (bounds.IsIntersect (ray));
+  }
+  state.SetItemsProcessed (state.iterations ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// The argument is the resolution of the height field.
+auto BenchBvhIsIntersect (benchmark::State& state) -> void
+{
+  const auto& bvh = HeightFieldBvh (static_cast <int> (state.range (0)));
+  const auto rays = DownwardRays (0, 1, 1);
+
+  auto& counters = Singleton <RayCounters>::Instance ();
+  const auto first = counters.Sum ();
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    Intersection intersection;
+    const auto& ray = rays[i++ & (kNumRays - 1)];
+    benchmark::DoNotOptimize (bvh.IsIntersect (ray, &intersection));
+  }
+  const auto count = counters.Sum () - first;
+  const double iterations = state.iterations ();
+  state.SetItemsProcessed (state.iterations ());
+  state.counters["triangles"]  = 2.0 * state.range (0) * state.range (0);
+  state.counters["nodes"]      = count.nodes / iterations;
+  state.counters["primitives"] = count.primitives / iterations;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// The argument is MaterialType. A BSDF is allocated for each sample, as the
+// path tracer does at each vertex.
+auto BenchBsdfSample (benchmark::State& state) -> void
+{
+  const auto type = static_cast <MaterialType> (state.range (0));
+  const auto material = CreateBenchMaterial (type);
+  const auto sphere = CreateSphere (Translate (Vector3f (0, 0, 0)), 1);
+  const Ray ray (Point3f (0.3, 0.2, 3), Vector3f (0, 0, -1));
+  Intersection intersection;
+  if (!sphere->IsIntersect (ray, &intersection))
+  {
+    state.SkipWithError ("The ray missed the sphere.");
+    return;
+  }
+
+  const char* names[] = {"matte", "metal", "plastic", "mirror"};
+  state.SetLabel (names[state.range (0)]);
+
+  XorShift rng (1);
+  std::vector <Point2f> samples (kNumRays);
+  for (auto& s : samples) { s = Point2f (rng.Next01 (), rng.Next01 ()); }
+
+  MemoryArena memory;
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    memory.Reset ();
+    const auto bsdf = material->AllocateBsdfs (intersection, &memory);
+    BsdfRecord record (intersection);
+    record.SetSamplingTarget (Bxdf::Type::kAll);
+    record.SetOutgoing (-ray.Direction (), bsdf::Coordinate::kWorld);
+    benchmark::DoNotOptimize
+      (bsdf->Sample (&record, samples[i++ & (kNumRays - 1)]));
+  }
+  state.SetItemsProcessed (state.iterations ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto BenchRandomSampler (benchmark::State& state) -> void
+{
+  RandomSampler sampler (1);
+  sampler.StartPixelSample (0, 0, 0);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize (sampler.Next2f ());
+  }
+  state.SetItemsProcessed (state.iterations ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// The argument is the base.
+auto BenchRadicalInverse (benchmark::State& state) -> void
+{
+  const auto base = static_cast <int> (state.range (0));
+  uint64_t a = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize (RadicalInverse (base, a++));
+  }
+  state.SetItemsProcessed (state.iterations ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Map the pixels of a 256 x 256 image, as ToneMapping (Film*) does.
+auto BenchToneMapping (benchmark::State& state) -> void
+{
+  XorShift rng (1);
+  std::vector <Spectrum> pixels (256 * 256);
+  for (auto& p : pixels)
+  {
+    p = Spectrum (4 * rng.Next01 (), 4 * rng.Next01 (), 4 * rng.Next01 ());
+  }
+  std::vector <Spectrum> mapped (pixels.size ());
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < pixels.size (); ++i)
+    {
+      mapped[i] = ToneMapping (pixels[i]);
+    }
+    benchmark::DoNotOptimize (mapped.data ());
+    benchmark::ClobberMemory ();
+  }
+  state.SetItemsProcessed (state.iterations () * pixels.size ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Write and read a 256 x 256 PNG in the current directory.
+constexpr const char* kImageFilename = "niepce_bench.png";
+/*
+// ---------------------------------------------------------------------------
+*/
+auto BenchImage () -> ImageIO <Spectrum>
+{
+  XorShift rng (1);
+  ImageIO <Spectrum> image (256, 256);
+  for (int y = 0; y < 256; ++y)
+  {
+    for (int x = 0; x < 256; ++x)
+    {
+      image.SetValueAt (x, y, Spectrum (rng.Next01 (), 0.5, 0.25));
+    }
+  }
+  return image;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto BenchImageIOSave (benchmark::State& state) -> void
+{
+  const auto image = BenchImage ();
+  for (auto _ : state) { image.SaveAs (kImageFilename); }
+  state.SetItemsProcessed (state.iterations () * 256 * 256);
+  std::remove (kImageFilename);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto BenchImageIOLoad (benchmark::State& state) -> void
+{
+  BenchImage ().SaveAs (kImageFilename);
+  for (auto _ : state)
+  {
+    ImageIO <Spectrum> image (kImageFilename);
+    benchmark::DoNotOptimize (image.At (0, 0));
+  }
+  state.SetItemsProcessed (state.iterations () * 256 * 256);
+  std::remove (kImageFilename);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+BENCHMARK (BenchTriangleIsIntersect)->Apply (Repeat);
+BENCHMARK (BenchSphereIsIntersect)->Apply (Repeat);
+BENCHMARK (BenchBounds3fIsIntersect)->Apply (Repeat);
+BENCHMARK (BenchBvhIsIntersect)->Arg (16)->Arg (64)->Arg (128)->Apply (Repeat);
+BENCHMARK (BenchBsdfSample)
+  ->Arg (static_cast <int> (MaterialType::kMatte))
+  ->Arg (static_cast <int> (MaterialType::kMetal))
+  ->Arg (static_cast <int> (MaterialType::kPlastic))
+  ->Arg (static_cast <int> (MaterialType::kMirror))
+  ->Apply (Repeat);
+BENCHMARK (BenchRandomSampler)->Apply (Repeat);
+BENCHMARK (BenchRadicalInverse)->Arg (2)->Arg (3)->Arg (7)->Apply (Repeat);
+BENCHMARK (BenchToneMapping)->Apply (Repeat);
+BENCHMARK (BenchImageIOSave)->Apply (Repeat);
+BENCHMARK (BenchImageIOLoad)->Apply (Repeat);
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+BENCHMARK_MAIN ();
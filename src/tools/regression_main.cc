@@ -0,0 +1,439 @@
+/*!
+ * @file regression_main.cc
+ * @brief Equal time regression suite of the renderer.
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ *   Usage : niepce_regression <renderer> <directory> <reference_spp>
+ *                             <budget_ms> [budget_ms ...]
+ *
+ *   Each procedural scene is rendered once with reference_spp samples, and
+ *   the reference is kept in the directory for later runs. Then the scene is
+ *   rendered for each time budget, and the error against the reference is
+ *   written to report.json and report.csv with the wall time, the peak
+ *   memory and the rates of rays and samples. A speedup shows up as a lower
+ *   error at the same budget, so that diff the reports of two commits.
+ *
+ *   The error is measured on the sum of the direct and indirect AOVs, which
+ *   are linear and not denoised. Remove the reference directories when the
+ *   scenes or the expected images change.
+ *
+ *   At last, the Cornell box is rendered by one task and by several, with
+ *   the efficiency roulette, and the images must be identical.
+ */
+#include "scene_generator.h"
+#include "../core/aov_buffer.h"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+constexpr unsigned int kResolution   = 128;
+constexpr unsigned int kReferenceSpp = 16;  // Samples per round.
+constexpr unsigned int kNumTasks     = 4;   // Tasks of the determinism check.
+
+// Generate a scene into the directory, and return the path of it.
+using Generator = std::function
+  <std::string (const std::string&, const niepce::GeneratorSettings&)>;
+
+struct RegressionScene
+{
+  std::string name;
+  Generator   generate;
+};
+
+struct RunResult
+{
+  bool   succeeded          = false;
+  double wall_seconds       = 0;
+  double peak_rss_mb        = 0;
+  double mrays_per_second   = 0;
+  double msamples_per_second = 0;
+};
+
+struct Image
+{
+  int width  = 0;
+  int height = 0;
+  std::vector <float> rgb;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+auto JoinPath (const std::string& directory, const std::string& filename)
+  -> std::string
+{
+  if (directory.empty () || directory.back () == '/')
+  {
+    return directory + filename;
+  }
+  return directory + "/" + filename;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Exists (const std::string& path) -> bool
+{
+  struct stat st;
+  return stat (path.c_str (), &st) == 0;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto MakeDirectory (const std::string& path) -> bool
+{
+  return mkdir (path.c_str (), 0755) == 0 || errno == EEXIST;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Read the number in the column of the line which starts with the label.
+auto ParseNumber (const std::string& log, const std::string& label,
+                  int column = 0) -> double
+{
+  std::istringstream iss (log);
+  std::string line;
+  while (std::getline (iss, line))
+  {
+    if (line.compare (0, label.size (), label) != 0) { continue; }
+    std::istringstream fields (line.substr (label.size ()));
+    double value = 0;
+    for (int i = 0; i <= column; ++i) { fields >> value; }
+    return value;
+  }
+  return 0;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Render the scene in the directory of it. The output is written to log.txt
+// of the directory.
+auto Run (const std::string& renderer, const std::string& scene) -> RunResult
+{
+  const auto directory = scene.substr (0, scene.find_last_of ('/'));
+  const auto log       = JoinPath (directory, "log.txt");
+
+  RunResult result;
+  const auto start = std::chrono::steady_clock::now ();
+  const pid_t pid = fork ();
+  if (pid < 0)
+  {
+    std::cerr << "Failed to fork the renderer." << std::endl;
+    return result;
+  }
+  if (pid == 0)
+  {
+    // The renderer writes the images to the working directory.
+    const int fd = open (log.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || chdir (directory.c_str ()) != 0) { _exit (127); }
+    dup2 (fd, STDOUT_FILENO);
+    dup2 (fd, STDERR_FILENO);
+    close (fd);
+    execl (renderer.c_str (), renderer.c_str (), scene.c_str (),
+           static_cast <char*> (nullptr));
+    _exit (127);
+  }
+
+  int status = 0;
+  struct rusage usage;
+  if (wait4 (pid, &status, 0, &usage) < 0)
+  {
+    std::cerr << "Failed to wait for the renderer." << std::endl;
+    return result;
+  }
+  result.wall_seconds = std::chrono::duration <double>
+    (std::chrono::steady_clock::now () - start).count ();
+  if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+  {
+    std::cerr << "The renderer failed. See " << log << std::endl;
+    return result;
+  }
+
+  // The maximum resident set size is in kilobytes on Linux.
+  result.peak_rss_mb = usage.ru_maxrss / 1024.0;
+
+  std::ifstream ifs (log);
+  const std::string text ((std::istreambuf_iterator <char> (ifs)),
+                          std::istreambuf_iterator <char> ());
+  // The rates printed by the renderer are rounded, so that they are
+  // computed from the counts and the wall time of the render stage.
+  const auto camera_rays = ParseNumber (text, "Camera rays ");
+  const auto rays        = camera_rays
+                         + ParseNumber (text, "Extension rays ")
+                         + ParseNumber (text, "Shadow rays ");
+  const auto seconds     = ParseNumber (text, "render ", 1);
+  if (seconds > 0)
+  {
+    result.mrays_per_second    = rays * 1e-6 / seconds;
+    result.msamples_per_second = camera_rays * 1e-6 / seconds;
+  }
+  result.succeeded = true;
+  return result;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Read a PFM file of the AOV buffer. The rows stay from the bottom.
+auto ReadPfm (const std::string& filename, Image* image) -> bool
+{
+  std::ifstream ifs (filename, std::ios::binary);
+  std::string type;
+  double scale = 0;
+  ifs >> type >> image->width >> image->height >> scale;
+  ifs.get ();
+  if (!ifs || type != "PF" || scale >= 0) { return false; }
+
+  image->rgb.resize (static_cast <std::size_t> (image->width)
+                     * image->height * 3);
+  ifs.read (reinterpret_cast <char*> (image->rgb.data ()),
+            image->rgb.size () * sizeof (float));
+  return static_cast <bool> (ifs);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Read the sum of the direct and indirect AOVs written to the directory.
+auto ReadRadiance (const std::string& directory, Image* image) -> bool
+{
+  Image indirect;
+  if (!ReadPfm (JoinPath (directory, "output_direct.pfm"), image) ||
+      !ReadPfm (JoinPath (directory, "output_indirect.pfm"), &indirect) ||
+      indirect.rgb.size () != image->rgb.size ())
+  {
+    std::cerr << "Failed to read the AOVs in " << directory << std::endl;
+    return false;
+  }
+  for (std::size_t i = 0; i < image->rgb.size (); ++i)
+  {
+    image->rgb[i] += indirect.rgb[i];
+  }
+  return true;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Return the RMSE and the relative MSE, which weights the error of dark
+// pixels as much as bright ones.
+auto Errors (const Image& image, const Image& reference)
+  -> std::pair <double, double>
+{
+  double se = 0, relative = 0;
+  for (std::size_t i = 0; i < image.rgb.size (); ++i)
+  {
+    const double r = reference.rgb[i];
+    const double d = image.rgb[i] - r;
+    se       += d * d;
+    relative += d * d / (r * r + 0.01);
+  }
+  const auto n = static_cast <double> (std::max <std::size_t>
+                                       (image.rgb.size (), 1));
+  return std::make_pair (std::sqrt (se / n), relative / n);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+int main (int argc, char* argv[])
+{
+  if (argc < 5)
+  {
+    std::cerr << "Usage : " << argv[0]
+              << " <renderer> <directory> <reference_spp>"
+              << " <budget_ms> [budget_ms ...]" << std::endl;
+    return 1;
+  }
+
+  // The renderer runs in other directories.
+  char path[PATH_MAX];
+  if (realpath (argv[1], path) == nullptr)
+  {
+    std::cerr << "Renderer is not found : " << argv[1] << std::endl;
+    return 1;
+  }
+  const std::string renderer = path;
+  if (!MakeDirectory (argv[2]) || realpath (argv[2], path) == nullptr)
+  {
+    std::cerr << "Failed to make directory : " << argv[2] << std::endl;
+    return 1;
+  }
+  const std::string directory = path;
+  const int reference_spp     = std::atoi (argv[3]);
+  std::vector <unsigned int> budgets;
+  for (int i = 4; i < argc; ++i)
+  {
+    const int budget = std::atoi (argv[i]);
+    if (budget > 0) { budgets.push_back (budget); }
+  }
+  if (reference_spp <= 0 || budgets.empty ())
+  {
+    std::cerr << "The samples and the budgets must be positive." << std::endl;
+    return 1;
+  }
+
+  const std::vector <RegressionScene> scenes =
+  {
+    {"cornell_box", niepce::GenerateCornellBox},
+    {"dense_mesh",  [] (const std::string& d,
+                        const niepce::GeneratorSettings& s)
+                    {
+                      return niepce::GenerateDenseMesh (d, 48, s);
+                    }},
+    {"many_lights", [] (const std::string& d,
+                        const niepce::GeneratorSettings& s)
+                    {
+                      return niepce::GenerateManyLights (d, 1000, 1, s);
+                    }},
+    {"hdri",        niepce::GenerateHdri}
+  };
+
+  niepce::GeneratorSettings settings;
+  settings.width          = kResolution;
+  settings.height         = kResolution;
+  settings.light_sampling = niepce::LightSampling::kBvh;
+  settings.aovs = niepce::AovBit (niepce::Aov::kDirect)
+                | niepce::AovBit (niepce::Aov::kIndirect);
+
+  std::ofstream json (JoinPath (directory, "report.json"));
+  std::ofstream csv  (JoinPath (directory, "report.csv"));
+  if (!json || !csv)
+  {
+    std::cerr << "Failed to open the reports in " << directory << std::endl;
+    return 1;
+  }
+  csv << "scene,budget_ms,wall_seconds,peak_rss_mb,mrays_per_second,"
+      << "msamples_per_second,rmse,relmse\n";
+  json << "{\n  \"reference_spp\": " << reference_spp
+       << ",\n  \"resolution\": " << kResolution
+       << ",\n  \"runs\": [";
+
+  int num_failures = 0;
+  bool first = true;
+  for (const auto& scene : scenes)
+  {
+    const auto scene_directory = JoinPath (directory, scene.name);
+    MakeDirectory (scene_directory);
+
+    // The reference is rendered in rounds, so that a progressive film is
+    // not needed to hold many samples.
+    const auto reference = JoinPath (scene_directory, "reference");
+    if (!Exists (JoinPath (reference, "output_indirect.pfm")))
+    {
+      auto s  = settings;
+      s.spp   = std::min <unsigned int> (reference_spp, kReferenceSpp);
+      s.round = (reference_spp + s.spp - 1) / s.spp;
+      std::cout << scene.name << " : reference of " << s.spp * s.round
+                << " spp" << std::endl;
+      const auto file = MakeDirectory (reference)
+                      ? scene.generate (reference, s) : "";
+      if (file.empty () || !Run (renderer, file).succeeded)
+      {
+        std::cerr << "Failed to render the reference of " << scene.name
+                  << std::endl;
+        ++num_failures;
+        continue;
+      }
+    }
+    Image reference_image;
+    if (!ReadRadiance (reference, &reference_image))
+    {
+      ++num_failures;
+      continue;
+    }
+
+    // A sample per round, so that the render stops close to the budget.
+    for (const auto budget : budgets)
+    {
+      auto s       = settings;
+      s.spp        = 1;
+      s.round      = reference_spp;
+      s.time_limit = budget;
+
+      const auto run = JoinPath (scene_directory,
+                                 "budget_" + std::to_string (budget));
+      const auto file = MakeDirectory (run) ? scene.generate (run, s) : "";
+      const auto result = file.empty () ? RunResult () : Run (renderer, file);
+      Image image;
+      if (!result.succeeded || !ReadRadiance (run, &image) ||
+          image.rgb.size () != reference_image.rgb.size ())
+      {
+        std::cerr << "Failed to render " << scene.name << " in "
+                  << budget << " ms" << std::endl;
+        ++num_failures;
+        continue;
+      }
+      const auto errors = Errors (image, reference_image);
+
+      std::cout << std::fixed << std::setprecision (3)
+                << std::setw (12) << scene.name
+                << std::setw (8)  << budget << " ms"
+                << std::setw (10) << result.wall_seconds << " s"
+                << std::setw (10) << result.peak_rss_mb << " MB"
+                << std::setw (10) << result.mrays_per_second << " Mrays/s"
+                << "  RMSE " << std::setprecision (6) << errors.first
+                << "  relMSE " << errors.second << std::endl;
+
+      csv << std::setprecision (6) << scene.name << "," << budget << ","
+          << result.wall_seconds << "," << result.peak_rss_mb << ","
+          << result.mrays_per_second << ","
+          << result.msamples_per_second << ","
+          << errors.first << "," << errors.second << "\n";
+      json << std::setprecision (6) << (first ? "\n" : ",\n")
+           << "    {\"scene\": \"" << scene.name << "\""
+           << ", \"budget_ms\": " << budget
+           << ", \"wall_seconds\": " << result.wall_seconds
+           << ", \"peak_rss_mb\": " << result.peak_rss_mb
+           << ", \"mrays_per_second\": " << result.mrays_per_second
+           << ", \"msamples_per_second\": " << result.msamples_per_second
+           << ", \"rmse\": " << errors.first
+           << ", \"relmse\": " << errors.second << "}";
+      first = false;
+    }
+  }
+  json << "\n  ]\n}\n";
+
+  // The survival scales are learned while rendering, so that they must not
+  // depend on the number of tasks, which changes how the tiles are split.
+  {
+    auto s     = settings;
+    s.spp      = kReferenceSpp;
+    s.round    = 4;
+    s.roulette = niepce::RussianRoulette::kEfficiency;
+    std::vector <Image> images;
+    for (const auto threads : {1u, kNumTasks})
+    {
+      s.threads = threads;
+      const auto run = JoinPath (directory, "determinism_"
+                                 + std::to_string (threads));
+      const auto file = MakeDirectory (run)
+                      ? niepce::GenerateCornellBox (run, s) : "";
+      Image image;
+      if (file.empty () || !Run (renderer, file).succeeded ||
+          !ReadRadiance (run, &image))
+      {
+        break;
+      }
+      images.push_back (image);
+    }
+    const bool identical = images.size () == 2
+                        && images[0].rgb == images[1].rgb;
+    std::cout << "Determinism : " << (identical ? "identical" : "differs")
+              << " with 1 and " << kNumTasks << " tasks" << std::endl;
+    if (!identical) { ++num_failures; }
+  }
+
+  return num_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,616 @@
+/*!
+ * @file scene_generator.cc
+ * @brief Procedural scenes for benchmarks.
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#include "scene_generator.h"
+#include "../core/aov_buffer.h"
+#include "../ext/stb/stb_image_write.h"
+#include "../random/xorshift.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+struct ObjWriter
+{
+  std::ofstream ofs;
+  int num_vertices = 0;
+
+  // Write a triangle. The front face is counter clockwise.
+  auto Triangle (const std::array <std::array <Float, 3>, 3>& p) -> void
+  {
+    for (const auto& v : p)
+    {
+      ofs << "v " << v[0] << " " << v[1] << " " << v[2] << "\n";
+    }
+    ofs << "f " << num_vertices + 1
+        << " "  << num_vertices + 2
+        << " "  << num_vertices + 3 << "\n";
+    num_vertices += 3;
+  }
+
+  // Write a planar quad. The front face is counter clockwise.
+  auto Quad (const std::array <std::array <Float, 3>, 4>& p) -> void
+  {
+    Triangle ({{p[0], p[1], p[2]}});
+    Triangle ({{p[0], p[2], p[3]}});
+  }
+
+  // Write an axis aligned box whose faces face outward.
+  auto Box (const std::array <Float, 3>& lo, const std::array <Float, 3>& hi)
+    -> void
+  {
+    const Float x0 = lo[0], y0 = lo[1], z0 = lo[2];
+    const Float x1 = hi[0], y1 = hi[1], z1 = hi[2];
+    Quad ({{{x0, y1, z0}, {x0, y1, z1}, {x1, y1, z1}, {x1, y1, z0}}});
+    Quad ({{{x0, y0, z0}, {x1, y0, z0}, {x1, y0, z1}, {x0, y0, z1}}});
+    Quad ({{{x0, y0, z1}, {x1, y0, z1}, {x1, y1, z1}, {x0, y1, z1}}});
+    Quad ({{{x0, y0, z0}, {x0, y1, z0}, {x1, y1, z0}, {x1, y0, z0}}});
+    Quad ({{{x1, y0, z0}, {x1, y1, z0}, {x1, y1, z1}, {x1, y0, z1}}});
+    Quad ({{{x0, y0, z0}, {x0, y0, z1}, {x0, y1, z1}, {x0, y1, z0}}});
+  }
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+auto JoinPath (const std::string& directory, const std::string& filename)
+  -> std::string
+{
+  if (directory.empty () || directory.back () == '/')
+  {
+    return directory + filename;
+  }
+  return directory + "/" + filename;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto WriteHeader
+(
+ std::ofstream&           ofs,
+ const GeneratorSettings& settings,
+ const std::string&       origin,
+ const std::string&       target,
+ const std::string&       output
+)
+  -> void
+{
+  ofs << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+      << "<scene>\n"
+      << "  <camera type=\"pinhole\">\n"
+      << "    <lookat>\n"
+      << "      <point3  name=\"origin\" value=\"" << origin << "\"/>\n"
+      << "      <point3  name=\"target\" value=\"" << target << "\"/>\n"
+      << "      <vector3 name=\"up\"     value=\"0 1 0\"/>\n"
+      << "    </lookat>\n"
+      << "    <float name=\"fov\"            value=\"45\"/>\n"
+      << "    <float name=\"focus_distance\" value=\"1000\"/>\n"
+      << "    <float name=\"lens_radius\"    value=\"0\"/>\n"
+      << "    <film>\n"
+      << "      <int    name=\"width\"    value=\"" << settings.width  << "\"/>\n"
+      << "      <int    name=\"height\"   value=\"" << settings.height << "\"/>\n"
+      << "      <float  name=\"diagonal\" value=\"35\"/>\n"
+      << "      <string name=\"output\"   value=\"" << output << "\"/>\n"
+      << "    </film>\n"
+      << "  </camera>\n";
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto WriteSettings (std::ofstream& ofs, const GeneratorSettings& settings)
+  -> void
+{
+  ofs << "  <settings>\n"
+      << "    <int    name=\"spp\"         value=\"" << settings.spp         << "\"/>\n"
+      << "    <int    name=\"depth\"       value=\"" << settings.depth       << "\"/>\n"
+      << "    <int    name=\"round\"       value=\"" << settings.round       << "\"/>\n"
+      << "    <int    name=\"tile_width\"  value=\"" << settings.tile_width  << "\"/>\n"
+      << "    <int    name=\"tile_height\" value=\"" << settings.tile_height << "\"/>\n"
+      << "    <string name=\"light_sampling\" value=\""
+      << ToString (settings.light_sampling) << "\"/>\n"
+      << "    <string name=\"mis\"            value=\""
+      << ToString (settings.mis) << "\"/>\n"
+      << "    <string name=\"roulette\"       value=\""
+      << ToString (settings.roulette) << "\"/>\n"
+      << "    <int    name=\"roulette_depth\" value=\""
+      << settings.roulette_depth << "\"/>\n"
+      << "    <string name=\"sampler\"        value=\""
+      << ToString (settings.sampler) << "\"/>\n"
+      << "    <string name=\"film\"           value=\""
+      << ToString (settings.film) << "\"/>\n"
+      << "    <string name=\"denoiser\"       value=\""
+      << ToString (settings.denoiser) << "\"/>\n"
+      << "    <string name=\"aovs\"           value=\""
+      << AovsToString (settings.aovs) << "\"/>\n"
+      << "    <bool   name=\"trace\"          value=\""
+      << (settings.trace ? "true" : "false") << "\"/>\n"
+      << "    <int    name=\"time_limit\"     value=\""
+      << settings.time_limit << "\"/>\n"
+      << "    <int    name=\"threads\"        value=\""
+      << settings.threads << "\"/>\n"
+      << "  </settings>\n"
+      << "</scene>\n";
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ToString (LightSampling sampling) -> std::string
+{
+  switch (sampling)
+  {
+    case LightSampling::kUniform : return "uniform";
+    case LightSampling::kBvh     : return "bvh";
+    default                      : return "power";
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ToString (MisHeuristic mis) -> std::string
+{
+  return mis == MisHeuristic::kNone ? "none" : "power";
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ToString (RussianRoulette roulette) -> std::string
+{
+  switch (roulette)
+  {
+    case RussianRoulette::kThroughput : return "throughput";
+    case RussianRoulette::kEfficiency : return "efficiency";
+    default                           : return "none";
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ToString (SamplerType sampler) -> std::string
+{
+  switch (sampler)
+  {
+    case SamplerType::kRandom    : return "random";
+    case SamplerType::kBlueNoise : return "blue_noise";
+    default                      : return "sobol";
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ToString (FilmAccumulation film) -> std::string
+{
+  switch (film)
+  {
+    case FilmAccumulation::kAtomic : return "atomic";
+    case FilmAccumulation::kStream : return "stream";
+    default                        : return "tile";
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ToString (DenoiserType denoiser) -> std::string
+{
+  return denoiser == DenoiserType::kBilateral ? "bilateral" : "none";
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto AovsToString (unsigned int aovs) -> std::string
+{
+  std::string names;
+  for (int i = 0; i < static_cast <int> (Aov::kNumAovs); ++i)
+  {
+    if ((aovs & AovBit (static_cast <Aov> (i))) == 0) { continue; }
+    if (!names.empty ()) { names += " "; }
+    names += AovName (static_cast <Aov> (i));
+  }
+  return names;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto GenerateManyLights
+(
+ const std::string&       directory,
+ int                      num_emitters,
+ int                      seed,
+ const GeneratorSettings& settings
+)
+  -> std::string
+{
+  // Radiance of each emission class. Brighter classes have fewer emitters.
+  static constexpr int   kNumClasses = 4;
+  static const     Float kRadiance[kNumClasses] = {1, 4, 16, 64};
+  static const     Float kFraction[kNumClasses] = {0.6, 0.25, 0.1, 0.05};
+
+  static constexpr Float kExtent  = 10;   // Half size of the floor.
+  static constexpr Float kHeight  = 3;    // Height of the emitters.
+  static constexpr Float kSize    = 0.15; // Size of the emitters.
+
+  const std::string prefix = "many_lights_" + std::to_string (num_emitters)
+                           + "_" + std::to_string (seed);
+
+  // Floor and occluders face upward.
+  {
+    ObjWriter obj;
+    obj.ofs.open (JoinPath (directory, prefix + "_floor.obj"));
+    if (!obj.ofs) { return ""; }
+    const Float e = kExtent;
+    obj.Triangle ({{{-e, 0, -e}, {-e, 0,  e}, { e, 0,  e}}});
+    obj.Triangle ({{{-e, 0, -e}, { e, 0,  e}, { e, 0, -e}}});
+
+    // Slabs to cast shadows from nearby emitters. Triangles are backface
+    // culled, so that the bottom faces are needed to block shadow rays.
+    XorShift rng (seed + 1);
+    for (int i = 0; i < 16; ++i)
+    {
+      const Float x = (rng.Next01 () * 2 - 1) * (kExtent - 1);
+      const Float z = (rng.Next01 () * 2 - 1) * (kExtent - 1);
+      const Float y = 0.5 + rng.Next01 () * 1.5;
+      obj.Triangle ({{{x - 1, y, z - 1}, {x - 1, y, z + 1}, {x + 1, y, z + 1}}});
+      obj.Triangle ({{{x - 1, y, z - 1}, {x + 1, y, z + 1}, {x + 1, y, z - 1}}});
+      obj.Triangle ({{{x - 1, y, z - 1}, {x + 1, y, z + 1}, {x - 1, y, z + 1}}});
+      obj.Triangle ({{{x - 1, y, z - 1}, {x + 1, y, z - 1}, {x + 1, y, z + 1}}});
+    }
+  }
+
+  // Emitters face downward, grouped by emission classes.
+  {
+    std::array <ObjWriter, kNumClasses> objs;
+    for (int c = 0; c < kNumClasses; ++c)
+    {
+      objs[c].ofs.open (JoinPath (directory, prefix + "_emitter"
+                                  + std::to_string (c) + ".obj"));
+      if (!objs[c].ofs) { return ""; }
+    }
+
+    XorShift rng (seed);
+    for (int i = 0; i < num_emitters; ++i)
+    {
+      // Choose a class. Every class has at least one emitter.
+      int c = i < kNumClasses ? i : 0;
+      if (i >= kNumClasses)
+      {
+        Float u = rng.Next01 ();
+        while (c < kNumClasses - 1 && u >= kFraction[c])
+        {
+          u -= kFraction[c++];
+        }
+      }
+
+      const Float x = (rng.Next01 () * 2 - 1) * kExtent;
+      const Float z = (rng.Next01 () * 2 - 1) * kExtent;
+      const Float y = kHeight + rng.Next01 () * 0.5;
+      const Float s = kSize;
+      objs[c].Triangle ({{{x, y, z}, {x + s, y, z}, {x, y, z + s}}});
+    }
+  }
+
+  // Scene file.
+  const std::string scene = JoinPath
+    (directory, prefix + "_" + ToString (settings.light_sampling) + ".xml");
+  std::ofstream ofs (scene);
+  if (!ofs) { return ""; }
+
+  WriteHeader (ofs, settings, "0 1.5 -14", "0 1 0",
+               prefix + "_" + ToString (settings.light_sampling) + ".png");
+
+  ofs << "  <material type=\"matte\" id=\"floor\">\n"
+      << "    <rgb name=\"reflectance\" value=\"0.75 0.75 0.75\"/>\n"
+      << "  </material>\n"
+      << "  <material type=\"matte\" id=\"emitter\">\n"
+      << "    <rgb name=\"reflectance\" value=\"0 0 0\"/>\n"
+      << "  </material>\n";
+  for (int c = 0; c < kNumClasses; ++c)
+  {
+    const Float r = kRadiance[c];
+    ofs << "  <light type=\"area\" id=\"emission" << c << "\">\n"
+        << "    <rgb name=\"emission\" value=\""
+        << r << " " << r << " " << r << "\"/>\n"
+        << "  </light>\n";
+  }
+
+  ofs << "  <shape type=\"obj\" id=\"floor\">\n"
+      << "    <string    name=\"filename\" value=\"" << prefix << "_floor.obj\"/>\n"
+      << "    <reference name=\"material\" value=\"floor\"/>\n"
+      << "  </shape>\n";
+  for (int c = 0; c < kNumClasses; ++c)
+  {
+    ofs << "  <shape type=\"obj\" id=\"emitter" << c << "\">\n"
+        << "    <string    name=\"filename\" value=\""
+        << prefix << "_emitter" << c << ".obj\"/>\n"
+        << "    <reference name=\"material\" value=\"emitter\"/>\n"
+        << "    <reference name=\"light\"    value=\"emission" << c << "\"/>\n"
+        << "  </shape>\n";
+  }
+
+  WriteSettings (ofs, settings);
+  return scene;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto GenerateCornellBox
+(
+ const std::string&       directory,
+ const GeneratorSettings& settings
+)
+  -> std::string
+{
+  // The walls face into the room, whose front is open to the camera.
+  {
+    ObjWriter white, red, green, boxes, lamp;
+    white.ofs.open (JoinPath (directory, "cornell_box_white.obj"));
+    red.ofs.open   (JoinPath (directory, "cornell_box_red.obj"));
+    green.ofs.open (JoinPath (directory, "cornell_box_green.obj"));
+    boxes.ofs.open (JoinPath (directory, "cornell_box_boxes.obj"));
+    lamp.ofs.open  (JoinPath (directory, "cornell_box_lamp.obj"));
+    if (!white.ofs || !red.ofs || !green.ofs || !boxes.ofs || !lamp.ofs)
+    {
+      return "";
+    }
+
+    white.Quad ({{{-1, 0, -1}, {-1, 0,  1}, { 1, 0,  1}, { 1, 0, -1}}});
+    white.Quad ({{{-1, 2, -1}, { 1, 2, -1}, { 1, 2,  1}, {-1, 2,  1}}});
+    white.Quad ({{{-1, 0,  1}, {-1, 2,  1}, { 1, 2,  1}, { 1, 0,  1}}});
+    red.Quad   ({{{-1, 0, -1}, {-1, 2, -1}, {-1, 2,  1}, {-1, 0,  1}}});
+    green.Quad ({{{ 1, 0, -1}, { 1, 0,  1}, { 1, 2,  1}, { 1, 2, -1}}});
+
+    boxes.Box ({{-0.7, 0,  0.0}}, {{-0.1, 1.2, 0.6}});
+    boxes.Box ({{ 0.1, 0, -0.5}}, {{ 0.7, 0.6, 0.1}});
+
+    // The lamp faces downward just under the ceiling.
+    const Float s = 0.25, y = 1.99;
+    lamp.Quad ({{{-s, y, -s}, { s, y, -s}, { s, y,  s}, {-s, y,  s}}});
+  }
+
+  // Scene file.
+  const std::string scene = JoinPath (directory, "cornell_box.xml");
+  std::ofstream ofs (scene);
+  if (!ofs) { return ""; }
+
+  WriteHeader (ofs, settings, "0 1 -3.4", "0 1 0", "cornell_box.png");
+
+  ofs << "  <material type=\"matte\" id=\"white\">\n"
+      << "    <rgb name=\"reflectance\" value=\"0.73 0.73 0.73\"/>\n"
+      << "  </material>\n"
+      << "  <material type=\"matte\" id=\"red\">\n"
+      << "    <rgb name=\"reflectance\" value=\"0.65 0.05 0.05\"/>\n"
+      << "  </material>\n"
+      << "  <material type=\"matte\" id=\"green\">\n"
+      << "    <rgb name=\"reflectance\" value=\"0.12 0.45 0.15\"/>\n"
+      << "  </material>\n"
+      << "  <material type=\"matte\" id=\"emitter\">\n"
+      << "    <rgb name=\"reflectance\" value=\"0 0 0\"/>\n"
+      << "  </material>\n"
+      << "  <light type=\"area\" id=\"lamp\">\n"
+      << "    <rgb name=\"emission\" value=\"17 12 4\"/>\n"
+      << "  </light>\n";
+
+  const std::array <std::array <std::string, 2>, 4> shapes
+    = {{{{"white", "white"}}, {{"red",   "red"}},
+        {{"green", "green"}}, {{"boxes", "white"}}}};
+  for (const auto& shape : shapes)
+  {
+    ofs << "  <shape type=\"obj\" id=\"" << shape[0] << "\">\n"
+        << "    <string    name=\"filename\" value=\"cornell_box_"
+        << shape[0] << ".obj\"/>\n"
+        << "    <reference name=\"material\" value=\"" << shape[1] << "\"/>\n"
+        << "  </shape>\n";
+  }
+  ofs << "  <shape type=\"obj\" id=\"lamp\">\n"
+      << "    <string    name=\"filename\" value=\"cornell_box_lamp.obj\"/>\n"
+      << "    <reference name=\"material\" value=\"emitter\"/>\n"
+      << "    <reference name=\"light\"    value=\"lamp\"/>\n"
+      << "  </shape>\n";
+
+  WriteSettings (ofs, settings);
+  return scene;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto GenerateDenseMesh
+(
+ const std::string&       directory,
+ int                      resolution,
+ const GeneratorSettings& settings
+)
+  -> std::string
+{
+  const std::string prefix = "dense_mesh_" + std::to_string (resolution);
+
+  // A bumpy sphere of about 4 * resolution^2 triangles, which face outward.
+  {
+    ObjWriter obj;
+    obj.ofs.open (JoinPath (directory, prefix + ".obj"));
+    if (!obj.ofs) { return ""; }
+
+    const int rings    = resolution;
+    const int segments = resolution * 2;
+    const Float center = 1.1;
+    const auto p = [rings, segments, center] (int i, int j)
+      -> std::array <Float, 3>
+    {
+      const Float theta = kPi * i / rings;
+      const Float phi   = 2 * kPi * j / segments;
+      const Float r     = 1 + 0.05 * std::sin (8 * theta) * std::sin (8 * phi);
+      return {{r * std::sin (theta) * std::cos (phi),
+               r * std::cos (theta) + center,
+               r * std::sin (theta) * std::sin (phi)}};
+    };
+    for (int i = 0; i < rings; ++i)
+    {
+      for (int j = 0; j < segments; ++j)
+      {
+        // Triangles at the poles are degenerate.
+        if (i > 0)
+        {
+          obj.Triangle ({{p (i, j), p (i, j + 1), p (i + 1, j)}});
+        }
+        if (i < rings - 1)
+        {
+          obj.Triangle ({{p (i, j + 1), p (i + 1, j + 1), p (i + 1, j)}});
+        }
+      }
+    }
+  }
+
+  // Floor and the lamp above the mesh.
+  {
+    ObjWriter floor, lamp;
+    floor.ofs.open (JoinPath (directory, "dense_mesh_floor.obj"));
+    lamp.ofs.open  (JoinPath (directory, "dense_mesh_lamp.obj"));
+    if (!floor.ofs || !lamp.ofs) { return ""; }
+    const Float e = 5, s = 0.75, y = 4;
+    floor.Quad ({{{-e, 0, -e}, {-e, 0,  e}, { e, 0,  e}, { e, 0, -e}}});
+    lamp.Quad  ({{{-s, y, -s}, { s, y, -s}, { s, y,  s}, {-s, y,  s}}});
+  }
+
+  // Scene file.
+  const std::string scene = JoinPath (directory, prefix + ".xml");
+  std::ofstream ofs (scene);
+  if (!ofs) { return ""; }
+
+  WriteHeader (ofs, settings, "0 2 -4.5", "0 1 0", prefix + ".png");
+
+  ofs << "  <material type=\"matte\" id=\"floor\">\n"
+      << "    <rgb name=\"reflectance\" value=\"0.75 0.75 0.75\"/>\n"
+      << "  </material>\n"
+      << "  <material type=\"matte\" id=\"mesh\">\n"
+      << "    <rgb name=\"reflectance\" value=\"0.7 0.5 0.3\"/>\n"
+      << "  </material>\n"
+      << "  <material type=\"matte\" id=\"emitter\">\n"
+      << "    <rgb name=\"reflectance\" value=\"0 0 0\"/>\n"
+      << "  </material>\n"
+      << "  <light type=\"area\" id=\"lamp\">\n"
+      << "    <rgb name=\"emission\" value=\"20 20 20\"/>\n"
+      << "  </light>\n"
+      << "  <shape type=\"obj\" id=\"mesh\">\n"
+      << "    <string    name=\"filename\" value=\"" << prefix << ".obj\"/>\n"
+      << "    <reference name=\"material\" value=\"mesh\"/>\n"
+      << "  </shape>\n"
+      << "  <shape type=\"obj\" id=\"floor\">\n"
+      << "    <string    name=\"filename\" value=\"dense_mesh_floor.obj\"/>\n"
+      << "    <reference name=\"material\" value=\"floor\"/>\n"
+      << "  </shape>\n"
+      << "  <shape type=\"obj\" id=\"lamp\">\n"
+      << "    <string    name=\"filename\" value=\"dense_mesh_lamp.obj\"/>\n"
+      << "    <reference name=\"material\" value=\"emitter\"/>\n"
+      << "    <reference name=\"light\"    value=\"lamp\"/>\n"
+      << "  </shape>\n";
+
+  WriteSettings (ofs, settings);
+  return scene;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto GenerateHdri
+(
+ const std::string&       directory,
+ const GeneratorSettings& settings
+)
+  -> std::string
+{
+  // A latitude longitude sky which is bright at the zenith, with a small
+  // sun. Rows are from the top.
+  {
+    static constexpr int kWidth = 256, kHeight = 128;
+    std::vector <float> sky (kWidth * kHeight * 3);
+    for (int y = 0; y < kHeight; ++y)
+    {
+      for (int x = 0; x < kWidth; ++x)
+      {
+        const float v  = (y + 0.5f) / kHeight;
+        const float up = std::max (0.0f, 1 - 2 * v);
+        float rgb[3] = {0.4f + 0.6f * up, 0.6f + 0.6f * up, 1.0f + 0.8f * up};
+        if (v > 0.5f) { rgb[0] = rgb[1] = rgb[2] = 0.1f; }
+
+        const float du = (x + 0.5f) / kWidth - 0.3f, dv = v - 0.25f;
+        if (du * du + dv * dv < 0.0004f)
+        {
+          rgb[0] = 400; rgb[1] = 380; rgb[2] = 340;
+        }
+        for (int c = 0; c < 3; ++c) { sky[(y * kWidth + x) * 3 + c] = rgb[c]; }
+      }
+    }
+    const auto filename = JoinPath (directory, "hdri_sky.hdr");
+    if (!stbi_write_hdr (filename.c_str (), kWidth, kHeight, 3, sky.data ()))
+    {
+      return "";
+    }
+
+    ObjWriter floor;
+    floor.ofs.open (JoinPath (directory, "hdri_floor.obj"));
+    if (!floor.ofs) { return ""; }
+    const Float e = 6;
+    floor.Quad ({{{-e, 0, -e}, {-e, 0,  e}, { e, 0,  e}, { e, 0, -e}}});
+  }
+
+  // Scene file.
+  const std::string scene = JoinPath (directory, "hdri.xml");
+  std::ofstream ofs (scene);
+  if (!ofs) { return ""; }
+
+  WriteHeader (ofs, settings, "0 1.5 -6", "0 0.6 0", "hdri.png");
+
+  ofs << "  <light type=\"infinite\" id=\"sky\">\n"
+      << "    <string name=\"filename\" value=\"hdri_sky.hdr\"/>\n"
+      << "  </light>\n"
+      << "  <material type=\"matte\" id=\"floor\">\n"
+      << "    <rgb name=\"reflectance\" value=\"0.5 0.5 0.5\"/>\n"
+      << "  </material>\n"
+      << "  <material type=\"plastic\" id=\"plastic\">\n"
+      << "    <rgb   name=\"reflectance\" value=\"0.2 0.3 0.6\"/>\n"
+      << "    <rgb   name=\"specular\"    value=\"0.5 0.5 0.5\"/>\n"
+      << "    <float name=\"roughness\"   value=\"0.1\"/>\n"
+      << "  </material>\n"
+      << "  <material type=\"mirror\" id=\"mirror\">\n"
+      << "    <rgb name=\"reflectance\" value=\"0.9 0.9 0.9\"/>\n"
+      << "  </material>\n"
+      << "  <shape type=\"obj\" id=\"floor\">\n"
+      << "    <string    name=\"filename\" value=\"hdri_floor.obj\"/>\n"
+      << "    <reference name=\"material\" value=\"floor\"/>\n"
+      << "  </shape>\n";
+
+  const std::array <const char*, 3> materials = {{"floor", "plastic", "mirror"}};
+  for (int i = 0; i < 3; ++i)
+  {
+    ofs << "  <shape type=\"sphere\" id=\"sphere" << i << "\">\n"
+        << "    <float     name=\"radius\"    value=\"0.6\"/>\n"
+        << "    <transform>\n"
+        << "      <vector3 name=\"translate\" value=\""
+        << (i - 1) * 1.4 << " 0.6 0\"/>\n"
+        << "    </transform>\n"
+        << "    <reference name=\"material\"  value=\"" << materials[i]
+        << "\"/>\n"
+        << "  </shape>\n";
+  }
+
+  WriteSettings (ofs, settings);
+  return scene;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,204 @@
+/*!
+ * @file scene_generator.h
+ * @brief Procedural scenes for benchmarks.
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ */
+#ifndef _SCENE_GENERATOR_H_
+#define _SCENE_GENERATOR_H_
+/*
+// ---------------------------------------------------------------------------
+*/
+#include "../core/niepce.h"
+#include "../core/render_settings.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @struct GeneratorSettings
+ * @brief Render settings written to the generated scene files.
+ */
+struct GeneratorSettings
+{
+  unsigned int width         = 512;
+  unsigned int height        = 512;
+  unsigned int spp           = 4;
+  unsigned int depth         = 8;
+  unsigned int round         = 1;
+  unsigned int tile_width    = 32;
+  unsigned int tile_height   = 32;
+  LightSampling light_sampling = LightSampling::kPower;
+  MisHeuristic  mis            = MisHeuristic::kPower;
+  RussianRoulette roulette     = RussianRoulette::kThroughput;
+  unsigned int  roulette_depth = 3;
+  SamplerType   sampler        = SamplerType::kSobol;
+  FilmAccumulation film        = FilmAccumulation::kTile;
+  DenoiserType     denoiser    = DenoiserType::kNone;
+  unsigned int     aovs        = 0;  // The bits of Aov.
+  bool             trace       = false;
+  unsigned int     time_limit  = 0;  // Milliseconds, or 0 for all rounds.
+  unsigned int     threads     = 0;  // Render tasks, or 0 for each core.
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn std::string ToString (LightSampling)
+ * @brief Return the name of the strategy used in the scene file.
+ * @param[in] sampling
+ * @return
+ * @exception none
+ * @details
+ */
+auto ToString (LightSampling sampling) -> std::string;
+/*!
+ * @fn std::string ToString (MisHeuristic)
+ * @brief Return the name of the heuristic used in the scene file.
+ * @param[in] mis
+ * @return
+ * @exception none
+ * @details
+ */
+auto ToString (MisHeuristic mis) -> std::string;
+/*!
+ * @fn std::string ToString (RussianRoulette)
+ * @brief Return the name of the termination policy used in the scene file.
+ * @param[in] roulette
+ * @return
+ * @exception none
+ * @details
+ */
+auto ToString (RussianRoulette roulette) -> std::string;
+/*!
+ * @fn std::string ToString (SamplerType)
+ * @brief Return the name of the sampler used in the scene file.
+ * @param[in] sampler
+ * @return
+ * @exception none
+ * @details
+ */
+auto ToString (SamplerType sampler) -> std::string;
+/*!
+ * @fn std::string ToString (FilmAccumulation)
+ * @brief Return the name of the film accumulation used in the scene file.
+ * @param[in] film
+ * @return
+ * @exception none
+ * @details
+ */
+auto ToString (FilmAccumulation film) -> std::string;
+/*!
+ * @fn std::string ToString (DenoiserType)
+ * @brief Return the name of the denoiser used in the scene file.
+ * @param[in] denoiser
+ * @return
+ * @exception none
+ * @details
+ */
+auto ToString (DenoiserType denoiser) -> std::string;
+/*!
+ * @fn std::string AovsToString (unsigned int)
+ * @brief Return the names of the AOVs used in the scene file.
+ * @param[in] aovs
+ *    The bits of Aov.
+ * @return The names separated by spaces.
+ * @exception none
+ * @details
+ */
+auto AovsToString (unsigned int aovs) -> std::string;
+/*
+// ---------------------------------------------------------------------------
+*/
+/*!
+ * @fn std::string GenerateManyLights (const std::string&, int, int, const GeneratorSettings&)
+ * @brief Write a scene lit by many small emitters.
+ * @param[in] directory
+ *    The directory to write the scene. It must exist.
+ * @param[in] num_emitters
+ *    The number of emissive triangles.
+ * @param[in] seed
+ *    The seed of the placement of emitters.
+ * @param[in] settings
+ * @return The path of the scene file, or empty string if failed.
+ * @exception none
+ * @details Emitters are scattered under the ceiling of a floor plane and
+ *          face downward. They are grouped into emission classes whose
+ *          radiance differs by an order of magnitude, so that the choice of
+ *          the light sampling strategy changes the noise a lot. Meshes are
+ *          shared between calls with the same arguments except settings.
+ */
+auto GenerateManyLights
+(
+ const std::string&       directory,
+ int                      num_emitters,
+ int                      seed,
+ const GeneratorSettings& settings
+)
+  -> std::string;
+/*!
+ * @fn std::string GenerateCornellBox (const std::string&, const GeneratorSettings&)
+ * @brief Write a Cornell box lit by a small lamp under the ceiling.
+ * @param[in] directory
+ *    The directory to write the scene. It must exist.
+ * @param[in] settings
+ * @return The path of the scene file, or empty string if failed.
+ * @exception none
+ * @details Most of the light is indirect, which converges slowly.
+ */
+auto GenerateCornellBox
+(
+ const std::string&       directory,
+ const GeneratorSettings& settings
+)
+  -> std::string;
+/*!
+ * @fn std::string GenerateDenseMesh (const std::string&, int, const GeneratorSettings&)
+ * @brief Write a scene of a finely tessellated mesh on a floor.
+ * @param[in] directory
+ *    The directory to write the scene. It must exist.
+ * @param[in] resolution
+ *    The number of rings of the mesh. It has about 4 * resolution^2
+ *    triangles.
+ * @param[in] settings
+ * @return The path of the scene file, or empty string if failed.
+ * @exception none
+ * @details The cost is dominated by the build and the traversal of the BVH.
+ */
+auto GenerateDenseMesh
+(
+ const std::string&       directory,
+ int                      resolution,
+ const GeneratorSettings& settings
+)
+  -> std::string;
+/*!
+ * @fn std::string GenerateHdri (const std::string&, const GeneratorSettings&)
+ * @brief Write spheres on a floor lit by an environment map.
+ * @param[in] directory
+ *    The directory to write the scene. It must exist.
+ * @param[in] settings
+ * @return The path of the scene file, or empty string if failed.
+ * @exception none
+ * @details The map is written as a Radiance HDR file, which has a small and
+ *          bright sun.
+ */
+auto GenerateHdri
+(
+ const std::string&       directory,
+ const GeneratorSettings& settings
+)
+  -> std::string;
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+#endif // _SCENE_GENERATOR_H_
@@ -0,0 +1,95 @@
+/*!
+ * @file scene_generator_main.cc
+ * @brief Write procedural scenes for benchmarks.
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ *   Usage : niepce_scene_generator <directory> many_lights <N> [seed] [spp]
+ *           niepce_scene_generator <directory> cornell_box
+ *           niepce_scene_generator <directory> dense_mesh <resolution>
+ *           niepce_scene_generator <directory> hdri
+ *
+ *   The many lights scene is written for each light sampling strategy, so
+ *   that the noise of them can be compared at equal time by adjusting spp of
+ *   each file.
+ */
+#include "scene_generator.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+int main (int argc, char* argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage : " << argv[0]
+              << " <directory> many_lights <N> [seed] [spp]\n"
+              << "        " << argv[0] << " <directory> cornell_box\n"
+              << "        " << argv[0] << " <directory> dense_mesh <resolution>\n"
+              << "        " << argv[0] << " <directory> hdri" << std::endl;
+    return 1;
+  }
+
+  const std::string directory = argv[1];
+  const std::string type      = argv[2];
+
+  if (type == "cornell_box" || type == "dense_mesh" || type == "hdri")
+  {
+    niepce::GeneratorSettings settings;
+    std::string scene;
+    if (type == "cornell_box")
+    {
+      scene = niepce::GenerateCornellBox (directory, settings);
+    }
+    else if (type == "hdri")
+    {
+      scene = niepce::GenerateHdri (directory, settings);
+    }
+    else if (argc > 3 && std::atoi (argv[3]) > 0)
+    {
+      scene = niepce::GenerateDenseMesh (directory, std::atoi (argv[3]),
+                                         settings);
+    }
+    if (scene.empty ())
+    {
+      std::cerr << "Failed to write scene into " << directory << std::endl;
+      return 1;
+    }
+    std::cout << scene << std::endl;
+    return 0;
+  }
+
+  if (argc < 4)
+  {
+    std::cerr << "Unknown scene : " << type << std::endl;
+    return 1;
+  }
+  const int num_emitters      = std::atoi (argv[3]);
+  const int seed              = argc > 4 ? std::atoi (argv[4]) : 1;
+
+  niepce::GeneratorSettings settings;
+  if (argc > 5) { settings.spp = std::atoi (argv[5]); }
+
+  if (type != "many_lights" || num_emitters <= 0)
+  {
+    std::cerr << "Unknown scene : " << type << " " << argv[3] << std::endl;
+    return 1;
+  }
+
+  for (const auto sampling : {niepce::LightSampling::kUniform,
+                              niepce::LightSampling::kPower,
+                              niepce::LightSampling::kBvh})
+  {
+    settings.light_sampling = sampling;
+    const auto scene = niepce::GenerateManyLights (directory,
+                                                   num_emitters,
+                                                   seed,
+                                                   settings);
+    if (scene.empty ())
+    {
+      std::cerr << "Failed to write scene into " << directory << std::endl;
+      return 1;
+    }
+    std::cout << scene << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,551 @@
+/*!
+ * @file validate_main.cc
+ * @brief Cross check of the accelerator against brute force.
+ * @author Masashi Yoshida
+ * @date
+ * @details
+ *   Usage : niepce_validate [--rays N] [--seed S] [--ray I]
+ *                           [scene.xml | mesh.obj ...]
+ *
+ *   Random rays are traced against random scenes and the given scene files,
+ *   both by Scene::IsIntersect and by testing every primitive. The hit, the
+ *   distance and the primitive of each ray must agree. A mismatch is
+ *   reported with the seed and the index of the ray, and --seed S --ray I
+ *   traces only that ray again.
+ *
+ *   Rays whose hits differ only in the primitive at the same distance, e.g.
+ *   on a shared edge, are counted as ties and are not errors.
+ *
+ *   An OBJ file is read both by ReadObj and by tinyobjloader, and the
+ *   meshes must be identical bit by bit.
+ */
+#include "../core/bounds3f.h"
+#include "../core/intersection.h"
+#include "../core/ray.h"
+#include "../core/singleton.h"
+#include "../core/thread_pool.h"
+#include "../core/transform.h"
+#include "../primitive/primitive.h"
+#include "../random/xorshift.h"
+#include "../scene/obj_reader.h"
+#include "../scene/scene.h"
+#include "../scene/scene_importer.h"
+#include "../shape/sphere.h"
+#include "../shape/triangle.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+constexpr std::size_t kRaysPerTask      = 1 << 14;
+constexpr std::size_t kReportMismatches = 10;
+
+struct Hit
+{
+  bool  hit       = false;
+  Float distance  = kInfinity;
+  int   primitive = -1;
+};
+
+struct Mismatch
+{
+  uint64_t index;
+  Ray      ray;
+  Hit      accelerated;
+  Hit      brute_force;
+};
+
+struct Result
+{
+  uint64_t rays = 0;
+  uint64_t hits = 0;
+  uint64_t ties = 0;
+  uint64_t mismatches = 0;
+  std::vector <Mismatch> reported;  // The first mismatches.
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+// Return a generator of the stream, e.g. a ray, so that each stream is
+// reproduced from the seed and the index alone. The first numbers of
+// XorShift follow the seed closely, so that they are discarded.
+auto Generator (uint32_t seed, uint64_t index) -> XorShift
+{
+  uint64_t h = (static_cast <uint64_t> (seed) << 32) ^ index;
+  h ^= h >> 33; h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+
+  XorShift rng (static_cast <uint32_t> (h) | 1);
+  for (int i = 0; i < 64; ++i) { rng.Next (); }
+  return rng;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto RandomPoint (const Bounds3f& bounds, XorShift* rng) -> Point3f
+{
+  const auto& lo = bounds.Min ();
+  const auto& hi = bounds.Max ();
+  return Point3f (lo.X () + (hi.X () - lo.X ()) * rng->Next01 (),
+                  lo.Y () + (hi.Y () - lo.Y ()) * rng->Next01 (),
+                  lo.Z () + (hi.Z () - lo.Z ()) * rng->Next01 ());
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Rays from the bounds a little enlarged. A quarter go to a random point
+// of the scene, and an eighth go along an axis, which the slab test of the
+// bounds handles separately.
+auto GenerateRay (const Bounds3f& bounds, uint32_t seed, uint64_t index)
+  -> Ray
+{
+  auto rng = Generator (seed, index);
+
+  const auto margin = bounds.Diagonal () * 0.1;
+  const Bounds3f outer (bounds.Min () + (-margin), bounds.Max () + margin);
+  const auto origin = RandomPoint (outer, &rng);
+
+  const Float u = rng.Next01 ();
+  Vector3f direction;
+  if (u < 0.125)
+  {
+    const int axis = std::min (static_cast <int> (u * 48), 5);
+    Float d[3] = {0, 0, 0};
+    d[axis % 3] = axis < 3 ? 1 : -1;
+    direction = Vector3f (d[0], d[1], d[2]);
+  }
+  else if (u < 0.375)
+  {
+    direction = RandomPoint (bounds, &rng) - origin;
+  }
+  else
+  {
+    const Float z   = 1 - 2 * rng.Next01 ();
+    const Float r   = std::sqrt (std::fmax (0.0, 1 - z * z));
+    const Float phi = 2 * kPi * rng.Next01 ();
+    direction = Vector3f (r * std::cos (phi), r * std::sin (phi), z);
+  }
+  if (direction.LengthSquared () == 0) { direction = Vector3f (0, 1, 0); }
+  return Ray (origin, Normalize (direction));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Trace (const Scene& scene, const Ray& ray, bool brute_force) -> Hit
+{
+  Intersection intersection;
+  Hit hit;
+  hit.hit = brute_force ? scene.IsIntersectBruteForce (ray, &intersection)
+                        : scene.IsIntersect (ray, &intersection);
+  if (hit.hit)
+  {
+    hit.distance  = intersection.Distance ();
+    hit.primitive = scene.PrimitiveIndex (intersection.Primitive ().get ());
+  }
+  return hit;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ValidateRays
+(
+ const Scene*    scene,
+ const Bounds3f* bounds,
+ uint32_t        seed,
+ uint64_t        begin,
+ uint64_t        end
+)
+  -> Result
+{
+  Result result;
+  for (auto i = begin; i < end; ++i)
+  {
+    const auto ray = GenerateRay (*bounds, seed, i);
+    const auto a   = Trace (*scene, ray, false);
+    const auto b   = Trace (*scene, ray, true);
+    ++result.rays;
+    if (b.hit) { ++result.hits; }
+
+    if (a.hit == b.hit && (!a.hit || a.primitive == b.primitive))
+    {
+      // The same primitive must give the same distance.
+      if (a.distance == b.distance || !a.hit) { continue; }
+    }
+    else if (a.hit && b.hit)
+    {
+      const auto tolerance = 1e-5 * std::max (static_cast <Float> (1),
+                                              b.distance);
+      if (std::abs (a.distance - b.distance) <= tolerance)
+      {
+        ++result.ties;
+        continue;
+      }
+    }
+
+    ++result.mismatches;
+    if (result.reported.size () < kReportMismatches)
+    {
+      result.reported.push_back (Mismatch {i, ray, a, b});
+    }
+  }
+  return result;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ToString (const Hit& hit) -> std::string
+{
+  if (!hit.hit) { return "miss"; }
+  std::ostringstream oss;
+  oss << std::setprecision (9) << "t " << hit.distance
+      << " primitive " << hit.primitive;
+  return oss.str ();
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Report
+(
+ const std::string& name,
+ uint32_t           seed,
+ const Mismatch&    mismatch
+)
+  -> void
+{
+  const auto& o = mismatch.ray.Origin ();
+  const auto& d = mismatch.ray.Direction ();
+  std::cout << std::setprecision (9)
+            << "  " << name << " --seed " << seed
+            << " --ray " << mismatch.index << "\n"
+            << "    origin    " << o.X () << " " << o.Y () << " " << o.Z ()
+            << "\n    direction " << d.X () << " " << d.Y () << " " << d.Z ()
+            << "\n    bvh         " << ToString (mismatch.accelerated)
+            << "\n    brute force " << ToString (mismatch.brute_force)
+            << std::endl;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Trace the rays on the pool, and return false if any ray mismatched.
+auto Validate
+(
+ const std::string& name,
+ const Scene&       scene,
+ uint32_t           seed,
+ uint64_t           first,
+ uint64_t           num_rays
+)
+  -> bool
+{
+  const auto bounds = scene.Bounds ();
+  auto& pool = Singleton <ThreadPool>::Instance ();
+  std::vector <std::future <Result>> futures;
+  for (auto begin = first; begin < first + num_rays; begin += kRaysPerTask)
+  {
+    const auto end = std::min (begin + kRaysPerTask, first + num_rays);
+    futures.push_back (pool.Enqueue (&ValidateRays, &scene, &bounds,
+                                     seed, begin, end));
+  }
+
+  Result total;
+  for (auto& f : futures)
+  {
+    const auto result = f.get ();
+    total.rays       += result.rays;
+    total.hits       += result.hits;
+    total.ties       += result.ties;
+    total.mismatches += result.mismatches;
+    for (const auto& m : result.reported)
+    {
+      if (total.reported.size () < kReportMismatches)
+      {
+        total.reported.push_back (m);
+      }
+    }
+  }
+
+  std::cout << std::left << std::setw (24) << name << std::right
+            << std::setw (12) << total.rays << " rays"
+            << std::setw (12) << total.hits << " hits"
+            << std::setw (8)  << total.ties << " ties"
+            << std::setw (8)  << total.mismatches << " mismatches"
+            << std::endl;
+  for (const auto& m : total.reported) { Report (name, seed, m); }
+  return total.mismatches == 0;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto Triangle
+(
+ const std::array <Point3f, 3>& p,
+ std::vector <std::shared_ptr <Primitive>>* primitives
+)
+  -> void
+{
+  std::vector <Float> positions;
+  for (const auto& v : p)
+  {
+    positions.push_back (v.X ());
+    positions.push_back (v.Y ());
+    positions.push_back (v.Z ());
+  }
+  const std::shared_ptr <TriangleMesh> mesh (CreateMesh (positions, {}, {}));
+  const std::array <int, 3> none = {{-1, -1, -1}};
+  const std::shared_ptr <Shape> shape
+    (CreateTriangle (mesh, {{0, 1, 2}}, none, none));
+  primitives->push_back (CreatePrimitive (shape, nullptr, nullptr));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Triangles of random sizes and orientations which overlap each other.
+auto RandomTriangles (int n, uint32_t seed)
+  -> std::vector <std::shared_ptr <Primitive>>
+{
+  auto rng = Generator (seed, 1ULL << 40);
+  const Bounds3f unit (Point3f (0, 0, 0), Point3f (1, 1, 1));
+  std::vector <std::shared_ptr <Primitive>> primitives;
+  for (int i = 0; i < n; ++i)
+  {
+    const auto center = RandomPoint (unit, &rng);
+    const Float size  = 0.01 + 0.2 * rng.Next01 ();
+    std::array <Point3f, 3> p;
+    for (auto& v : p)
+    {
+      v = center + Vector3f (rng.Next01 () - 0.5,
+                             rng.Next01 () - 0.5,
+                             rng.Next01 () - 0.5) * size;
+    }
+    Triangle (p, &primitives);
+  }
+  return primitives;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// Axis aligned quads, whose bounds are flat, facing both ways.
+auto RandomQuads (int n, uint32_t seed)
+  -> std::vector <std::shared_ptr <Primitive>>
+{
+  auto rng = Generator (seed, 2ULL << 40);
+  std::vector <std::shared_ptr <Primitive>> primitives;
+  for (int i = 0; i < n; ++i)
+  {
+    const int axis = static_cast <int> (rng.Next01 () * 3) % 3;
+    const Float c  = rng.Next01 ();
+    const Float u0 = rng.Next01 () * 0.8, u1 = u0 + 0.2;
+    const Float v0 = rng.Next01 () * 0.8, v1 = v0 + 0.2;
+    const auto point = [axis, c] (Float u, Float v)
+    {
+      return axis == 0 ? Point3f (c, u, v)
+           : axis == 1 ? Point3f (v, c, u)
+           :             Point3f (u, v, c);
+    };
+    const auto a = point (u0, v0), b = point (u1, v0);
+    const auto d = point (u1, v1), e = point (u0, v1);
+    if (rng.Next01 () < 0.5)
+    {
+      Triangle ({{a, b, d}}, &primitives);
+      Triangle ({{a, d, e}}, &primitives);
+    }
+    else
+    {
+      Triangle ({{a, d, b}}, &primitives);
+      Triangle ({{a, e, d}}, &primitives);
+    }
+  }
+  return primitives;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+// A closed grid of triangles which share edges and vertices.
+auto Grid (int n, uint32_t seed) -> std::vector <std::shared_ptr <Primitive>>
+{
+  auto rng = Generator (seed, 3ULL << 40);
+  std::vector <Point3f> p;
+  for (int y = 0; y <= n; ++y)
+  {
+    for (int x = 0; x <= n; ++x)
+    {
+      p.push_back (Point3f (static_cast <Float> (x) / n,
+                            0.1 * rng.Next01 (),
+                            static_cast <Float> (y) / n));
+    }
+  }
+  std::vector <std::shared_ptr <Primitive>> primitives;
+  for (int y = 0; y < n; ++y)
+  {
+    for (int x = 0; x < n; ++x)
+    {
+      const int i = y * (n + 1) + x;
+      Triangle ({{p[i], p[i + n + 1], p[i + n + 2]}}, &primitives);
+      Triangle ({{p[i], p[i + n + 2], p[i + 1]}},     &primitives);
+    }
+  }
+  return primitives;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto RandomSpheres (int n, uint32_t seed)
+  -> std::vector <std::shared_ptr <Primitive>>
+{
+  auto rng = Generator (seed, 4ULL << 40);
+  const Bounds3f unit (Point3f (0, 0, 0), Point3f (1, 1, 1));
+  std::vector <std::shared_ptr <Primitive>> primitives;
+  for (int i = 0; i < n; ++i)
+  {
+    const auto center = RandomPoint (unit, &rng);
+    const auto sphere = CreateSphere
+      (Translate (Vector3f (center.X (), center.Y (), center.Z ())),
+       0.005 + 0.1 * rng.Next01 ());
+    primitives.push_back (CreatePrimitive (sphere, nullptr, nullptr));
+  }
+  return primitives;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+template <typename T>
+auto SameArrays (const T* lhs, std::size_t n, const T* rhs, std::size_t m)
+  -> bool
+{
+  return n == m && (n == 0 || std::memcmp (lhs, rhs, n * sizeof (T)) == 0);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+auto ValidateObj (const std::string& filename) -> bool
+{
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now ();
+  IndexedMesh mesh;
+  if (!ReadObj (filename, &mesh)) { return false; }
+  const auto middle = Clock::now ();
+  IndexedMesh reference;
+  if (!ReadObjWithTinyObj (filename, &reference)) { return false; }
+  const auto stop = Clock::now ();
+
+  const auto& a = *mesh.mesh;
+  const auto& b = *reference.mesh;
+  const bool same =
+       SameArrays (a.Positions (), a.NumPositions (),
+                   b.Positions (), b.NumPositions ())
+    && SameArrays (a.Normals (), a.NumNormals (),
+                   b.Normals (), b.NumNormals ())
+    && SameArrays (a.Texcoords (), a.NumTexcoords (),
+                   b.Texcoords (), b.NumTexcoords ())
+    && SameArrays (mesh.triangles, mesh.num_triangles,
+                   reference.triangles, reference.num_triangles);
+
+  const auto ms = [] (Clock::duration d)
+  {
+    return std::chrono::duration <double, std::milli> (d).count ();
+  };
+  std::cout << filename << " : " << mesh.num_triangles << " triangles, "
+            << ms (middle - start) << " ms against "
+            << ms (stop - middle) << " ms of tinyobjloader, "
+            << (same ? "identical" : "DIFFERENT") << std::endl;
+  return same;
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
+int main (int argc, char* argv[])
+{
+  uint64_t num_rays = 1000000;
+  uint32_t seed     = 1;
+  int64_t  ray      = -1;
+  std::vector <std::string> files;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (i + 1 < argc && arg == "--rays")
+    {
+      num_rays = std::strtoull (argv[++i], nullptr, 10);
+    }
+    else if (i + 1 < argc && arg == "--seed")
+    {
+      seed = std::strtoul (argv[++i], nullptr, 10);
+    }
+    else if (i + 1 < argc && arg == "--ray")
+    {
+      ray = std::strtoll (argv[++i], nullptr, 10);
+    }
+    else if (arg.compare (0, 2, "--") == 0)
+    {
+      std::cerr << "Usage : " << argv[0]
+                << " [--rays N] [--seed S] [--ray I]"
+                << " [scene.xml | mesh.obj ...]"
+                << std::endl;
+      return 1;
+    }
+    else
+    {
+      files.push_back (arg);
+    }
+  }
+  const uint64_t first = ray < 0 ? 0 : ray;
+  if (ray >= 0) { num_rays = 1; }
+
+  using Primitives = std::vector <std::shared_ptr <niepce::Primitive>>;
+  const std::vector <std::pair <std::string, Primitives>> random =
+  {
+    {"random_triangles", niepce::RandomTriangles (1000, seed)},
+    {"random_quads",     niepce::RandomQuads     (250,  seed)},
+    {"grid",             niepce::Grid            (24,   seed)},
+    {"random_spheres",   niepce::RandomSpheres   (200,  seed)}
+  };
+  Primitives mixed;
+  for (const auto& scene : random)
+  {
+    mixed.insert (mixed.end (), scene.second.begin (), scene.second.end ());
+  }
+
+  bool valid = true;
+  for (const auto& scene : random)
+  {
+    const std::unique_ptr <niepce::Scene> s
+      (niepce::CreateScene (scene.second, {}, nullptr));
+    valid &= niepce::Validate (scene.first, *s, seed, first, num_rays);
+  }
+  {
+    const std::unique_ptr <niepce::Scene> s
+      (niepce::CreateScene (mixed, {}, nullptr));
+    valid &= niepce::Validate ("mixed", *s, seed, first, num_rays);
+  }
+  for (const auto& file : files)
+  {
+    const auto extension = file.substr (file.find_last_of ('.') + 1);
+    if (extension == "obj")
+    {
+      valid &= niepce::ValidateObj (file);
+      continue;
+    }
+    niepce::SceneImporter importer (file.c_str ());
+    const auto scene = importer.ExtractScene ();
+    valid &= niepce::Validate (file, *scene, seed, first, num_rays);
+  }
+
+  niepce::SingletonFinalizer::Finalize ();
+  return valid ? 0 : 1;
+}
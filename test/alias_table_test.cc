@@ -0,0 +1,77 @@
+/*
+// ---------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "../src/sampler/alias_table.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+class AliasTableTest : public ::testing::Test {};
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (AliasTableTest, Empty)
+{
+  const AliasTable table;
+  Float pdf = 1;
+  EXPECT_EQ (table.Sample (0.5, &pdf), -1);
+  EXPECT_EQ (pdf, 0);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (AliasTableTest, Pdf)
+{
+  const AliasTable table ({1, 3, 0, 4});
+  EXPECT_EQ (table.Size (), 4);
+  EXPECT_FLOAT_EQ (table.Pdf (0), 0.125);
+  EXPECT_FLOAT_EQ (table.Pdf (1), 0.375);
+  EXPECT_FLOAT_EQ (table.Pdf (2), 0.0);
+  EXPECT_FLOAT_EQ (table.Pdf (3), 0.5);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (AliasTableTest, ZeroWeights)
+{
+  const AliasTable table ({0, 0});
+  EXPECT_FLOAT_EQ (table.Pdf (0), 0.5);
+  EXPECT_FLOAT_EQ (table.Pdf (1), 0.5);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (AliasTableTest, Sample)
+{
+  const std::vector <Float> weights = {1, 3, 0, 4};
+  const AliasTable table (weights);
+
+  const int n = 8000;
+  std::vector <int> counts (weights.size (), 0);
+  for (int i = 0; i < n; ++i)
+  {
+    Float pdf = 0, remapped = 0;
+    const auto idx = table.Sample ((i + 0.5) / n, &pdf, &remapped);
+    ASSERT_GE (idx, 0);
+    EXPECT_FLOAT_EQ (pdf, table.Pdf (idx));
+    EXPECT_GE (remapped, 0);
+    EXPECT_LT (remapped, 1);
+    counts[idx]++;
+  }
+  for (std::size_t i = 0; i < weights.size (); ++i)
+  {
+    EXPECT_NEAR (static_cast <Float> (counts[i]) / n, table.Pdf (i), 1e-3);
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,39 @@
+/*
+// ---------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "../src/core/atomic_float.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+class AtomicFloatTest : public ::testing::Test {};
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (AtomicFloatTest, ConcurrentAdd)
+{
+  // Integers below 2^24 are exact, so that no add may be lost.
+  AtomicFloat sum;
+  std::vector <std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back ([&sum] ()
+    {
+      for (int i = 0; i < 100000; ++i) { sum.Add (1); }
+    });
+  }
+  for (auto& t : threads) { t.join (); }
+  EXPECT_EQ (sum.Load (), 400000);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
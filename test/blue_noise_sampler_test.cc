@@ -0,0 +1,55 @@
+/*
+// ---------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "../src/core/point2f.h"
+#include "../src/sampler/blue_noise_sampler.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+class BlueNoiseSamplerTest : public ::testing::Test {};
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (BlueNoiseSamplerTest, Mask)
+{
+  // Every rank appears once.
+  std::vector <int> count (kBlueNoiseSize * kBlueNoiseSize, 0);
+  for (const auto& rank : kBlueNoiseMask) { ++count[rank]; }
+  for (const auto& c : count) { EXPECT_EQ (c, 1); }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (BlueNoiseSamplerTest, Stratification)
+{
+  // The shift of the mask keeps 16 samples of the pixel stratified in
+  // 4 x 4 strata.
+  BlueNoiseSampler sampler (16, 0);
+  for (int y = 0; y < 4; ++y)
+  {
+    for (int x = 0; x < 4; ++x)
+    {
+      std::vector <int> count (16, 0);
+      for (int i = 0; i < 16; ++i)
+      {
+        sampler.StartPixelSample (x, y, i);
+        const auto p = sampler.Next2f ();
+        ++count[static_cast <int> (p[1] * 4) * 4 + static_cast <int> (p[0] * 4)];
+      }
+      for (const auto& c : count) { EXPECT_EQ (c, 1); }
+    }
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,75 @@
+/*
+// ---------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "../src/random/counter_rng.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+class CounterRngTest : public ::testing::Test {};
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (CounterRngTest, FillMatchesAt)
+{
+  // The float of a number is its upper 23 bits over 2^23, which is exact.
+  const auto to_float = [] (uint32_t x)
+  {
+    return static_cast <Float> (x >> 9) / static_cast <Float> (1 << 23);
+  };
+
+  // The low half of the last keys wraps the counter plus the key.
+  const uint64_t keys[] =
+  {
+    0, 1, 0x0123456789abcdefull, 0xffffffff00000000ull, 0x00000000fffffffcull,
+    0xfffffffffffffff9ull
+  };
+  const uint32_t counters[] =
+  {
+    0, 1, 8, 1000, 0x7ffffffc, 0xfffffff0, 0xfffffff8, 0xfffffffb, 0xffffffff
+  };
+  ALIGN16 std::array <Float, CounterRng::kBlockSize> values;
+  for (const auto key : keys)
+  {
+    for (const auto counter : counters)
+    {
+      CounterRng::Fill01 (key, counter, values.data ());
+      for (uint32_t i = 0; i < CounterRng::kBlockSize; ++i)
+      {
+        // The counter wraps around 2^32.
+        EXPECT_EQ (values[i], to_float (CounterRng::At (key, counter + i)))
+          << "key " << key << " counter " << counter << " + " << i;
+      }
+    }
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (CounterRngTest, NextMatchesAt)
+{
+  // Next01 () reads the blocks of Fill01 (), also across the wrap.
+  CounterRng rng (0x0123456789abcdefull);
+  rng.SetCounter (0xfffffffa);
+  CounterRng expected (0x0123456789abcdefull);
+  expected.SetCounter (0xfffffffa);
+  for (uint32_t i = 0; i < 20; ++i)
+  {
+    const auto bits = expected.Next ();
+    EXPECT_EQ (rng.Next01 (),
+               static_cast <Float> (bits >> 9)
+               / static_cast <Float> (1 << 23));
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
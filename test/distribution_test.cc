@@ -0,0 +1,63 @@
+/*
+// ---------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "../src/sampler/distribution.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+class DistributionTest : public ::testing::Test {};
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (DistributionTest, Sample1D)
+{
+  const std::vector <Float> func = {1, 0, 3};
+  const Distribution1D dist (func.data (), func.size ());
+  EXPECT_FLOAT_EQ (dist.Integral (), 4.0 / 3.0);
+
+  Float pdf = 0;
+  int   offset = -1;
+  const auto x = dist.SampleContinuous (0.5, &pdf, &offset);
+  EXPECT_EQ (offset, 2);
+  EXPECT_FLOAT_EQ (pdf, 3.0 / dist.Integral ());
+  EXPECT_GE (x, 2.0 / 3.0);
+  EXPECT_LT (x, 1.0);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (DistributionTest, Pdf2D)
+{
+  // 2 x 2 function stored as rows.
+  const std::vector <Float> func = {1, 1, 0, 2};
+  const Distribution2D dist (func.data (), 2, 2);
+
+  const int n = 64;
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      Float pdf = 0;
+      const auto p = dist.SampleContinuous (Point2f ((i + 0.5) / n,
+                                                     (j + 0.5) / n),
+                                            &pdf);
+      EXPECT_GT (pdf, 0);
+      EXPECT_FLOAT_EQ (pdf, dist.Pdf (p));
+    }
+  }
+  EXPECT_FLOAT_EQ (dist.Pdf (Point2f (0.25, 0.75)), 0.0);
+  EXPECT_FLOAT_EQ (dist.Pdf (Point2f (0.75, 0.75)), 2.0);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,188 @@
+/*
+// ---------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "../src/scene/obj_reader.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+class ObjReaderTest : public ::testing::Test
+{
+protected:
+  // Write the text to a file of the test, and return the name of it.
+  auto Write (const std::string& name, const std::string& text) -> std::string
+  {
+    const auto filename = ::testing::TempDir () + "obj_reader_test_" + name;
+    std::ofstream ofs (filename, std::ios::binary);
+    ofs << text;
+    filenames_.push_back (filename);
+    return filename;
+  }
+
+  // Parse the file by ReadObj, split into chunks of the size, and expect
+  // the mesh that tinyobjloader gives.
+  auto ExpectSameAsTinyObj (const std::string& filename,
+                            std::size_t min_chunk_size = 1 << 20) -> void
+  {
+    IndexedMesh expected, actual;
+    ASSERT_TRUE (ReadObjWithTinyObj (filename, &expected));
+    ASSERT_TRUE (ReadObj (filename, &actual, min_chunk_size));
+
+    const auto& e = *expected.mesh;
+    const auto& a = *actual.mesh;
+    ASSERT_EQ (a.NumPositions (), e.NumPositions ());
+    for (std::size_t i = 0; i < e.NumPositions (); ++i)
+    {
+      EXPECT_EQ (a.Positions ()[i].X (), e.Positions ()[i].X ());
+      EXPECT_EQ (a.Positions ()[i].Y (), e.Positions ()[i].Y ());
+      EXPECT_EQ (a.Positions ()[i].Z (), e.Positions ()[i].Z ());
+    }
+    ASSERT_EQ (a.NumNormals (), e.NumNormals ());
+    for (std::size_t i = 0; i < e.NumNormals (); ++i)
+    {
+      EXPECT_EQ (a.Normals ()[i].X (), e.Normals ()[i].X ());
+      EXPECT_EQ (a.Normals ()[i].Y (), e.Normals ()[i].Y ());
+      EXPECT_EQ (a.Normals ()[i].Z (), e.Normals ()[i].Z ());
+    }
+    ASSERT_EQ (a.NumTexcoords (), e.NumTexcoords ());
+    for (std::size_t i = 0; i < e.NumTexcoords (); ++i)
+    {
+      EXPECT_EQ (a.Texcoords ()[i].X (), e.Texcoords ()[i].X ());
+      EXPECT_EQ (a.Texcoords ()[i].Y (), e.Texcoords ()[i].Y ());
+    }
+    ASSERT_EQ (actual.num_triangles, expected.num_triangles);
+    for (std::size_t i = 0; i < expected.num_triangles; ++i)
+    {
+      EXPECT_EQ (actual.triangles[i].position, expected.triangles[i].position)
+        << "triangle " << i;
+      EXPECT_EQ (actual.triangles[i].normal,   expected.triangles[i].normal)
+        << "triangle " << i;
+      EXPECT_EQ (actual.triangles[i].texcoord, expected.triangles[i].texcoord)
+        << "triangle " << i;
+    }
+  }
+
+  auto TearDown () -> void override
+  {
+    for (const auto& filename : filenames_) { std::remove (filename.c_str ()); }
+  }
+
+private:
+  std::vector <std::string> filenames_;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (ObjReaderTest, RelativeIndices)
+{
+  ExpectSameAsTinyObj (Write ("relative.obj",
+    "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+    "f -4 -3 -2\n"
+    "v 0 0 1\n"
+    "f -1 1 -3\n"
+    "f 2 -2 4\n"));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (ObjReaderTest, FaceVertexForms)
+{
+  ExpectSameAsTinyObj (Write ("forms.obj",
+    "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+    "vn 0 0 1\nvn 0 0 -1\n"
+    "vt 0 0\nvt 1 0\nvt 1 1\n"
+    "f 1//1 2//1 3//2\n"
+    "f 1/1 3/2 4/3\n"
+    "f 2/1/1 3/2/2 4/3/1\n"
+    "f -4/-3/-2 -3/-2/-1 -2/-1/-2\n"));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (ObjReaderTest, Polygons)
+{
+  ExpectSameAsTinyObj (Write ("polygons.obj",
+    "v 0 0 0\nv 1 0 0\nv 2 1 0\nv 1 2 0\nv 0 1 0\nv 0 0 1\n"
+    "vn 0 0 1\n"
+    "f 1 2 3 4\n"
+    "f 1 6 2\n"
+    "f 1//1 2//1 3//1 4//1 5//1\n"));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (ObjReaderTest, CarriageReturns)
+{
+  ExpectSameAsTinyObj (Write ("crlf.obj",
+    "# comment\r\n"
+    "v 0 0 0\r\nv 1 0 0\r\nv 1 1 0\r\nv 0 1 0\r\n"
+    "vt 0.5 0.25\r\n"
+    "f 1/1 2/1 3/1\r\n"
+    "f 1 3 4 2\r\n"));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (ObjReaderTest, IndexOutOfRange)
+{
+  const std::string vertices
+    = "v 0 0 0\nv 1 0 0\nv 1 1 0\nvn 0 0 1\nvt 0 0\n";
+  const char* faces[] =
+  {
+    "f -9 -8 -7\n",           // Before the first vertex.
+    "f 1 2 4\n",              // After the last vertex.
+    "f 1 2 3 4\n",            // In a polygon.
+    "f 1//1 2//2 3//1\n",     // A normal.
+    "f 1/1 2/2 3/1\n",        // A texcoord.
+    "f 1//-2 2//1 3//1\n",    // A relative normal which resolves to -1.
+  };
+  for (const auto face : faces)
+  {
+    const auto filename = Write ("range.obj", vertices + face);
+    for (const std::size_t min_chunk_size : {std::size_t (1) << 20,
+                                             std::size_t (1)})
+    {
+      IndexedMesh mesh;
+      EXPECT_FALSE (ReadObj (filename, &mesh, min_chunk_size)) << face;
+    }
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (ObjReaderTest, Chunks)
+{
+  // Enough lines that every chunk has vertices and relative faces which
+  // refer to the chunks before.
+  std::ostringstream oss;
+  oss << "v 0 0 0\nv 1 0 0\nvn 0 0 1\nvt 0 0\n";
+  for (int i = 0; i < 300; ++i)
+  {
+    oss << "v " << i * 0.25 << " " << i % 7 << " " << -i * 1.5e-3 << "\n"
+        << "vn 0 " << i % 2 << " 1\n"
+        << "vt " << i / 300.0 << " 0.5\n";
+    switch (i % 4)
+    {
+      case 0: oss << "f -1 -2 -3\n"; break;
+      case 1: oss << "f -1//-1 1//1 -3//-2\n"; break;
+      case 2: oss << "f -1/-1/-1 2/1/1 -2/-2/-2 -3/-3/-3\n"; break;
+      case 3: oss << "f " << i + 3 << "/" << i + 2 << " 1/1 2/1\r\n"; break;
+    }
+  }
+  const auto filename = Write ("chunks.obj", oss.str ());
+  ExpectSameAsTinyObj (filename);
+  ExpectSameAsTinyObj (filename, 1);
+  ExpectSameAsTinyObj (filename, 4096);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,80 @@
+/*
+// ---------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <random>
+#include "../src/renderer/path_statistics.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+class PathStatisticsTest : public ::testing::Test {};
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (PathStatisticsTest, MergeDoesNotDependOnSplit)
+{
+  // The throughput and the contribution of each vertex of each path.
+  struct Path
+  {
+    std::vector <Float> throughputs;
+    std::vector <Float> contributions;
+  };
+  std::mt19937 engine (7);
+  std::uniform_real_distribution <Float> uniform (0, 1);
+  std::vector <Path> paths (20000);
+  for (std::size_t i = 0; i < paths.size (); ++i)
+  {
+    Float throughput = 1, contribution = 0;
+    for (std::size_t d = 0; d < 3 + i % 5; ++d)
+    {
+      paths[i].throughputs.push_back (throughput);
+      paths[i].contributions.push_back (contribution);
+      contribution += throughput * uniform (engine) / (d + 1);
+      throughput   *= 0.3 + 0.6 * uniform (engine);
+    }
+    paths[i].contributions.push_back (contribution);
+  }
+  const auto record = [&paths] (std::size_t begin, std::size_t end,
+                                PathStatistics* statistics)
+  {
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      const auto& path = paths[i];
+      for (std::size_t d = 0; d < path.throughputs.size (); ++d)
+      {
+        statistics->Vertex (d, path.throughputs[d], path.contributions[d]);
+      }
+      statistics->Terminate (path.contributions.back ());
+    }
+  };
+
+  PathStatistics whole;
+  record (0, paths.size (), &whole);
+  const auto expected = whole.SurvivalScales (3, 8);
+  EXPECT_NE (expected[5], 1);
+
+  // Split as the scheduler does for more workers, and merge backwards.
+  const std::size_t splits[] = {0, 3, 1000, 9999, 12345, paths.size ()};
+  std::vector <PathStatistics> parts (5);
+  for (int i = 0; i < 5; ++i) { record (splits[i], splits[i + 1], &parts[i]); }
+  PathStatistics merged;
+  for (int i = 4; i >= 0; --i) { merged.Merge (parts[i]); }
+
+  EXPECT_EQ (merged.SurvivalScales (3, 8), expected);
+  for (unsigned int d = 0; d <= 8; ++d)
+  {
+    EXPECT_EQ (merged.NumPaths (d), whole.NumPaths (d));
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,140 @@
+/*
+// ---------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <cstring>
+#include "../src/scene/ply_reader.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+class PlyReaderTest : public ::testing::Test
+{
+protected:
+  // Append the bytes of the value in the byte order of the file.
+  template <typename T>
+  static auto Put (T value, bool big_endian, std::string* body) -> void
+  {
+    char bytes[sizeof (T)];
+    std::memcpy (bytes, &value, sizeof (T));
+    if (big_endian) { std::reverse (bytes, bytes + sizeof (T)); }
+    body->append (bytes, sizeof (T));
+  }
+
+  // A unit square of four vertices with normals and texcoords, and a quad
+  // face of a uchar count.
+  static auto Square (bool big_endian, int last_index = 3) -> std::string
+  {
+    std::string ply = std::string ("ply\n")
+      + (big_endian ? "format binary_big_endian 1.0\n"
+                    : "format binary_little_endian 1.0\n")
+      + "comment A unit square.\n"
+      + "element vertex 4\n"
+      + "property float x\nproperty float y\nproperty float z\n"
+      + "property float nx\nproperty float ny\nproperty float nz\n"
+      + "property float u\nproperty float v\n"
+      + "element face 1\n"
+      + "property list uchar int vertex_indices\n"
+      + "end_header\n";
+    const float corners[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    for (const auto& c : corners)
+    {
+      for (const float f : {c[0], c[1], 0.5f, 0.0f, 0.0f, 1.0f, c[0], c[1]})
+      {
+        Put (f, big_endian, &ply);
+      }
+    }
+    Put <uint8_t> (4, big_endian, &ply);
+    for (const int i : {0, 1, 2, last_index}) { Put (i, big_endian, &ply); }
+    return ply;
+  }
+
+  // Write the bytes to a file of the test, and return the name of it.
+  auto Write (const std::string& name, const std::string& bytes)
+    -> std::string
+  {
+    const auto filename = ::testing::TempDir () + "ply_reader_test_" + name;
+    std::ofstream ofs (filename, std::ios::binary);
+    ofs.write (bytes.data (), bytes.size ());
+    filenames_.push_back (filename);
+    return filename;
+  }
+
+  auto TearDown () -> void override
+  {
+    for (const auto& filename : filenames_) { std::remove (filename.c_str ()); }
+  }
+
+private:
+  std::vector <std::string> filenames_;
+};
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (PlyReaderTest, BothByteOrders)
+{
+  for (const bool big_endian : {false, true})
+  {
+    IndexedMesh mesh;
+    ASSERT_TRUE (ReadPly (Write ("square.ply", Square (big_endian)), &mesh));
+
+    const auto& m = *mesh.mesh;
+    ASSERT_EQ (m.NumPositions (), 4u);
+    ASSERT_EQ (m.NumNormals (),   4u);
+    ASSERT_EQ (m.NumTexcoords (), 4u);
+    EXPECT_EQ (m.Positions ()[2].X (), 1);
+    EXPECT_EQ (m.Positions ()[2].Y (), 1);
+    EXPECT_EQ (m.Positions ()[2].Z (), 0.5);
+    EXPECT_EQ (m.Normals ()[3].Z (), 1);
+    EXPECT_EQ (m.Texcoords ()[1].X (), 1);
+    EXPECT_EQ (m.Texcoords ()[1].Y (), 0);
+
+    // The quad is a fan of two triangles, and the attributes share the
+    // indices of the positions.
+    ASSERT_EQ (mesh.num_triangles, 2u);
+    const std::array <int, 3> first  = {0, 1, 2};
+    const std::array <int, 3> second = {0, 2, 3};
+    EXPECT_EQ (mesh.triangles[0].position, first);
+    EXPECT_EQ (mesh.triangles[1].position, second);
+    EXPECT_EQ (mesh.triangles[1].normal,   second);
+    EXPECT_EQ (mesh.triangles[1].texcoord, second);
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (PlyReaderTest, TruncatedBody)
+{
+  const auto ply = Square (false);
+  for (const std::size_t cut : {1, 5, 40})
+  {
+    IndexedMesh mesh;
+    EXPECT_FALSE (ReadPly (Write ("truncated.ply",
+                                  ply.substr (0, ply.size () - cut)),
+                           &mesh))
+      << cut << " bytes are cut";
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (PlyReaderTest, IndexOutOfRange)
+{
+  for (const int index : {4, -1})
+  {
+    IndexedMesh mesh;
+    EXPECT_FALSE (ReadPly (Write ("range.ply", Square (true, index)), &mesh))
+      << "index " << index;
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,63 @@
+/*
+// ---------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "../src/core/point2f.h"
+#include "../src/sampler/random_sampler.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+class RandomSamplerTest : public ::testing::Test {};
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (RandomSamplerTest, IndependentOfOrder)
+{
+  // The sample of a pixel is the same whatever was drawn before it.
+  RandomSampler a (1);
+  a.StartPixelSample (10, 20, 3);
+  a.StartDimension (8);
+  const auto expected = a.Next2f ();
+
+  RandomSampler b (1);
+  for (int i = 0; i < 100; ++i)
+  {
+    b.StartPixelSample (i, i, i);
+    b.Next1f ();
+  }
+  b.StartPixelSample (10, 20, 3);
+  for (int i = 0; i < 8; ++i) { b.Next1f (); }
+  const auto actual = b.Next2f ();
+
+  EXPECT_EQ (actual[0], expected[0]);
+  EXPECT_EQ (actual[1], expected[1]);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (RandomSamplerTest, Uniform)
+{
+  RandomSampler sampler (7);
+  std::vector <int> count (16, 0);
+  for (int i = 0; i < 16000; ++i)
+  {
+    sampler.StartPixelSample (i % 128, i / 128, 0);
+    const auto u = sampler.Next1f ();
+    ASSERT_GE (u, 0);
+    ASSERT_LT (u, 1);
+    ++count[static_cast <int> (u * 16)];
+  }
+  for (const auto& c : count) { EXPECT_NEAR (c, 1000, 150); }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
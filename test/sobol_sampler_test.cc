@@ -0,0 +1,66 @@
+/*
+// ---------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "../src/core/point2f.h"
+#include "../src/sampler/sobol_sampler.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+class SobolSamplerTest : public ::testing::Test {};
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (SobolSamplerTest, SobolSample)
+{
+  // The second dimension in the natural order of indices.
+  const Float expected[] = {0, 0.5, 0.75, 0.25, 0.625, 0.125, 0.375, 0.875};
+  for (int i = 0; i < 8; ++i)
+  {
+    EXPECT_FLOAT_EQ (SobolSample (i, 1) * 2.3283064365386963e-10,
+                     expected[i]);
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (SobolSamplerTest, Stratification)
+{
+  // 16 samples of every pair of dimensions fill each elementary interval
+  // of area 1/16 once.
+  SobolSampler sampler (16, 7);
+  std::vector <std::vector <Point2f>> points (3);
+  for (int i = 0; i < 16; ++i)
+  {
+    sampler.StartPixelSample (3, 5, i);
+    for (auto& p : points) { p.push_back (sampler.Next2f ()); }
+  }
+
+  for (const auto& p : points)
+  {
+    for (int log_x = 0; log_x <= 4; ++log_x)
+    {
+      const int nx = 1 << log_x;
+      const int ny = 16 / nx;
+      std::vector <int> count (16, 0);
+      for (const auto& s : p)
+      {
+        ++count[static_cast <int> (s[1] * ny) * nx
+                + static_cast <int> (s[0] * nx)];
+      }
+      for (const auto& c : count) { EXPECT_EQ (c, 1); }
+    }
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
@@ -0,0 +1,57 @@
+/*
+// ---------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "../src/core/thread_pool.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+class ThreadPoolTest : public ::testing::Test {};
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (ThreadPoolTest, ParallelForCoversEachItemOnce)
+{
+  std::vector <std::atomic <int>> counts (1000);
+  for (auto& c : counts) { c = 0; }
+  ParallelFor (1000, [&counts] (int begin, int end)
+  {
+    for (int i = begin; i < end; ++i) { ++counts[i]; }
+  });
+  for (const auto& c : counts) { EXPECT_EQ (c.load (), 1); }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (ThreadPoolTest, ParallelForInTasks)
+{
+  // More tasks than workers, each of which waits for its own chunks.
+  ThreadPool& pool = Singleton <ThreadPool>::Instance ();
+  const int num_tasks = 4 * std::max (1u, std::thread::hardware_concurrency ());
+  std::vector <std::future <int>> futures;
+  for (int t = 0; t < num_tasks; ++t)
+  {
+    futures.push_back (pool.Enqueue ([] ()
+    {
+      std::atomic <int> sum (0);
+      ParallelFor (100, [&sum] (int begin, int end)
+      {
+        for (int i = begin; i < end; ++i) { sum += i; }
+      });
+      return sum.load ();
+    }));
+  }
+  for (auto& f : futures) { EXPECT_EQ (f.get (), 4950); }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/
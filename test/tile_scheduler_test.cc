@@ -0,0 +1,139 @@
+/*
+// ---------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "../src/renderer/tile_scheduler.h"
+/*
+// ---------------------------------------------------------------------------
+*/
+namespace niepce
+{
+/*
+// ---------------------------------------------------------------------------
+*/
+class TileSchedulerTest : public ::testing::Test {};
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (TileSchedulerTest, HilbertCurve)
+{
+  // Consecutive points are neighbours.
+  uint32_t px, py;
+  HilbertIndexToPoint (8, 0, &px, &py);
+  for (uint32_t i = 1; i < 64; ++i)
+  {
+    uint32_t x, y;
+    HilbertIndexToPoint (8, i, &x, &y);
+    EXPECT_EQ (std::abs (static_cast <int> (x) - static_cast <int> (px))
+             + std::abs (static_cast <int> (y) - static_cast <int> (py)), 1);
+    px = x;
+    py = y;
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (TileSchedulerTest, EveryPixelOfEveryRound)
+{
+  // 3 x 2 tiles on 4 workers, so that tasks are split.
+  const int width = 100, height = 50, num_rounds = 3, num_workers = 4;
+  TileScheduler scheduler (width, height, 40, 32, num_rounds, num_workers);
+  ASSERT_EQ (scheduler.NumTiles (), 6);
+
+  std::vector <int> count (width * height, 0);
+  std::vector <int> round_of_tile (scheduler.NumTiles (), 0);
+  std::mutex mutex;
+  int num_rounds_finished = 0;
+
+  auto worker = [&] ()
+  {
+    TileTask task;
+    while (scheduler.Next (&task))
+    {
+      {
+        std::lock_guard <std::mutex> lock (mutex);
+        // The previous round of the tile is finished.
+        EXPECT_EQ (round_of_tile[task.tile], task.round - 1);
+        for (int y = task.begin_y; y < task.end_y; ++y)
+        {
+          for (int x = task.begin_x; x < task.end_x; ++x)
+          {
+            ++count[y * width + x];
+          }
+        }
+      }
+      bool round_finished = false;
+      if (!scheduler.Finish (task, &round_finished)) { continue; }
+      {
+        std::lock_guard <std::mutex> lock (mutex);
+        round_of_tile[task.tile] = task.round;
+        if (round_finished) { ++num_rounds_finished; }
+      }
+      scheduler.QueueNextRound (task);
+    }
+  };
+
+  std::vector <std::thread> threads;
+  for (int i = 0; i < num_workers; ++i) { threads.emplace_back (worker); }
+  for (auto& t : threads) { t.join (); }
+
+  for (const auto& c : count) { EXPECT_EQ (c, num_rounds); }
+  for (const auto& r : round_of_tile) { EXPECT_EQ (r, num_rounds); }
+  EXPECT_EQ (num_rounds_finished, num_rounds);
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (TileSchedulerTest, DepthFirst)
+{
+  // Every round of a tile runs before the next tile starts.
+  const int num_rounds = 3;
+  TileScheduler scheduler (64, 64, 32, 32, num_rounds, 1, true);
+
+  int previous_tile = -1;
+  int expected_round = 1;
+  TileTask task;
+  while (scheduler.Next (&task))
+  {
+    if (expected_round == 1)
+    {
+      EXPECT_NE (task.tile, previous_tile);
+    }
+    else
+    {
+      EXPECT_EQ (task.tile, previous_tile);
+    }
+    EXPECT_EQ (task.round, expected_round);
+    previous_tile  = task.tile;
+    expected_round = task.round % num_rounds + 1;
+
+    bool round_finished = false;
+    EXPECT_TRUE (scheduler.Finish (task, &round_finished));
+    scheduler.QueueNextRound (task);
+  }
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+TEST_F (TileSchedulerTest, Stop)
+{
+  // The running task finishes its round, but no task follows it.
+  TileScheduler scheduler (64, 64, 32, 32, 2, 1);
+
+  TileTask task;
+  ASSERT_TRUE (scheduler.Next (&task));
+  scheduler.Stop ();
+
+  bool round_finished = false;
+  EXPECT_TRUE (scheduler.Finish (task, &round_finished));
+  EXPECT_FALSE (round_finished);
+  scheduler.QueueNextRound (task);
+  EXPECT_FALSE (scheduler.Next (&task));
+}
+/*
+// ---------------------------------------------------------------------------
+*/
+}  // namespace niepce
+/*
+// ---------------------------------------------------------------------------
+*/